@@ -1,185 +1,13 @@
 #include <hgl/platform/CpuInfo.h>
 #include <hgl/platform/BigLittleDetector.h>
+#include "task/TaskExecutor.h"
 #include <iostream>
+#include <iomanip>
 #include <thread>
-#include <vector>
-#include <functional>
 
 using namespace hgl;
 using namespace std;
 
-/**
- * 简单的任务调度器示例
- * 演示如何基于大小核信息进行任务分配
- */
-class TaskScheduler
-{
-private:
-    CpuInfo cpu_info;
-    vector<thread> threads;
-    atomic<bool> running{true};
-
-    // 任务队列
-    vector<function<void()>> compute_tasks;
-    vector<function<void()>> background_tasks;
-
-    mutex task_mutex;
-
-public:
-    TaskScheduler()
-    {
-        if (!GetCpuInfo(&cpu_info)) {
-            throw runtime_error("Failed to get CPU information");
-        }
-    }
-
-    ~TaskScheduler()
-    {
-        Stop();
-    }
-
-    void Start()
-    {
-        BigLittleDetector::DetectionResult result = BigLittleDetector::Detect(cpu_info);
-
-        cout << "Starting task scheduler..." << endl;
-        cout << "Big.LITTLE detected: " << (result.has_big_little ? "Yes" : "No") << endl;
-
-        if (result.has_big_little) {
-            // 为大核创建计算线程
-            for (uint32 i = 0; i < result.big_cores; ++i) {
-                threads.emplace_back([this, i]() {
-                    ComputeWorker(i);
-                });
-            }
-
-            // 为小核创建后台线程
-            for (uint32 i = 0; i < result.little_cores; ++i) {
-                threads.emplace_back([this, i]() {
-                    BackgroundWorker(i);
-                });
-            }
-        } else {
-            // 统一架构，为所有核创建通用线程
-            for (uint32 i = 0; i < cpu_info.logical_core_count; ++i) {
-                threads.emplace_back([this, i]() {
-                    UnifiedWorker(i);
-                });
-            }
-        }
-
-        cout << "Created " << threads.size() << " worker threads" << endl;
-    }
-
-    void Stop()
-    {
-        running = false;
-
-        for (auto& t : threads) {
-            if (t.joinable()) {
-                t.join();
-            }
-        }
-
-        threads.clear();
-    }
-
-    void AddComputeTask(function<void()> task)
-    {
-        lock_guard<mutex> lock(task_mutex);
-        compute_tasks.push_back(move(task));
-    }
-
-    void AddBackgroundTask(function<void()> task)
-    {
-        lock_guard<mutex> lock(task_mutex);
-        background_tasks.push_back(move(task));
-    }
-
-private:
-    void ComputeWorker(int worker_id)
-    {
-        cout << "Compute worker " << worker_id << " started (Big core)" << endl;
-
-        while (running) {
-            function<void()> task;
-
-            {
-                lock_guard<mutex> lock(task_mutex);
-                if (!compute_tasks.empty()) {
-                    task = move(compute_tasks.back());
-                    compute_tasks.pop_back();
-                }
-            }
-
-            if (task) {
-                cout << "Compute worker " << worker_id << " executing task..." << endl;
-                task();
-            } else {
-                this_thread::sleep_for(chrono::milliseconds(10));
-            }
-        }
-
-        cout << "Compute worker " << worker_id << " stopped" << endl;
-    }
-
-    void BackgroundWorker(int worker_id)
-    {
-        cout << "Background worker " << worker_id << " started (Little core)" << endl;
-
-        while (running) {
-            function<void()> task;
-
-            {
-                lock_guard<mutex> lock(task_mutex);
-                if (!background_tasks.empty()) {
-                    task = move(background_tasks.back());
-                    background_tasks.pop_back();
-                }
-            }
-
-            if (task) {
-                cout << "Background worker " << worker_id << " executing task..." << endl;
-                task();
-            } else {
-                this_thread::sleep_for(chrono::milliseconds(50)); // 更长的休眠，节省功耗
-            }
-        }
-
-        cout << "Background worker " << worker_id << " stopped" << endl;
-    }
-
-    void UnifiedWorker(int worker_id)
-    {
-        cout << "Unified worker " << worker_id << " started" << endl;
-
-        while (running) {
-            function<void()> task;
-
-            // 统一架构下，交替处理计算和后台任务
-            {
-                lock_guard<mutex> lock(task_mutex);
-                if (!compute_tasks.empty()) {
-                    task = move(compute_tasks.back());
-                    compute_tasks.pop_back();
-                } else if (!background_tasks.empty()) {
-                    task = move(background_tasks.back());
-                    background_tasks.pop_back();
-                }
-            }
-
-            if (task) {
-                cout << "Unified worker " << worker_id << " executing task..." << endl;
-                task();
-            } else {
-                this_thread::sleep_for(chrono::milliseconds(20));
-            }
-        }
-
-        cout << "Unified worker " << worker_id << " stopped" << endl;
-    }
-};
-
 /**
  * 示例任务
  */
@@ -204,7 +32,7 @@ int main()
     try {
         cout << "=== Big.LITTLE Task Scheduler Demo ===" << endl;
 
-        TaskScheduler scheduler;
+        task::TaskExecutor scheduler;
 
         // 显示CPU信息
         CpuInfo ci;
@@ -230,9 +58,25 @@ int main()
             }
         }
 
-        // 启动调度器
+        // 启动调度器，每个线程保留最近65536个调度事件
+        scheduler.SetTraceCapacity(65536);
         scheduler.Start();
 
+        cout << "\nTask scheduler started" << endl;
+        if (scheduler.IsUnified())
+            cout << "Unified workers: " << scheduler.GetComputeWorkerCount() << endl;
+        else
+            cout << "Compute workers (Big core): " << scheduler.GetComputeWorkerCount()
+                 << ", Background workers (Little core): " << scheduler.GetBackgroundWorkerCount() << endl;
+
+        // 显示调度域，每个域一个运行队列，工作线程绑定到域内CPU
+        for (const task::CpuDomain &d : scheduler.GetTopology().GetDomains()) {
+            cout << "Domain L3#" << d.l3_domain << (d.is_big ? " (Big)" : " (Little)") << " CPUs:";
+            for (uint32 cpu : d.cpu_list)
+                cout << ' ' << cpu;
+            cout << endl;
+        }
+
         // 添加一些任务
         cout << "\nAdding tasks..." << endl;
 
@@ -245,6 +89,48 @@ int main()
         cout << "Running tasks for 5 seconds..." << endl;
         this_thread::sleep_for(chrono::seconds(5));
 
+        // 按任务类型自动选择大小核
+        cout << "\nAdaptive placement..." << endl;
+
+        task::TaskCostModel &cost_model = scheduler.GetCostModel();
+        cost_model.SetFrameBudget(1.0 / 30.0);
+
+        const task::TaskTypeID heavy_type = scheduler.RegisterTaskType("HeavyComputation", 0.1);
+        const task::TaskTypeID light_type = scheduler.RegisterTaskType("LightBackground");
+
+        uint32 on_big = 0;
+
+        for (int frame = 0; frame < 10; ++frame) {
+            if (scheduler.AddTask(heavy_type, HeavyComputationTask) == task::CoreClass::Big) ++on_big;
+            if (scheduler.AddTask(light_type, LightBackgroundTask) == task::CoreClass::Big) ++on_big;
+
+            this_thread::sleep_for(chrono::milliseconds(300));
+        }
+
+        cout << "Tasks placed on big cores: " << on_big << " / 20" << endl;
+
+        for (uint32 i = 0; i < cost_model.GetTypeCount(); ++i) {
+            const task::TaskCostModel::TypeStats *ts = cost_model.GetType(i);
+
+            cout << "  " << ts->name << ": big " << ts->samples[0] << " runs avg " << fixed << setprecision(3) << ts->avg[0] * 1000.0 << "ms"
+                 << ", little " << ts->samples[1] << " runs avg " << ts->avg[1] * 1000.0 << "ms"
+                 << (ts->migrated ? " (migrated to big)" : "") << endl;
+        }
+
+        // 调度统计
+        cout << "\nWorker statistics:" << endl;
+
+        for (const task::WorkerStats &ws : scheduler.GetWorkerStats()) {
+            cout << "  " << (ws.background ? "Background " : "Compute ") << ws.id << " (CPU " << ws.cpu_id << ")"
+                 << ": executed " << ws.executed
+                 << ", steal rate " << fixed << setprecision(1) << ws.steal_rate * 100.0 << "%"
+                 << ", idle " << ws.idle_percent << "%"
+                 << ", queue depth avg " << setprecision(2) << ws.avg_queue_depth << " max " << ws.max_queue_depth << endl;
+        }
+
+        if (scheduler.ExportChromeTrace("BigLittleTaskScheduler.trace.json"))
+            cout << "Trace written to BigLittleTaskScheduler.trace.json (open with chrome://tracing or Perfetto)" << endl;
+
         cout << "Stopping scheduler..." << endl;
         scheduler.Stop();
 
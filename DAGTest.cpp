@@ -0,0 +1,210 @@
+#include"task/TaskGraph.h"
+#include<hgl/2d/Bitmap.h>
+#include<hgl/2d/BitmapSave.h>
+#include<hgl/2d/DrawGeometry.h>
+#include<iostream>
+#include"BitmapFont.h"
+
+using namespace hgl;
+using namespace hgl::bitmap;
+
+constexpr const uint FRAME_COUNT    =4;         //模拟帧数
+constexpr const uint STATS_SPLIT    =6;         //stats阶段拆分的任务数
+constexpr const uint RENDER_SPLIT   =4;         //render阶段拆分的任务数
+
+constexpr const uint CHART_WIDTH    =1600;
+constexpr const uint ROW_HEIGHT     =24;
+constexpr const uint LEFT_MARGIN    =96;
+constexpr const uint TOP_MARGIN     =40;
+
+constexpr const uint CHAR_WIDTH     =8;
+constexpr const uint CHAR_HEIGHT    =16;
+
+/**
+ * 模拟一个阶段的计算量
+ */
+void Work(const uint us)
+{
+    const double end=GetPreciseTime()+double(us)/1000000.0;
+
+    volatile uint32 sum=0;
+
+    while(GetPreciseTime()<end)
+        for(uint32 i=0;i<1000;i++)
+            sum+=i*i;
+}
+
+/**
+ * 按帧构建 parse -> stats[N] -> render[N] -> encode 的任务图，每帧的parse依赖上一帧的parse，
+ * 另外每帧带一个在后台组执行的log任务
+ */
+void BuildFrameGraph(task::TaskGraph &graph)
+{
+    task::TaskHandle last_parse=task::TASK_HANDLE_INVALID;
+
+    for(uint f=0;f<FRAME_COUNT;f++)
+    {
+        const task::TaskHandle parse=graph.Add("parse",[](){Work(2000);});
+
+        if(last_parse!=task::TASK_HANDLE_INVALID)
+            graph.Precede(last_parse,parse);
+
+        last_parse=parse;
+
+        const task::TaskHandle encode=graph.Add("encode",[](){Work(1500);});
+
+        task::TaskHandle stats[STATS_SPLIT];
+
+        for(uint i=0;i<STATS_SPLIT;i++)
+            stats[i]=graph.Then(parse,"stats",[i](){Work(600+i*100);});
+
+        for(uint i=0;i<RENDER_SPLIT;i++)
+        {
+            const task::TaskHandle render=graph.Add("render",[](){Work(1200);});
+
+            for(uint j=0;j<STATS_SPLIT;j++)
+                graph.Precede(stats[j],render);
+
+            graph.Precede(render,encode);
+        }
+
+        graph.Then(encode,"log",[](){Work(800);},true);
+    }
+}
+
+Vector3u8 GetStageColor(const std::string &name)
+{
+    if(name=="parse" )return Vector3u8(  0,160,255);
+    if(name=="stats" )return Vector3u8(  0,220,120);
+    if(name=="render")return Vector3u8(255,180,  0);
+    if(name=="encode")return Vector3u8(230, 60, 60);
+
+    return Vector3u8(160,160,160);
+}
+
+void DrawString(DrawGeometryRGB8 &draw,uint x,uint y,const AnsiString &str,const Vector3u8 &color)
+{
+    draw.CloseBlend();
+    draw.SetDrawColor(color);
+
+    const char *sp=str.c_str();
+
+    for(uint i=0;i<str.Length();i++)
+    {
+        if(*sp!=' ')
+            draw.DrawMonoBitmap(x,y,Get8x16Char(*sp),CHAR_WIDTH,CHAR_HEIGHT);
+
+        x+=CHAR_WIDTH;
+        ++sp;
+    }
+}
+
+/**
+ * 把每个节点的执行区间按工作线程画成时间线
+ */
+void DrawTimeline(const task::TaskGraph &graph,const uint worker_count,const uint compute_count)
+{
+    double end_time=graph.GetRunStartTime();
+
+    for(uint i=0;i<graph.GetCount();i++)
+        if(graph.GetNode(i)->end_time>end_time)
+            end_time=graph.GetNode(i)->end_time;
+
+    const double total=end_time-graph.GetRunStartTime();
+    const double scale=double(CHART_WIDTH-LEFT_MARGIN-8)/total;
+
+    BitmapRGB8 bmp;
+
+    bmp.Create(CHART_WIDTH,TOP_MARGIN+worker_count*ROW_HEIGHT+8);
+    bmp.ClearColor(Vector3u8(24,24,24));
+
+    DrawGeometryRGB8 draw(&bmp);
+
+    DrawString(draw,8,8,AnsiString("Task graph timeline, total ")+AnsiString::floatOf(total*1000.0,2)+AnsiString(" ms"),Vector3u8(255,255,255));
+
+    for(uint w=0;w<worker_count;w++)
+        DrawString(draw,8,TOP_MARGIN+w*ROW_HEIGHT+4,
+                   AnsiString(w<compute_count?"C":"B")+AnsiString::numberOf(w),
+                   Vector3u8(200,200,200));
+
+    for(uint i=0;i<graph.GetCount();i++)
+    {
+        const task::TaskNode *node=graph.GetNode(i);
+
+        if(node->worker_id<0||uint(node->worker_id)>=worker_count)
+            continue;
+
+        const uint left =LEFT_MARGIN+uint((node->start_time-graph.GetRunStartTime())*scale);
+        const uint right=LEFT_MARGIN+uint((node->end_time  -graph.GetRunStartTime())*scale);
+        const uint top  =TOP_MARGIN+node->worker_id*ROW_HEIGHT+2;
+        const uint width=(right>left+1)?right-left-1:1;
+
+        draw.SetDrawColor(GetStageColor(node->name));
+
+        for(uint y=0;y<ROW_HEIGHT-4;y++)
+            draw.DrawHLine(left,top+y,width);
+
+        if(width>CHAR_WIDTH+2)
+            DrawString(draw,left+2,top+2,AnsiString(node->name.c_str(),1),Vector3u8(0,0,0));
+    }
+
+    if(!SaveBitmapToTGA(OS_TEXT("DAGTest.tga"),&bmp))
+        std::cerr<<"save DAGTest.tga failed!"<<std::endl;
+    else
+        std::cout<<"output: DAGTest.tga"<<std::endl;
+}
+
+int main(int,char **)
+{
+    if(!LoadBitmapFont())
+    {
+        std::cerr<<"can't load font file VGA8.F16 !"<<std::endl;
+        return 1;
+    }
+
+    task::TaskExecutor executor;
+
+    executor.Start();
+
+    const uint compute_count=executor.GetComputeWorkerCount();
+    const uint worker_count=compute_count+executor.GetBackgroundWorkerCount();
+
+    std::cout<<"Workers: "<<compute_count<<" compute, "<<executor.GetBackgroundWorkerCount()<<" background"<<std::endl;
+
+    task::TaskGraph graph(&executor);
+
+    BuildFrameGraph(graph);
+
+    std::cout<<"Graph nodes: "<<graph.GetCount()<<std::endl;
+
+    if(!graph.Run())
+    {
+        std::cerr<<"run task graph failed!"<<std::endl;
+        return 2;
+    }
+
+    graph.Wait();
+
+    uint same_worker=0,edges=0;
+
+    for(uint i=0;i<graph.GetCount();i++)
+    {
+        const task::TaskNode *node=graph.GetNode(i);
+
+        for(const task::TaskNode *succ:node->successors)
+        {
+            ++edges;
+
+            if(succ->worker_id==node->worker_id)
+                ++same_worker;
+        }
+    }
+
+    std::cout<<"Successors run on the same worker: "<<same_worker<<" / "<<edges<<std::endl;
+
+    DrawTimeline(graph,worker_count,compute_count);
+
+    executor.Stop();
+    ClearBitmapFont();
+    return 0;
+}
@@ -1,8 +1,6 @@
 ﻿#include<hgl/type/StringList.h>
-#include<hgl/io/LoadStringList.h>
 #include<hgl/type/Gradient.h>
 #include<hgl/math/Vector.h>
-#include<hgl/io/FileInputStream.h>
 #include<hgl/io/FileOutputStream.h>
 #include<hgl/filesystem/Filename.h>
 #include<iostream>
@@ -10,12 +8,20 @@
 #include<hgl/2d/BitmapSave.h>
 #include<hgl/2d/DrawGeometry.h>
 #include"BitmapFont.h"
+#include"ParallelCSVParse.h"
+#include<hgl/time/Time.h>
+#include"task/ParallelFor.h"
+#include<algorithm>
+#include<array>
+#include<vector>
 
 using namespace hgl;
 using namespace hgl::bitmap;
 
 OSString csv_filename;
 
+task::TaskExecutor *executor=nullptr;
+
 uint POSITION_SCALE_RATE=100;               //坐标缩小比例，UNREAL中单位为厘米，换算到米需要/100。
                                             //原地图4K，现底层为1K，所以需要再/4。
                                             //2K地图用的底层为2K，所以只/100
@@ -84,34 +90,32 @@ enum class DataSourceType
     TwoPosition,
 };
 
-DataSourceType CheckDataSourceType(const U8String &str)
+DataSourceType CheckDataSourceType(const char *sp,const char *end)
 {
-    if(str.Length()<=11)return(DataSourceType::Error);
-
-    const char *sp=str.c_str();
+    if(end-sp<=11)return(DataSourceType::Error);
 
     if(*sp=='X')
         return DataSourceType::OnePosition;
 
-    if(hgl::strchr(sp,',',str.Length())!=nullptr)
+    if(hgl::strchr(sp,',',end-sp)!=nullptr)
         return DataSourceType::TwoPosition;
 
     return(DataSourceType::Error);
 }
 
-bool ParsePosition(Vector2i *result,const U8String &str)
+//行数据直接在读取缓冲区中，不以'\0'结尾，查找字符都须限定在[sp,end)之内
+bool ParsePosition(Vector2i *result,const char *sp,const char *end)
 {
     if(!result)return(false);
 
-    if(str.Length()<=0)return(false);
+    if(end-sp<=2)return(false);
 
-    const char *sp=str.c_str();
     const char *cp;
 
     if(*sp!='X')return(false);
 
     sp+=2;
-    cp=hgl::strchr(sp,'Y');
+    cp=hgl::strchr(sp,'Y',end-sp);
 
     if(!cp)return(false);
 
@@ -120,7 +124,9 @@ bool ParsePosition(Vector2i *result,const U8String &str)
 
     sp=cp+2;
 
-    cp=hgl::strchr(sp,'Z');
+    if(sp>=end)return(false);
+
+    cp=hgl::strchr(sp,'Z',end-sp);
 
     if(!cp)return(false);
 
@@ -149,35 +155,31 @@ struct LineSegment
 
 using LineSegmentData=ArrayList<LineSegment>;
 
-bool ParseLineSegment(LineSegment *result,const U8String &str)
+bool ParseLineSegment(LineSegment *result,const char *sp,const char *end)
 {
     if(!result)return(false);
 
-    if(str.Length()<=0)return(false);
-
-    const char *start=str.c_str();
-    const char *end=start+str.Length();
-    const char *sp=start;
+    if(sp>=end)return(false);
 
     if(!hgl::stoi(sp,result->start.x))
         return(false);
 
-    sp=hgl::strchr(sp,' ');
-    if(!sp)return(false);
+    sp=hgl::strchr(sp,' ',end-sp);
+    if(!sp||++sp>=end)return(false);
 
-    if(!hgl::stoi(++sp,result->start.y))
+    if(!hgl::stoi(sp,result->start.y))
         return(false);
 
-    sp=hgl::strchr(sp,',');
-    if(!sp)return(false);
+    sp=hgl::strchr(sp,',',end-sp);
+    if(!sp||++sp>=end)return(false);
 
-    if(!hgl::stoi(++sp,result->end.x))
+    if(!hgl::stoi(sp,result->end.x))
         return(false);
 
-    sp=hgl::strchr(sp,' ');
-    if(!sp)return(false);
+    sp=hgl::strchr(sp,' ',end-sp);
+    if(!sp||++sp>=end)return(false);
 
-    if(!hgl::stoi(++sp,result->end.y))
+    if(!hgl::stoi(sp,result->end.y))
         return(false);
 
     result->start.x/=400;
@@ -188,33 +190,51 @@ bool ParseLineSegment(LineSegment *result,const U8String &str)
     return(true);
 }
 
+/**
+ * 从当前块开始，逐块读取并解析直到文件结束
+ * 数据从读取缓冲区中直接解析到data_list，每行不再分配字符串，内存占用不随文件大小增长（data_list本身除外）
+ * 每块按行分段并行解析到各段自己的列表，块结束后按段号顺序追加到data_list，顺序与文件相同
+ * @return 文件总行数
+ */
 template<typename T>
-void ParseStringList(ArrayList<T> &data_list,const U8StringList &sl,bool (*ParseLineFunc)(T *,const U8String &))
+uint64 ParseLineBlocks(ArrayList<T> &data_list,LineBlockReader &reader,const char *begin,const char *end,bool (*ParseLineFunc)(T *,const char *,const char *))
 {
-    const uint count=sl.GetCount();
+    const uint chunk_count=executor->GetComputeWorkerCount()+1;
 
-    data_list.SetCount(count);
+    std::vector<ArrayList<T>> chunk_list(chunk_count);
+    std::vector<uint64> line_count(chunk_count,0);
 
-    T *p=data_list.GetData();
+    ParallelForEachRecordBlock(*executor,reader,begin,end,0,chunk_count,
+        [&](const uint index,const char *sp,const char *ep)
+        {
+            ArrayList<T> &chunk=chunk_list[index];
+            T value;
 
-    U8String str;
-    uint result=0;
+            line_count[index]+=ForEachLine(sp,ep,[&](const char *ls,const char *le)
+            {
+                if(ParseLineFunc(&value,ls,le))
+                    chunk.Add(value);
+            });
+        },
+        [&]()
+        {
+            for(ArrayList<T> &chunk:chunk_list)
+            {
+                const int old_count=data_list.GetCount();
 
-    for(uint i=0;i<count;i++)
-    {
-        str=sl[i];
+                data_list.SetCount(old_count+chunk.GetCount());
+                memcpy(data_list.GetData()+old_count,chunk.GetData(),chunk.GetCount()*sizeof(T));
 
-        if(str.Length()<=0)
-            continue;
+                chunk.SetCount(0);
+            }
+        });
 
-        if(!ParseLineFunc(p,str))
-            continue;
-      
-        ++result;
-        ++p;
-    }
+    uint64 total=0;
+
+    for(const uint64 lc:line_count)
+        total+=lc;
 
-    data_list.SetCount(result);
+    return total;
 }
 
 struct Chart
@@ -399,42 +419,129 @@ void StatStopCount(const BitmapU32 &count_bitmap)
 {
     //统计占比
     {
-        const uint32 *cp32=count_bitmap.GetData();
+        using StopCount=std::array<uint,STOP_COUNT>;
 
-        mem_zero(stop_count);
+        const uint32 *data=count_bitmap.GetData();
 
-        for(uint i=0;i<count_bitmap.GetTotalPixels();i++)
-        {
-            if(*cp32>0)
-            for(uint i=0;i<STOP_COUNT;i++)
-                if(*cp32>top_count*(STOP_COUNT-1-i)/STOP_COUNT)
+        StopCount zero;
+
+        zero.fill(0);
+
+        const StopCount result=task::ParallelReduce(*executor,task::IndexRange(0,count_bitmap.GetTotalPixels()),0,zero,
+            [data](const task::IndexRange &r,StopCount sc)
+            {
+                const uint32 *cp32=data+r.begin;
+
+                for(size_t i=r.begin;i<r.end;i++)
                 {
-                    stop_count[i]+=*cp32;
-                    break;
+                    if(*cp32>0)
+                    for(uint i=0;i<STOP_COUNT;i++)
+                        if(*cp32>top_count*(STOP_COUNT-1-i)/STOP_COUNT)
+                        {
+                            sc[i]+=*cp32;
+                            break;
+                        }
+
+                    ++cp32;
                 }
 
-            ++cp32;
-        }
+                return sc;
+            },
+            [](const StopCount &a,const StopCount &b)
+            {
+                StopCount sc;
+
+                for(uint i=0;i<STOP_COUNT;i++)
+                    sc[i]=a[i]+b[i];
+
+                return sc;
+            });
+
+        for(uint i=0;i<STOP_COUNT;i++)
+            stop_count[i]=result[i];
     }
 }
 
 void CountToCircle(Chart *chart)
 {
-    const uint32 *cp32=chart->count_bitmap.GetData();
-
     const uint width=chart->width;
     const uint height=chart->height;
 
-    for(uint y=0;y<height;y++)
+    //圆会跨行，所以按行分带，每带只画圆心在本带内的圆，画到只比本带上下各多出最大半径的条带位图上，
+    //最后按输出行合并，每一行只由一个任务写入，避免多个线程同时写同一像素
+    const uint radius=top_count;
+
+    //条带位图总行数不超过图高的两倍
+    const uint band_count=std::max<uint>(1,std::min<uint>(executor->GetComputeWorkerCount()+1,1+height/(2*radius+1)));
+
+    std::vector<BitmapU32> band_bitmap(band_count);
+    std::vector<uint> band_top(band_count);
+
+    task::ParallelFor(*executor,task::IndexRange(0,band_count),1,[&](const task::IndexRange &r)
     {
-        for(uint x=0;x<width;x++)
+        for(size_t band=r.begin;band<r.end;band++)
         {
-            if(*cp32>0)
-                chart->DrawCircle(x,y,(*cp32));
+            const uint start_y=height*band/band_count;
+            const uint end_y=height*(band+1)/band_count;
 
-            ++cp32;
+            const uint top=start_y>radius?start_y-radius:0;
+            const uint bottom=std::min(end_y+radius,height);
+
+            BitmapU32 &bmp=band_bitmap[band];
+
+            band_top[band]=top;
+
+            if(start_y>=end_y)continue;
+
+            bmp.Create(width,bottom-top);
+            bmp.ClearColor(0);
+
+            BlendColorU32Additive blend_u32_additive;
+            DrawGeometryU32 draw_circle(&bmp);
+
+            draw_circle.SetBlend(&blend_u32_additive);
+            draw_circle.SetDrawColor(1);
+
+            const uint32 *cp32=chart->count_bitmap.GetData()+start_y*width;
+
+            for(uint y=start_y;y<end_y;y++)
+            {
+                for(uint x=0;x<width;x++)
+                {
+                    if(*cp32>0)
+                        draw_circle.DrawSolidCircle(x,y-top,(*cp32));
+
+                    ++cp32;
+                }
+            }
         }
-    }
+    });
+
+    uint32 *circle_data=chart->circle_bitmap.GetData();
+
+    task::ParallelFor(*executor,task::IndexRange(0,height),0,[&](const task::IndexRange &r)
+    {
+        for(uint band=0;band<band_count;band++)
+        {
+            const BitmapU32 &bmp=band_bitmap[band];
+
+            if(!bmp.GetData())continue;
+
+            const uint top=band_top[band];
+            const uint bottom=top+bmp.GetHeight();
+
+            const uint start_y=std::max<uint>(top,r.begin);
+            const uint end_y=std::min<uint>(bottom,r.end);
+
+            if(start_y>=end_y)continue;
+
+            const uint32 *sp=bmp.GetData()+(start_y-top)*width;
+            uint32 *tp=circle_data+start_y*width;
+
+            for(size_t i=0;i<size_t(end_y-start_y)*width;i++)
+                tp[i]+=sp[i];
+        }
+    });
 }
 
 void ChartStat(Chart *chart,const uint data_count)
@@ -444,14 +551,17 @@ void ChartStat(Chart *chart,const uint data_count)
 
     //统计最大值
     {
-        uint32 *cp32=chart->circle_bitmap.GetData();
+        const uint32 *data=chart->circle_bitmap.GetData();
 
-        for(uint i=0;i<width*height;i++)
-        {
-            if(*cp32>chart->max_count)chart->max_count=*cp32;
+        chart->max_count=task::ParallelReduce(*executor,task::IndexRange(0,width*height),0,chart->max_count,
+            [data](const task::IndexRange &r,uint max_count)
+            {
+                for(size_t i=r.begin;i<r.end;i++)
+                    if(data[i]>max_count)max_count=data[i];
 
-            ++cp32;
-        }
+                return max_count;
+            },
+            [](uint a,uint b){return a>b?a:b;});
 
         std::cout<<"max_count: "<<chart->max_count<<std::endl;
     }
@@ -459,14 +569,15 @@ void ChartStat(Chart *chart,const uint data_count)
     InitGradient(chart->max_count);
 
     //生成权重图
+    task::ParallelFor(*executor,task::IndexRange(0,width*height),0,[chart](const task::IndexRange &r)
     {
-        uint32 *cp32=chart->circle_bitmap.GetData();
-        Vector4u8 *cp8=chart->chart_bitmap.GetData();
+        const uint32 *cp32=chart->circle_bitmap.GetData()+r.begin;
+        Vector4u8 *cp8=chart->chart_bitmap.GetData()+r.begin;
 
         float alpha;
         Vector3u8 final_color;
 
-        for(uint i=0;i<width*height;i++)
+        for(size_t i=r.begin;i<r.end;i++)
         {
             alpha=float(*cp32)/float(chart->max_count);
 
@@ -488,7 +599,7 @@ void ChartStat(Chart *chart,const uint data_count)
             ++cp32;
             ++cp8;
         }
-    }
+    });
 
     if(CHAR_BITMAP_HEIGHT==0)
         return;
@@ -596,13 +707,13 @@ int os_main(int argc,os_char **argv)
         return 2;
     }
 
-    U8StringList sl;
+    LineBlockReader reader;
+    const char *block_begin,*block_end;
 
     csv_filename=argv[1];
 
-    int line_count=LoadStringListFromTextFile(sl,csv_filename);
-    
-    if(line_count<=1)
+    if(!reader.Open(csv_filename)
+     ||!reader.NextBlock(block_begin,block_end))
     {
         os_out<<OS_TEXT("Load file ")<<csv_filename.c_str()<<OS_TEXT(" failed!")<<std::endl;
         return(3);
@@ -610,9 +721,16 @@ int os_main(int argc,os_char **argv)
 
     os_out<<OS_TEXT("Load file ")<<csv_filename.c_str()<<OS_TEXT(" OK!")<<std::endl;
 
-    std::cout<<"file total line: "<<line_count<<std::endl;
+    //用第一行判断数据类型，第一块随后照常解析
+    const char *first_line_end=(const char *)memchr(block_begin,'\n',block_end-block_begin);
+
+    if(!first_line_end)
+        first_line_end=block_end;
+    else
+    if(first_line_end>block_begin&&first_line_end[-1]=='\r')
+        --first_line_end;
 
-    const DataSourceType dst=CheckDataSourceType(sl[0]);
+    const DataSourceType dst=CheckDataSourceType(block_begin,first_line_end);
 
     if(dst==DataSourceType::Error)
     {
@@ -620,8 +738,17 @@ int os_main(int argc,os_char **argv)
         return(4);
     }
 
+    task::TaskExecutor te;
+
+    te.Start();
+    executor=&te;
+
+    std::cout<<"ParallelFor workers: "<<te.GetComputeWorkerCount()<<std::endl;
+
     AutoDelete<Chart> chart=CreateChart();
     uint data_count;
+    uint64 line_count;
+    double parse_time=GetPreciseTime();
 
     if(dst==DataSourceType::OnePosition)
     {
@@ -629,7 +756,8 @@ int os_main(int argc,os_char **argv)
 
         OnePositionData opd;
 
-        ParseStringList<Vector2i>(opd,sl,ParsePosition);
+        line_count=ParseLineBlocks<Vector2i>(opd,reader,block_begin,block_end,ParsePosition);
+        parse_time=GetPreciseTime()-parse_time;
 
         StatStopCount(chart->count_bitmap);
 
@@ -645,7 +773,8 @@ int os_main(int argc,os_char **argv)
 
         LineSegmentData lsd;
 
-        ParseStringList<LineSegment>(lsd,sl,ParseLineSegment);
+        line_count=ParseLineBlocks<LineSegment>(lsd,reader,block_begin,block_end,ParseLineSegment);
+        parse_time=GetPreciseTime()-parse_time;
 
         StatStopCount(chart->circle_bitmap);
 
@@ -654,7 +783,16 @@ int os_main(int argc,os_char **argv)
         data_count=lsd.GetCount();        
     }
 
-    ChartStat(chart,data_count);
+    std::cout<<"file total line: "<<line_count<<", valid: "<<data_count<<std::endl;
+    std::cout<<"Parse time: "<<parse_time<<" sec."<<std::endl;
+
+    {
+        const double st=GetPreciseTime();
+
+        ChartStat(chart,data_count);
+
+        std::cout<<"ChartStat time: "<<GetPreciseTime()-st<<" sec."<<std::endl;
+    }
 
     {
         const OSString tga_filename=filesystem::ReplaceExtName(csv_filename,OSString(OS_TEXT(".tga")));
@@ -0,0 +1,188 @@
+#pragma once
+#include<hgl/io/FileInputStream.h>
+#include<cstring>
+#include<vector>
+
+using namespace hgl;
+
+/**
+ * 按块读取文本文件，每次返回的块只包含完整的行
+ *
+ * 用一个固定大小的缓冲区反复读取文件，块末不完整的行移到缓冲区开头，与下一次读取的数据拼接。
+ * 所以内存占用只与块大小（或文件中最长的一行）有关，与文件大小无关。
+ * 返回的指针直接指向缓冲区，不为每行分配字符串，在下一次调用NextBlock之前有效。
+ * 有效数据之后总有一个'\0'，最后一行没有换行符时，解析函数也不会读到无关数据。
+ */
+class LineBlockReader
+{
+    io::FileInputStream fis;
+
+    std::vector<char> buffer;           //比容量多一个字节，放'\0'
+    size_t data_size=0;                 //缓冲区中有效数据长度
+    size_t line_start=0;                //尚未返回的数据（不完整的行）的起始位置
+    bool eof=true;
+    bool at_file_start=true;            //还没有返回过任何数据，缓冲区开头就是文件开头
+    bool put_back=false;                //上一块有数据被退回，须先读入更多数据
+
+    size_t GetCapacity()const{return buffer.size()-1;}
+
+    bool ReadMore()
+    {
+        //把上一块剩下的不完整行移到开头
+        if(line_start>0)
+        {
+            data_size-=line_start;
+            memmove(buffer.data(),buffer.data()+line_start,data_size);
+            buffer[data_size]=0;
+            line_start=0;
+        }
+
+        //一行比整个缓冲区还长，只有这时才扩大缓冲区
+        if(data_size==GetCapacity())
+            buffer.resize(GetCapacity()*2+1);
+
+        const int64 read_size=fis.Read(buffer.data()+data_size,GetCapacity()-data_size);
+
+        if(read_size<=0)
+        {
+            eof=true;
+            fis.Close();
+            return(false);
+        }
+
+        data_size+=read_size;
+        buffer[data_size]=0;
+
+        if(at_file_start&&data_size>=3)
+        {
+            at_file_start=false;
+
+            if(memcmp(buffer.data(),"\xEF\xBB\xBF",3)==0)        //跳过UTF8 BOM
+                line_start=3;
+        }
+
+        return(true);
+    }
+
+    bool TakeRest(const char *&begin,const char *&end)
+    {
+        if(line_start>=data_size)
+            return(false);
+
+        begin=buffer.data()+line_start;
+        end=buffer.data()+data_size;
+        line_start=data_size;
+        return(true);
+    }
+
+public:
+
+    static constexpr const size_t DEFAULT_BLOCK_SIZE=16*1024*1024;
+
+    ~LineBlockReader()
+    {
+        if(!eof)
+            fis.Close();
+    }
+
+    bool Open(const OSString &filename,const size_t block_size=DEFAULT_BLOCK_SIZE)
+    {
+        if(!eof)
+            fis.Close();
+
+        if(!fis.Open(filename))
+            return(false);
+
+        buffer.resize((block_size>0?block_size:DEFAULT_BLOCK_SIZE)+1);
+        buffer[0]=0;
+        data_size=0;
+        line_start=0;
+        eof=false;
+        at_file_start=true;
+        put_back=false;
+
+        return(true);
+    }
+
+    /**
+     * 取得下一块完整的行，范围为[begin,end)，文件结束返回false
+     */
+    bool NextBlock(const char *&begin,const char *&end)
+    {
+        if(put_back)
+        {
+            put_back=false;
+
+            if(eof||!ReadMore())            //没有更多数据了，剩下的全部作为最后一块
+                return TakeRest(begin,end);
+        }
+
+        for(;;)
+        {
+            const char *start=buffer.data()+line_start;
+            const char *last=buffer.data()+data_size;
+
+            //找最后一个换行符，之后的不完整行留到下一块
+            const char *lf=last;
+
+            while(lf>start&&lf[-1]!='\n')
+                --lf;
+
+            if(lf>start)
+            {
+                at_file_start=false;
+                begin=start;
+                end=lf;
+                line_start=lf-buffer.data();
+                return(true);
+            }
+
+            if(!eof&&ReadMore())
+                continue;
+
+            //文件结束，最后一行没有换行符（ReadMore可能已移动过数据，不能再用start/last）
+            return TakeRest(begin,end);
+        }
+    }
+
+    /**
+     * 把上一块中从pos开始的数据退回，下一次NextBlock先读入更多数据，再与之拼接
+     * 用于块末的记录还不完整的情况，如CSV引号内的换行
+     */
+    void PutBack(const char *pos)
+    {
+        line_start=pos-buffer.data();
+        put_back=true;
+    }
+
+    /**
+     * 文件已全部读入缓冲区。为false时也可能已没有数据，下一次读取才能确定
+     */
+    bool IsEOF()const{return eof;}
+};//class LineBlockReader
+
+/**
+ * 逐行遍历[begin,end)，行尾的"\r\n"或"\n"不含在行内，空行也会调用
+ * @return 行数
+ */
+template<typename F>
+uint ForEachLine(const char *begin,const char *end,F &&func)
+{
+    uint line_count=0;
+
+    while(begin<end)
+    {
+        const char *lf=(const char *)memchr(begin,'\n',end-begin);
+        const char *line_end=lf?lf:end;
+
+        if(line_end>begin&&line_end[-1]=='\r')
+            func(begin,line_end-1);
+        else
+            func(begin,line_end);
+
+        ++line_count;
+        begin=lf?lf+1:end;
+    }
+
+    return line_count;
+}
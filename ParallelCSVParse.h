@@ -0,0 +1,199 @@
+#pragma once
+#include"LineBlockReader.h"
+#include"task/ParallelFor.h"
+#include<hgl/util/csv/CSVParse.h>
+#include<algorithm>
+#include<vector>
+
+/**
+ * 逐条遍历[begin,end)中的记录，记录以引号外的换行符分隔，记录尾的"\r"不含在内，空记录也会调用
+ * begin必须是一条记录的开始；quote_char为0时不处理引号，与ForEachLine相同
+ * @return 记录数
+ */
+template<typename F>
+uint ForEachRecord(const char *begin,const char *end,const char quote_char,F &&func)
+{
+    if(!quote_char||!memchr(begin,quote_char,end-begin))
+        return ForEachLine(begin,end,func);
+
+    uint record_count=0;
+    const char *record=begin;
+    bool in_quote=false;
+
+    for(const char *p=begin;p<end;++p)
+    {
+        if(*p==quote_char)
+            in_quote=!in_quote;
+        else
+        if(*p=='\n'&&!in_quote)
+        {
+            func(record,(p>record&&p[-1]=='\r')?p-1:p);
+
+            ++record_count;
+            record=p+1;
+        }
+    }
+
+    if(record<end)
+    {
+        func(record,end);
+        ++record_count;
+    }
+
+    return record_count;
+}
+
+/**
+ * 从p开始找下一条记录的起点（引号外的换行符之后），in_quote为p处是否在引号内，找不到返回end
+ */
+inline const char *FindRecordStart(const char *p,const char *end,const char quote_char,bool in_quote)
+{
+    if(!quote_char)
+    {
+        const char *lf=(const char *)memchr(p,'\n',end-p);
+
+        return lf?lf+1:end;
+    }
+
+    for(;p<end;++p)
+    {
+        if(*p==quote_char)
+            in_quote=!in_quote;
+        else
+        if(*p=='\n'&&!in_quote)
+            return p+1;
+    }
+
+    return end;
+}
+
+/**
+ * 从end向前找最后一条完整记录的结尾（引号外的换行符之后），end处在引号内，找不到返回begin
+ */
+inline const char *FindLastRecordEnd(const char *begin,const char *end,const char quote_char)
+{
+    bool in_quote=true;
+
+    for(const char *p=end;p>begin;--p)
+    {
+        if(p[-1]=='\n'&&!in_quote)
+            return p;
+
+        if(p[-1]==quote_char)
+            in_quote=!in_quote;
+    }
+
+    return begin;
+}
+
+/**
+ * 从当前块开始，逐块并行处理文件中的记录，直到文件结束
+ *
+ * 每块按字节数平均分成chunk_count段，每段的起点后移到下一条记录的起点，各段并行交给chunk_func(段号,begin,end)处理。
+ * 全部段完成后调用block_done()，可在其中按段号顺序合并各段的结果，合并后的顺序即文件中的顺序。
+ *
+ * 判断记录起点要知道该处是否在引号内：先并行统计每段的引号数，前缀和的奇偶就是各段起点的引号状态，
+ * 再从各段起点向后找引号外的换行符，通常只需扫描一条记录。
+ * 块末若在引号内（引号内的换行被块截断），最后一条不完整的记录退回reader，与下一块拼接。
+ */
+template<typename C,typename D>
+void ParallelForEachRecordBlock(task::TaskExecutor &te,LineBlockReader &reader,const char *begin,const char *end,
+                                const char quote_char,const uint chunk_count,C &&chunk_func,D &&block_done)
+{
+    std::vector<const char *> cut(chunk_count+1);
+    std::vector<uint> quote_count(chunk_count,0);
+
+    do
+    {
+        const size_t size=end-begin;
+
+        if(quote_char)
+            task::ParallelFor(te,task::IndexRange(0,chunk_count),1,[&](const task::IndexRange &r)
+            {
+                for(size_t i=r.begin;i<r.end;i++)
+                    quote_count[i]=std::count(begin+size*i/chunk_count,begin+size*(i+1)/chunk_count,quote_char);
+            });
+
+        bool in_quote=false;
+
+        cut[0]=begin;
+
+        for(uint i=1;i<chunk_count;i++)
+        {
+            in_quote^=(quote_count[i-1]&1);
+
+            cut[i]=FindRecordStart(begin+size*i/chunk_count,end,quote_char,in_quote);
+        }
+
+        in_quote^=(quote_count[chunk_count-1]&1);
+
+        if(in_quote&&!reader.IsEOF())
+        {
+            const char *block_end=FindLastRecordEnd(begin,end,quote_char);
+
+            for(uint i=1;i<chunk_count;i++)
+                cut[i]=std::min(cut[i],block_end);
+
+            reader.PutBack(block_end);
+            end=block_end;
+        }
+
+        cut[chunk_count]=end;
+
+        task::ParallelFor(te,task::IndexRange(0,chunk_count),1,[&](const task::IndexRange &r)
+        {
+            for(size_t i=r.begin;i<r.end;i++)
+                if(cut[i]<cut[i+1])
+                    chunk_func(uint(i),cut[i],cut[i+1]);
+        });
+
+        block_done();
+    }
+    while(reader.NextBlock(begin,end));
+}
+
+/**
+ * 多线程解析CSV文件，util::ParseCSVFile的并行版本
+ *
+ * P为CSVParseCallback<char>的派生类，须可默认构造。每段一个P的实例，各自只处理一段连续的记录，OnLine中不需要加锁。
+ * 每块解析完后按文件顺序对每个实例调用merge(P &)，由调用者把实例中的结果移入最终结果。
+ * 引号内的换行不会被当作记录分隔，空行不调用OnLine。
+ */
+template<typename P,typename M>
+bool ParseCSVFileParallel(task::TaskExecutor &te,const OSString &filename,M &&merge,const char quote_char='"')
+{
+    LineBlockReader reader;
+    const char *begin,*end;
+
+    if(!reader.Open(filename))
+        return(false);
+
+    if(!reader.NextBlock(begin,end))
+        return(true);
+
+    const uint chunk_count=te.GetComputeWorkerCount()+1;
+
+    std::vector<P> parse_list(chunk_count);
+
+    ParallelForEachRecordBlock(te,reader,begin,end,quote_char,chunk_count,
+        [&parse_list,quote_char](const uint index,const char *sp,const char *ep)
+        {
+            P &parse=parse_list[index];
+
+            ForEachRecord(sp,ep,quote_char,[&parse](const char *rs,const char *re)
+            {
+                if(rs>=re)return;
+
+                util::CSVFieldSplite<char> split(rs,int(re-rs));
+
+                parse.OnLine(split);
+            });
+        },
+        [&parse_list,&merge]()
+        {
+            for(P &parse:parse_list)
+                merge(parse);
+        });
+
+    return(true);
+}
@@ -1,4 +1,4 @@
-#include<hgl/util/csv/CSVParse.h>
+#include"ParallelCSVParse.h"
 #include<hgl/type/ArrayList.h>
 #include<hgl/type/Map.h>
 #include<iostream>
@@ -41,6 +41,8 @@ class TraceParse:public util::CSVParseCallback<char>
     uint64 bf_id;
     uint player_id;
 
+    ObjectMap<uint,TraceList> trace_map;    //本实例解析到的轨迹，由MoveTo按文件顺序并入PlayerTrace
+
 public:
 
     bool ParsePosition(const char *str,const int len)
@@ -48,7 +50,7 @@ public:
         const char *sp=str;
         const char *cp;
 
-        cp=hgl::strchr(sp,' ');
+        cp=hgl::strchr(sp,' ',len);             //字段直接在读取缓冲区中，不以'\0'结尾
         if(!cp)return(false);
 
         if(!hgl::stoi(sp,pos.x))
@@ -99,11 +101,11 @@ public:
         {
             TraceList *tl;
 
-            if(!PlayerTrace.Get(player_id,tl))
+            if(!trace_map.Get(player_id,tl))
             {
                 tl=new TraceList;
 
-                PlayerTrace.Add(player_id,tl);
+                trace_map.Add(player_id,tl);
             }
 
             tl->Add(pos);
@@ -111,13 +113,58 @@ public:
 
         return(true);
     }
+
+    /**
+     * 把本实例的轨迹追加到target中，本实例的轨迹清空但保留内存，供下一块继续使用
+     */
+    void MoveTo(ObjectMap<uint,TraceList> &target)
+    {
+        const uint pc=trace_map.GetCount();
+
+        const auto *pt=trace_map.GetDataList();
+
+        for(uint i=0;i<pc;i++)
+        {
+            TraceList *src=(*pt)->value;
+            const uint count=src->GetCount();
+
+            if(count>0)
+            {
+                TraceList *dst;
+
+                if(!target.Get((*pt)->key,dst))
+                {
+                    dst=new TraceList;
+
+                    target.Add((*pt)->key,dst);
+                }
+
+                const uint old_count=dst->GetCount();
+
+                dst->SetCount(old_count+count);
+                memcpy(dst->GetData()+old_count,src->GetData(),count*sizeof(Vector2i));
+
+                src->SetCount(0);
+            }
+
+            ++pt;
+        }
+    }
 };//class CSVTest;
 
 bool LoadCSVRecord(const OSString &filename)
 {
-    TraceParse tp;
+    task::TaskExecutor te;
+
+    te.Start();
 
-    return util::ParseCSVFile(filename,&tp);
+    std::cout<<"Parse workers: "<<te.GetComputeWorkerCount()+1<<std::endl;
+
+    //每个线程一个TraceParse，各自解析文件中连续的一段，每块结束后按文件顺序合并，轨迹点的顺序与文件相同
+    return ParseCSVFileParallel<TraceParse>(te,filename,[](TraceParse &tp)
+    {
+        tp.MoveTo(PlayerTrace);
+    });
 }
 
 void DrawIcon(const uint index,const uint x,uint y,const Vector3u8 &color)
@@ -0,0 +1,272 @@
+#include "ecs/EntityPool.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/ArchetypeStorage.h"
+#include "ecs/View.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+struct Position
+{
+    float x, y, z;
+};
+
+struct Velocity
+{
+    float x, y, z;
+};
+
+struct Health
+{
+    int hp;
+};
+
+constexpr const int UPDATE_ROUNDS = 10;             // 每种规模的更新轮数
+constexpr const float DELTA_TIME = 1.0f / 60.0f;
+
+struct PoolUpdateData
+{
+    ComponentPool<Position>* positions;
+    float dt;
+};
+
+// 原有方式：遍历Velocity池，再逐个实体到Position池查找
+void PoolUpdate(EntityID entity_id, Velocity* vel, void* user_data)
+{
+    PoolUpdateData* data = static_cast<PoolUpdateData*>(user_data);
+    Position* pos = data->positions->Get(entity_id);
+
+    if (!pos)
+        return;
+
+    pos->x += vel->x * data->dt;
+    pos->y += vel->y * data->dt;
+    pos->z += vel->z * data->dt;
+}
+
+template<typename T> using SparsePool = ComponentPool<T, ComponentStorageType::SparseSet>;
+
+struct SparseUpdateData
+{
+    SparsePool<Position>* positions;
+    float dt;
+};
+
+// 稀疏集合方式：同样遍历Velocity池再查找Position，但查找是两次数组访问
+void SparseUpdate(EntityID entity_id, Velocity* vel, void* user_data)
+{
+    SparseUpdateData* data = static_cast<SparseUpdateData*>(user_data);
+    Position* pos = data->positions->Get(entity_id);
+
+    if (!pos)
+        return;
+
+    pos->x += vel->x * data->dt;
+    pos->y += vel->y * data->dt;
+    pos->z += vel->z * data->dt;
+}
+
+void PrintTime(const char* name, double seconds, int count)
+{
+    std::cout << "    " << std::setw(24) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+              << std::setw(10) << std::setprecision(2) << seconds * 1e9 / count << " ns/entity" << std::endl;
+}
+
+/**
+ * 3/4的实体有Position+Velocity，其余只有Position+Health，两种方式存放相同的数据
+ */
+void RunBenchmark(int entity_count)
+{
+    std::cout << "\n=== " << entity_count << " entities ===" << std::endl;
+
+    EntityPool entity_pool;
+    std::vector<EntityID> entities(entity_count);
+
+    for (int i = 0; i < entity_count; ++i)
+        entities[i] = entity_pool.Create();
+
+    double pool_sum = 0, sparse_sum = 0, arch_sum = 0;
+
+    // ComponentPool
+    {
+        ComponentPool<Position> positions;
+        ComponentPool<Velocity> velocities;
+        ComponentPool<Health> healths;
+
+        double st = GetPreciseTime();
+
+        for (int i = 0; i < entity_count; ++i)
+        {
+            positions.Add(entities[i], Position{float(i), 0, 0});
+
+            if (i % 4 != 3)
+                velocities.Add(entities[i], Velocity{1, 2, 3});
+            else
+                healths.Add(entities[i], Health{100});
+        }
+
+        PrintTime("ComponentPool create", GetPreciseTime() - st, entity_count);
+
+        PoolUpdateData data{&positions, DELTA_TIME};
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+            velocities.Iterate(PoolUpdate, &data);
+
+        PrintTime("ComponentPool update", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+
+        for (int i = 0; i < entity_count; ++i)
+            pool_sum += positions.Get(entities[i])->x;
+
+        // View按较小的Velocity池驱动，lambda可内联，只比较遍历方式，不计入校验和
+        View<Position, const Velocity> view(positions, velocities);
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+        {
+            view.Each([](EntityID, Position& pos, const Velocity& vel)
+            {
+                pos.x += vel.x * DELTA_TIME;
+                pos.y += vel.y * DELTA_TIME;
+                pos.z += vel.z * DELTA_TIME;
+            });
+        }
+
+        PrintTime("ComponentPool view", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+    }
+
+    // ComponentPool (SparseSet)
+    {
+        SparsePool<Position> positions;
+        SparsePool<Velocity> velocities;
+        SparsePool<Health> healths;
+
+        double st = GetPreciseTime();
+
+        for (int i = 0; i < entity_count; ++i)
+        {
+            positions.Add(entities[i], Position{float(i), 0, 0});
+
+            if (i % 4 != 3)
+                velocities.Add(entities[i], Velocity{1, 2, 3});
+            else
+                healths.Add(entities[i], Health{100});
+        }
+
+        PrintTime("SparseSet create", GetPreciseTime() - st, entity_count);
+
+        SparseUpdateData data{&positions, DELTA_TIME};
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+            velocities.Iterate(SparseUpdate, &data);
+
+        PrintTime("SparseSet update", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+
+        for (int i = 0; i < entity_count; ++i)
+            sparse_sum += positions.Get(entities[i])->x;
+
+        st = GetPreciseTime();
+
+        for (int i = 0; i < entity_count; i += 2)
+            positions.Remove(entities[i]);
+
+        PrintTime("SparseSet remove half", GetPreciseTime() - st, entity_count / 2);
+    }
+
+    // ArchetypeStorage
+    {
+        ArchetypeStorage storage;
+
+        double st = GetPreciseTime();
+
+        for (int i = 0; i < entity_count; ++i)
+        {
+            if (i % 4 != 3)
+                storage.AddEntity(entities[i], Position{float(i), 0, 0}, Velocity{1, 2, 3});
+            else
+                storage.AddEntity(entities[i], Position{float(i), 0, 0}, Health{100});
+        }
+
+        PrintTime("Archetype create", GetPreciseTime() - st, entity_count);
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+        {
+            storage.ForEach<Position, Velocity>([](EntityID, Position& pos, const Velocity& vel)
+            {
+                pos.x += vel.x * DELTA_TIME;
+                pos.y += vel.y * DELTA_TIME;
+                pos.z += vel.z * DELTA_TIME;
+            });
+        }
+
+        PrintTime("Archetype update", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+
+        for (int i = 0; i < entity_count; ++i)
+            arch_sum += storage.Get<Position>(entities[i])->x;
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+        {
+            storage.ForEachChunk<Position, Velocity>([](uint32 count, const EntityID*, Position* pos, const Velocity* vel)
+            {
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    pos[i].x += vel[i].x * DELTA_TIME;
+                    pos[i].y += vel[i].y * DELTA_TIME;
+                    pos[i].z += vel[i].z * DELTA_TIME;
+                }
+            });
+        }
+
+        PrintTime("Archetype chunk update", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+
+        ArchetypeView<Position, const Velocity> view(storage);
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+        {
+            // 按块区间拆成4份，模拟并行调度器的切分
+            const size_t chunk_count = view.GetChunkCount();
+
+            for (size_t part = 0; part < 4; ++part)
+            {
+                view.Each(chunk_count * part / 4, chunk_count * (part + 1) / 4, [](EntityID, Position& pos, const Velocity& vel)
+                {
+                    pos.x += vel.x * DELTA_TIME;
+                    pos.y += vel.y * DELTA_TIME;
+                    pos.z += vel.z * DELTA_TIME;
+                });
+            }
+        }
+
+        PrintTime("Archetype view ranges", (GetPreciseTime() - st) / UPDATE_ROUNDS, entity_count);
+
+        std::cout << "    Archetypes: " << storage.GetArchetypeCount() << std::endl;
+    }
+
+    std::cout << "    Checksum: " << std::setprecision(1) << pool_sum << " / " << sparse_sum << " / " << arch_sum << std::endl;
+}
+
+int main()
+{
+    std::cout << "ComponentPool (Map / SparseSet) vs ArchetypeStorage, (Position, Velocity) update" << std::endl;
+
+    RunBenchmark(10000);
+    RunBenchmark(100000);
+    RunBenchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "ecs/EntityPool.h"
+#include "ecs/EntityListManager.h"
+#include "ecs/EntityBitsetManager.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+constexpr const int ENTITY_COUNT = 1000000;
+constexpr const int REPEAT = 10;
+
+void PrintTime(const char* name, double seconds, int64 result)
+{
+    std::cout << "    " << std::setw(32) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+              << std::setw(10) << result << std::endl;
+}
+
+int main()
+{
+    EntityPool pool;
+    std::vector<EntityID> entities(ENTITY_COUNT);
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+        entities[i] = pool.Create();
+
+    // 三个标签：Visible 50%、Enemy 25%、Dead 10%
+    std::mt19937 rng(1);
+    std::vector<EntityID> visible_ids, enemy_ids, dead_ids;
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        const uint32 r = rng() % 100;
+
+        if (r < 50) visible_ids.push_back(entities[i]);
+        if (r % 4 == 0) enemy_ids.push_back(entities[i]);
+        if (r % 10 == 3) dead_ids.push_back(entities[i]);
+    }
+
+    std::cout << ENTITY_COUNT << " entities, Visible " << visible_ids.size()
+              << ", Enemy " << enemy_ids.size() << ", Dead " << dead_ids.size() << std::endl;
+
+    EntityListManager visible_list(&pool), enemy_list(&pool), dead_list(&pool);
+    EntityBitsetManager visible_bits(&pool), enemy_bits(&pool), dead_bits(&pool);
+
+    std::cout << "Build" << std::endl;
+
+    double st = GetPreciseTime();
+    visible_list.AddBatch(visible_ids.data(), int(visible_ids.size()));
+    enemy_list.AddBatch(enemy_ids.data(), int(enemy_ids.size()));
+    dead_list.AddBatch(dead_ids.data(), int(dead_ids.size()));
+    PrintTime("EntityListManager", GetPreciseTime() - st, visible_list.GetCount() + enemy_list.GetCount() + dead_list.GetCount());
+
+    st = GetPreciseTime();
+    visible_bits.AddBatch(visible_ids.data(), int(visible_ids.size()));
+    enemy_bits.AddBatch(enemy_ids.data(), int(enemy_ids.size()));
+    dead_bits.AddBatch(dead_ids.data(), int(dead_ids.size()));
+    PrintTime("EntityBitsetManager", GetPreciseTime() - st, visible_bits.GetCount() + enemy_bits.GetCount() + dead_bits.GetCount());
+
+    // 随机成员测试
+    std::vector<EntityID> probes(ENTITY_COUNT);
+
+    for (EntityID& id : probes)
+        id = entities[rng() % ENTITY_COUNT];
+
+    std::cout << "Contains x" << ENTITY_COUNT << std::endl;
+
+    int64 hits = 0;
+    st = GetPreciseTime();
+
+    for (const EntityID id : probes)
+        hits += enemy_list.Contains(id);
+
+    PrintTime("EntityListManager", GetPreciseTime() - st, hits);
+
+    hits = 0;
+    st = GetPreciseTime();
+
+    for (const EntityID id : probes)
+        hits += enemy_bits.Contains(id);
+
+    PrintTime("EntityBitsetManager", GetPreciseTime() - st, hits);
+
+    // Visible AND Enemy AND NOT Dead
+    std::cout << "Visible & Enemy & ~Dead (x" << REPEAT << ")" << std::endl;
+
+    std::vector<EntityID> merged, result;
+    st = GetPreciseTime();
+
+    for (int r = 0; r < REPEAT; ++r)
+    {
+        const SortedSet<EntityID>& v = visible_list.GetSet();
+        const SortedSet<EntityID>& e = enemy_list.GetSet();
+        const SortedSet<EntityID>& d = dead_list.GetSet();
+
+        merged.clear();
+        result.clear();
+        std::set_intersection(v.GetData(), v.GetData() + v.GetCount(), e.GetData(), e.GetData() + e.GetCount(), std::back_inserter(merged));
+        std::set_difference(merged.begin(), merged.end(), d.GetData(), d.GetData() + d.GetCount(), std::back_inserter(result));
+    }
+
+    PrintTime("Sorted merge", (GetPreciseTime() - st) / REPEAT, int64(result.size()));
+
+    EntityBitsetManager scratch(&pool);
+    st = GetPreciseTime();
+
+    for (int r = 0; r < REPEAT; ++r)
+    {
+        scratch.Assign(visible_bits);
+        scratch.AndWith(enemy_bits);
+        scratch.AndNotWith(dead_bits);
+    }
+
+    PrintTime("Bitset And/AndNot", (GetPreciseTime() - st) / REPEAT, scratch.GetCount());
+
+    int64 counted = 0;
+    st = GetPreciseTime();
+
+    for (int r = 0; r < REPEAT; ++r)
+        counted = visible_bits.CountAnd(enemy_bits);
+
+    PrintTime("Bitset CountAnd (Visible&Enemy)", (GetPreciseTime() - st) / REPEAT, counted);
+
+    // 遍历结果
+    int64 checksum = 0;
+    st = GetPreciseTime();
+
+    scratch.ForEach([&checksum](EntityID id) { checksum += GetEntityIndex(id); });
+
+    PrintTime("Bitset ForEach result", GetPreciseTime() - st, int64(scratch.GetCount()));
+
+    int64 expect = 0;
+
+    for (const EntityID id : result)
+        expect += GetEntityIndex(id);
+
+    std::cout << "  Result: " << (checksum == expect && int(result.size()) == scratch.GetCount() ? "OK" : "MISMATCH") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "ecs/EntityPool.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/View.h"
+#include "ecs/SystemScheduler.h"
+#include "ecs/EventQueue.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+constexpr const int ENTITY_COUNT = 100000;
+constexpr const int FRAME_COUNT = 50;
+constexpr const int ATTACK_PERIOD = 50;             // 每帧1/50的实体发起攻击（死亡的也算，使两种做法的输入相同）
+constexpr const float DELTA_TIME = 1.0f / 60.0f;
+
+struct Health { int32 value; };
+struct PendingDamage { int32 amount; };             // 旧做法：把瞬时状态存进组件，每帧扫描
+
+HGL_ECS_COMPONENT_STORAGE(Health, SparseSet)
+HGL_ECS_COMPONENT_STORAGE(PendingDamage, SparseSet)
+
+struct DamageEvent
+{
+    EntityID target;
+    int32 amount;
+};
+
+struct DeathEvent
+{
+    EntityID entity;
+};
+
+struct World
+{
+    EntityPool entities;
+    ComponentPool<Health> healths;
+    std::vector<EntityID> entity_list;
+};
+
+void InitWorld(World& world)
+{
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        const EntityID id = world.entities.Create();
+
+        world.healths.Add(id, Health{100});
+        world.entity_list.push_back(id);
+    }
+}
+
+// 攻击目标与伤害只由攻击者与帧号决定，两种做法结果相同
+EntityID PickTarget(const World& world, uint32 attacker, uint32 frame)
+{
+    return world.entity_list[(attacker * 2654435761u + frame * 40503u) % ENTITY_COUNT];
+}
+
+int32 DamageOf(uint32 attacker, uint32 frame)
+{
+    return int32((attacker + frame) % 20 + 1) * 10;
+}
+
+int64 HealthChecksum(World& world)
+{
+    int64 sum = 0;
+
+    for (int i = 0; i < world.healths.GetCount(); ++i)
+        sum += world.healths.GetAt(i)->value;
+
+    return sum;
+}
+
+int main()
+{
+    task::TaskExecutor executor;
+
+    executor.Start();
+
+    // 事件：攻击系统并行发送DamageEvent，下一帧由ApplyDamage成批读取
+    World event_world;
+    InitWorld(event_world);
+
+    EventBus bus;
+    bus.Register<DamageEvent>();
+    bus.Register<DeathEvent>();
+
+    SystemRegistry registry;
+    registry.SetEventBus(&bus);
+
+    uint32 frame = 0;
+    int deaths = 0, death_events = 0;
+    double apply_time = 0;
+
+    registry.Add("Attack", [&event_world, &frame](SystemContext& ctx)
+    {
+        View<const Health> view(event_world.healths);
+
+        ctx.ParallelEach(view, 4096, [&](EntityID id, const Health&)
+        {
+            const uint32 attacker = GetEntityIndex(id);
+
+            if (attacker % ATTACK_PERIOD == frame % ATTACK_PERIOD)
+                ctx.Send(DamageEvent{PickTarget(event_world, attacker, frame), DamageOf(attacker, frame)});
+        });
+    }).Read<Health>();
+
+    registry.Add("ApplyDamage", [&event_world, &deaths, &apply_time](SystemContext& ctx)
+    {
+        const double st = GetPreciseTime();
+
+        for (const DamageEvent& e : *ctx.GetEvents<DamageEvent>())
+        {
+            Health* health = event_world.healths.Edit(e.target);
+
+            if (health->value > 0 && (health->value = std::max(health->value - e.amount, 0)) == 0)
+            {
+                ctx.Send(DeathEvent{e.target});
+                ++deaths;
+            }
+        }
+
+        apply_time += GetPreciseTime() - st;
+    }).Write<Health>();
+
+    registry.Add("CountDeaths", [&death_events](SystemContext& ctx)
+    {
+        death_events += ctx.GetEvents<DeathEvent>()->GetCount();
+    });
+
+    for (frame = 0; frame < FRAME_COUNT; ++frame)
+        registry.Run(executor, DELTA_TIME);
+
+    // 最后一帧的攻击事件在下一帧才被处理
+    registry.SetEnabled("Attack", false);
+    registry.Run(executor, DELTA_TIME);
+    registry.Run(executor, DELTA_TIME);
+
+    // 旧做法：伤害累加到目标的PendingDamage组件，每帧扫描全部实体
+    World scan_world;
+    InitWorld(scan_world);
+
+    ComponentPool<PendingDamage> pending;
+
+    for (const EntityID id : scan_world.entity_list)
+        pending.Add(id, PendingDamage{0});
+
+    int scan_deaths = 0;
+    double scan_time = 0;
+
+    for (frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        for (int i = 0; i < scan_world.healths.GetCount(); ++i)
+        {
+            const uint32 attacker = GetEntityIndex(scan_world.healths.GetEntity(i));
+
+            if (attacker % ATTACK_PERIOD == frame % ATTACK_PERIOD)
+                pending.Get(PickTarget(scan_world, attacker, frame))->amount += DamageOf(attacker, frame);
+        }
+
+        const double st = GetPreciseTime();
+
+        View<Health, PendingDamage> view(scan_world.healths, pending);
+
+        view.Each([&scan_deaths](EntityID, Health& health, PendingDamage& damage)
+        {
+            if (!damage.amount)
+                return;
+
+            if (health.value > 0 && (health.value = std::max(health.value - damage.amount, 0)) == 0)
+                ++scan_deaths;
+
+            damage.amount = 0;
+        });
+
+        scan_time += GetPreciseTime() - st;
+    }
+
+    std::cout << ENTITY_COUNT << " entities, " << FRAME_COUNT << " frames, "
+              << executor.GetComputeWorkerCount() << " compute workers" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "  Event batch apply:   " << apply_time * 1000.0 / FRAME_COUNT << " ms/frame" << std::endl
+              << "  PendingDamage scan:  " << scan_time * 1000.0 / FRAME_COUNT << " ms/frame" << std::endl
+              << "  Deaths: " << deaths << " (" << death_events << " DeathEvent) / " << scan_deaths << std::endl
+              << "  Result: " << (HealthChecksum(event_world) == HealthChecksum(scan_world) && deaths == scan_deaths && deaths == death_events ? "OK" : "MISMATCH") << std::endl;
+
+    executor.Stop();
+    return 0;
+}
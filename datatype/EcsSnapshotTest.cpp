@@ -0,0 +1,215 @@
+#include "ecs/EntityPool.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/Snapshot.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+constexpr const int ENTITY_COUNT = 1000000;
+constexpr const char SNAPSHOT_FILENAME[] = "EcsSnapshotTest.snapshot";
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Health { int32 value, max_value; };          // 可平凡复制，Map存储：逐个恢复
+
+// 非平凡组件：走带版本的路径
+struct Name
+{
+    std::string text;
+    uint32 tag = 0;                                 // 版本2新增
+};
+
+HGL_ECS_COMPONENT_STORAGE(Position, SparseSet)
+HGL_ECS_COMPONENT_STORAGE(Velocity, SparseSet)
+
+template<> struct hgl::ecs::ComponentSerializer<Name>
+{
+    static constexpr uint32 VERSION = 2;
+
+    static void Save(SnapshotWriter& w, const Name& c)
+    {
+        w.WriteString(c.text);
+        w.WriteValue(c.tag);
+    }
+
+    static bool Load(SnapshotReader& r, Name& c, uint32 version)
+    {
+        if (!r.ReadString(c.text))
+            return false;
+
+        if (version >= 2)
+            return r.ReadValue(c.tag);
+
+        c.tag = 0;
+        return true;
+    }
+};
+
+struct World
+{
+    EntityPool entities;
+    ComponentPool<Position> positions;
+    ComponentPool<Velocity> velocities;
+    ComponentPool<Health> healths;
+    ComponentPool<Name> names;
+};
+
+void PrintTime(const char* name, double seconds)
+{
+    std::cout << "  " << std::setw(32) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms" << std::endl;
+}
+
+bool Compare(World& a, World& b)
+{
+    if (a.entities.GetCount() != b.entities.GetCount()
+     || a.positions.GetCount() != b.positions.GetCount()
+     || a.healths.GetCount() != b.healths.GetCount()
+     || a.names.GetCount() != b.names.GetCount())
+        return false;
+
+    for (int i = 0; i < a.positions.GetCount(); ++i)
+    {
+        const EntityID id = a.positions.GetEntity(i);
+        const Position* p = b.positions.Get(id);
+        const Velocity* v = b.velocities.Get(id);
+
+        if (!b.entities.Contains(id) || !p || !v
+         || memcmp(p, a.positions.GetAt(i), sizeof(Position)) != 0
+         || memcmp(v, a.velocities.Get(id), sizeof(Velocity)) != 0)
+            return false;
+    }
+
+    for (int i = 0; i < a.healths.GetCount(); ++i)
+    {
+        const Health* h = b.healths.Get(a.healths.GetEntity(i));
+
+        if (!h || h->value != a.healths.GetAt(i)->value)
+            return false;
+    }
+
+    for (int i = 0; i < a.names.GetCount(); ++i)
+    {
+        const Name* n = b.names.Get(a.names.GetEntity(i));
+
+        if (!n || n->text != a.names.GetAt(i)->text || n->tag != a.names.GetAt(i)->tag)
+            return false;
+    }
+
+    // 恢复后复用槽位的顺序与保存时相同
+    return a.entities.Create() == b.entities.Create();
+}
+
+void Register(WorldSnapshot& snapshot, World& world)
+{
+    snapshot.Register("Position", world.positions);
+    snapshot.Register("Velocity", world.velocities);
+    snapshot.Register("Health", world.healths);
+    snapshot.Register("Name", world.names);
+}
+
+int main()
+{
+    World world;
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        const EntityID id = world.entities.Create();
+
+        world.positions.Add(id, Position{float(i), float(i % 100), 0});
+        world.velocities.Add(id, Velocity{1, 0.5f, float(i % 7)});
+
+        if (i % 10 == 0)
+            world.healths.Add(id, Health{i % 100, 100});
+
+        if (i % 100 == 0)
+            world.names.Add(id, Name{"Entity" + std::to_string(i), uint32(i)});
+    }
+
+    // 销毁一部分实体，使快照中有空闲槽位与非1的代数
+    for (int i = 0; i < ENTITY_COUNT; i += 97)
+    {
+        const EntityID id = world.positions.GetEntity(i);
+
+        world.positions.Remove(id);
+        world.velocities.Remove(id);
+        world.healths.Remove(id);
+        world.names.Remove(id);
+        world.entities.Destroy(id);
+    }
+
+    std::cout << world.entities.GetCount() << " entities, "
+              << world.healths.GetCount() << " Health, "
+              << world.names.GetCount() << " Name" << std::endl;
+
+    WorldSnapshot snapshot(&world.entities);
+    Register(snapshot, world);
+
+    double st = GetPreciseTime();
+
+    if (!snapshot.SaveToFile(SNAPSHOT_FILENAME))
+    {
+        std::cout << "Save failed" << std::endl;
+        return 1;
+    }
+
+    PrintTime("Save", GetPreciseTime() - st);
+
+    // 对照：逐个实体Add重建相同的组件
+    {
+        ComponentPool<Position> positions;
+        ComponentPool<Velocity> velocities;
+
+        st = GetPreciseTime();
+
+        for (int i = 0; i < world.positions.GetCount(); ++i)
+        {
+            const EntityID id = world.positions.GetEntity(i);
+
+            positions.Add(id, *world.positions.GetAt(i));
+            velocities.Add(id, *world.velocities.Get(id));
+        }
+
+        PrintTime("Per-entity Add (Pos+Vel)", GetPreciseTime() - st);
+    }
+
+    // 只登记原始块的池：其余块被跳过
+    {
+        EntityPool entities;
+        ComponentPool<Position> positions;
+        ComponentPool<Velocity> velocities;
+
+        WorldSnapshot raw_snapshot(&entities);
+        raw_snapshot.Register("Position", positions);
+        raw_snapshot.Register("Velocity", velocities);
+
+        st = GetPreciseTime();
+
+        const bool loaded = raw_snapshot.LoadFromFile(SNAPSHOT_FILENAME);
+
+        PrintTime("Load (entities + Pos/Vel)", GetPreciseTime() - st);
+
+        if (!loaded || positions.GetCount() != world.positions.GetCount())
+            std::cout << "  Raw load FAILED" << std::endl;
+    }
+
+    World restored;
+    WorldSnapshot restore_snapshot(&restored.entities);
+    Register(restore_snapshot, restored);
+
+    st = GetPreciseTime();
+
+    const bool loaded = restore_snapshot.LoadFromFile(SNAPSHOT_FILENAME);
+
+    PrintTime("Load (whole world)", GetPreciseTime() - st);
+
+    std::cout << "  Restore: " << (loaded && Compare(world, restored) ? "OK" : "FAILED") << std::endl;
+
+    std::remove(SNAPSHOT_FILENAME);
+    return 0;
+}
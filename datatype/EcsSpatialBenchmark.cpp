@@ -0,0 +1,239 @@
+#include "ecs/EntityPool.h"
+#include "ecs/SpatialGridManager.h"
+#include "ecs/LooseOctreeManager.h"
+#include<hgl/math/Projection.h>
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+using namespace hgl::math;
+
+constexpr const int ENTITY_COUNT = 100000;
+constexpr const float WORLD_SIZE = 1000.0f;
+constexpr const float QUERY_RADIUS = 10.0f;
+constexpr const int QUERY_COUNT = 1000;             // 逐个暴力比较的查询数
+constexpr const int FRAME_COUNT = 10;
+
+void PrintTime(const char* name, double seconds, int64 found)
+{
+    std::cout << "    " << std::setw(32) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+              << std::setw(12) << found << " found" << std::endl;
+}
+
+void TestGrid(EntityPool& pool, const std::vector<EntityID>& entities)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dis(0.0f, WORLD_SIZE);
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+
+    SpatialGridManager grid(&pool, QUERY_RADIUS);
+    std::vector<Vector2f> positions(ENTITY_COUNT);
+
+    double st = GetPreciseTime();
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        positions[i] = Vector2f(dis(rng), dis(rng));
+        grid.Add(entities[i], positions[i]);
+    }
+
+    std::cout << "2D hash grid (" << grid.GetCellCount() << " cells)" << std::endl;
+    PrintTime("Insert", GetPreciseTime() - st, grid.GetCount());
+
+    std::vector<EntityID> result;
+    int64 brute_found = 0, grid_found = 0;
+
+    // 对照：逐个比较全部实体，即每个实体都查询时的O(N²)
+    st = GetPreciseTime();
+
+    for (int q = 0; q < QUERY_COUNT; ++q)
+    {
+        const Vector2f& c = positions[q];
+
+        for (int i = 0; i < ENTITY_COUNT; ++i)
+        {
+            const float dx = positions[i].x - c.x, dy = positions[i].y - c.y;
+
+            brute_found += dx * dx + dy * dy <= QUERY_RADIUS * QUERY_RADIUS;
+        }
+    }
+
+    PrintTime("Brute force radius x1000", GetPreciseTime() - st, brute_found);
+
+    st = GetPreciseTime();
+
+    for (int q = 0; q < QUERY_COUNT; ++q)
+    {
+        result.clear();
+        grid_found += grid.QueryRadius(positions[q], QUERY_RADIUS, result);
+    }
+
+    PrintTime("Grid radius x1000", GetPreciseTime() - st, grid_found);
+
+    // 所有实体各查询一次邻居
+    st = GetPreciseTime();
+    grid_found = 0;
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        result.clear();
+        grid_found += grid.QueryRadius(positions[i], QUERY_RADIUS, result);
+    }
+
+    PrintTime("Grid radius, every entity", GetPreciseTime() - st, grid_found);
+
+    // 每帧所有实体小幅移动，大部分不跨格
+    st = GetPreciseTime();
+
+    for (int f = 0; f < FRAME_COUNT; ++f)
+        for (int i = 0; i < ENTITY_COUNT; ++i)
+        {
+            positions[i].x += step(rng);
+            positions[i].y += step(rng);
+            grid.Update(entities[i], positions[i]);
+        }
+
+    PrintTime("Update all (per frame)", (GetPreciseTime() - st) / FRAME_COUNT, grid.GetCount());
+
+    result.clear();
+    grid_found = grid.QueryRadius(positions[0], QUERY_RADIUS, result);
+    brute_found = 0;
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        const float dx = positions[i].x - positions[0].x, dy = positions[i].y - positions[0].y;
+
+        brute_found += dx * dx + dy * dy <= QUERY_RADIUS * QUERY_RADIUS;
+    }
+
+    std::cout << "    After moves: " << (grid_found == brute_found ? "OK" : "MISMATCH") << std::endl;
+}
+
+void TestOctree(EntityPool& pool, const std::vector<EntityID>& entities)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dis(0.0f, WORLD_SIZE);
+    std::uniform_real_distribution<float> size(0.1f, 5.0f);
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+
+    // 深度4：最深一层4096格，每格约24个实体
+    LooseOctreeManager octree(&pool, Vector3f(0, 0, 0), WORLD_SIZE, 4);
+    std::vector<Vector3f> positions(ENTITY_COUNT);
+    std::vector<float> radii(ENTITY_COUNT);
+
+    double st = GetPreciseTime();
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        positions[i] = Vector3f(dis(rng), dis(rng), dis(rng));
+        radii[i] = size(rng);
+        octree.Add(entities[i], positions[i], radii[i]);
+    }
+
+    std::cout << "3D loose octree (" << octree.GetNodeCount() << " nodes)" << std::endl;
+    PrintTime("Insert", GetPreciseTime() - st, octree.GetCount());
+
+    auto BruteSphere = [&](const Vector3f& c, float r)
+    {
+        int64 found = 0;
+
+        for (int i = 0; i < ENTITY_COUNT; ++i)
+        {
+            const float dx = positions[i].x - c.x, dy = positions[i].y - c.y, dz = positions[i].z - c.z;
+            const float reach = r + radii[i];
+
+            found += dx * dx + dy * dy + dz * dz <= reach * reach;
+        }
+
+        return found;
+    };
+
+    std::vector<EntityID> result;
+    int64 brute_found = 0, tree_found = 0;
+
+    st = GetPreciseTime();
+
+    for (int q = 0; q < QUERY_COUNT; ++q)
+        brute_found += BruteSphere(positions[q], QUERY_RADIUS * 5);
+
+    PrintTime("Brute force radius x1000", GetPreciseTime() - st, brute_found);
+
+    st = GetPreciseTime();
+
+    for (int q = 0; q < QUERY_COUNT; ++q)
+    {
+        result.clear();
+        tree_found += octree.QueryRadius(positions[q], QUERY_RADIUS * 5, result);
+    }
+
+    PrintTime("Octree radius x1000", GetPreciseTime() - st, tree_found);
+
+    // 大范围AABB：大部分节点整体在内，不再逐个测试
+    AABB box;
+    box.SetMinMax(Vector3f(100, 100, 100), Vector3f(600, 600, 600));
+
+    st = GetPreciseTime();
+    result.clear();
+    tree_found = octree.QueryAABB(box, result);
+    PrintTime("Octree AABB", GetPreciseTime() - st, tree_found);
+
+    // 从世界一角看向中心的视锥
+    Frustum frustum;
+    frustum.SetMatrix(PerspectiveMatrix(60.0f, 16.0f / 9.0f, 1.0f, WORLD_SIZE)
+                    * LookAtMatrix(Vector3f(-50, -50, -50), Vector3f(500, 500, 500), Vector3f(0, 0, 1)));
+
+    int64 frustum_brute = 0;
+
+    st = GetPreciseTime();
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+        frustum_brute += frustum.SphereIn(positions[i], radii[i]) != Frustum::Scope::OUTSIDE;
+
+    PrintTime("Brute force frustum", GetPreciseTime() - st, frustum_brute);
+
+    st = GetPreciseTime();
+    result.clear();
+    tree_found = octree.QueryFrustum(frustum, result);
+    PrintTime("Octree frustum", GetPreciseTime() - st, tree_found);
+
+    std::cout << "    Frustum: " << (tree_found == frustum_brute ? "OK" : "MISMATCH") << std::endl;
+
+    st = GetPreciseTime();
+
+    for (int f = 0; f < FRAME_COUNT; ++f)
+        for (int i = 0; i < ENTITY_COUNT; ++i)
+        {
+            positions[i].x += step(rng);
+            positions[i].y += step(rng);
+            positions[i].z += step(rng);
+            octree.Update(entities[i], positions[i]);
+        }
+
+    PrintTime("Update all (per frame)", (GetPreciseTime() - st) / FRAME_COUNT, octree.GetCount());
+
+    result.clear();
+    tree_found = octree.QueryRadius(positions[0], QUERY_RADIUS * 5, result);
+
+    std::cout << "    After moves: " << (tree_found == BruteSphere(positions[0], QUERY_RADIUS * 5) ? "OK" : "MISMATCH") << std::endl;
+}
+
+int main()
+{
+    EntityPool pool;
+    std::vector<EntityID> entities(ENTITY_COUNT);
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+        entities[i] = pool.Create();
+
+    std::cout << ENTITY_COUNT << " entities, query radius " << QUERY_RADIUS << std::endl;
+
+    TestGrid(pool, entities);
+    TestOctree(pool, entities);
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "ecs/EntityPool.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/View.h"
+#include "ecs/SystemScheduler.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+constexpr const int ENTITY_COUNT = 100000;
+constexpr const int FRAME_COUNT = 20;
+constexpr const float DELTA_TIME = 1.0f / 60.0f;
+constexpr const int CHANGED_COUNT = 100;            // 静态场景中每帧修改的Velocity数
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+
+// 模拟大量互不相关的系统：第N个系统只写自己的Stat<N>，只读Position
+template<int N> struct Stat { float value; };
+
+HGL_ECS_COMPONENT_STORAGE(Position, SparseSet)
+HGL_ECS_COMPONENT_STORAGE(Velocity, SparseSet)
+
+constexpr const int STAT_COUNT = 16;
+
+struct World
+{
+    EntityPool entities;
+    ComponentPool<Position> positions;
+    ComponentPool<Velocity> velocities;
+};
+
+template<int N>
+ComponentPool<Stat<N>>& GetStatPool()
+{
+    static ComponentPool<Stat<N>> pool;
+    return pool;
+}
+
+template<int N>
+void RegisterStatSystem(SystemRegistry& registry, World& world)
+{
+    ComponentPool<Stat<N>>& stats = GetStatPool<N>();
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+        stats.Add(world.positions.GetEntity(i), Stat<N>{0});
+
+    SystemDesc& desc = registry.Add("Stat" + std::to_string(N), [&world, &stats](SystemContext&)
+    {
+        View<Stat<N>, const Position> view(stats, world.positions);
+
+        view.Each([](EntityID, Stat<N>& stat, const Position& pos)
+        {
+            stat.value = stat.value * 0.9f + std::sqrt(pos.x * pos.x + pos.y * pos.y + pos.z * pos.z + float(N));
+        });
+    });
+
+    desc.Write<Stat<N>>();
+    desc.Read<Position>();
+}
+
+template<int... N>
+void RegisterStatSystems(SystemRegistry& registry, World& world, std::integer_sequence<int, N...>)
+{
+    (RegisterStatSystem<N>(registry, world), ...);
+}
+
+template<int... N>
+double StatChecksum(std::integer_sequence<int, N...>)
+{
+    double sum = 0;
+
+    ((GetStatPool<N>().Iterate([](EntityID, Stat<N>* stat, void* data) { *static_cast<double*>(data) += stat->value; }, &sum)), ...);
+
+    return sum;
+}
+
+template<int... N>
+void ResetWorld(World& world, std::integer_sequence<int, N...>)
+{
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        *world.positions.GetAt(i) = Position{float(i % 100), float(i % 37), 0};
+        *world.velocities.GetAt(i) = Velocity{1, 0.5f, 0.25f};
+
+        ((GetStatPool<N>().GetAt(i)->value = 0), ...);
+    }
+}
+
+int main()
+{
+    World world;
+
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+    {
+        EntityID id = world.entities.Create();
+
+        world.positions.Add(id, Position{});
+        world.velocities.Add(id, Velocity{});
+    }
+
+    SystemRegistry registry;
+
+    // 移动系统写Position，其余读Position的系统都排在它之后
+    registry.Add("Movement", [&world](SystemContext& ctx)
+    {
+        View<Position, const Velocity> view(world.positions, world.velocities);
+        const float dt = ctx.GetDeltaTime();
+
+        // 系统内部再按区间并行
+        ctx.ParallelEach(view, 4096, [dt](EntityID, Position& pos, const Velocity& vel)
+        {
+            pos.x += vel.x * dt;
+            pos.y += vel.y * dt;
+            pos.z += vel.z * dt;
+        });
+    }).Write<Position>().Read<Velocity>();
+
+    RegisterStatSystems(registry, world, std::make_integer_sequence<int, STAT_COUNT>{});
+
+    // 阻尼系统写Velocity，与Movement冲突，与Stat系统不冲突
+    registry.Add("Damping", [&world](SystemContext&)
+    {
+        world.velocities.Iterate([](EntityID, Velocity* vel, void*)
+        {
+            vel->x *= 0.99f;
+            vel->y *= 0.99f;
+            vel->z *= 0.99f;
+        });
+    }).Write<Velocity>();
+
+    const auto& stages = registry.GetStages();
+
+    std::cout << registry.GetSystemCount() << " systems in " << stages.size() << " stages" << std::endl;
+
+    for (size_t s = 0; s < stages.size(); ++s)
+    {
+        std::cout << "  Stage " << s << ":";
+
+        for (int index : stages[s])
+            std::cout << " " << registry.GetSystem(index).GetName();
+
+        std::cout << std::endl;
+    }
+
+    // 串行
+    ResetWorld(world, std::make_integer_sequence<int, STAT_COUNT>{});
+
+    double st = GetPreciseTime();
+
+    for (int f = 0; f < FRAME_COUNT; ++f)
+        registry.Run(DELTA_TIME);
+
+    const double serial_time = (GetPreciseTime() - st) / FRAME_COUNT;
+    const double serial_sum = StatChecksum(std::make_integer_sequence<int, STAT_COUNT>{});
+
+    // 并行，输入与串行相同
+    ResetWorld(world, std::make_integer_sequence<int, STAT_COUNT>{});
+
+    task::TaskExecutor executor;
+
+    executor.Start();
+
+    st = GetPreciseTime();
+
+    for (int f = 0; f < FRAME_COUNT; ++f)
+        registry.Run(executor, DELTA_TIME);
+
+    const double parallel_time = (GetPreciseTime() - st) / FRAME_COUNT;
+    const double parallel_sum = StatChecksum(std::make_integer_sequence<int, STAT_COUNT>{});
+    const uint32 worker_count = executor.GetComputeWorkerCount();
+
+    executor.Stop();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Serial   frame: " << serial_time * 1000.0 << " ms" << std::endl
+              << "Parallel frame: " << parallel_time * 1000.0 << " ms ("
+              << worker_count << " compute workers)" << std::endl
+              << std::setprecision(1)
+              << "Checksum: " << serial_sum << " / " << parallel_sum << std::endl;
+
+    // 大部分实体静止：每帧只修改少量Velocity，响应系统用Changed<Velocity>只处理被修改的实体
+    SystemRegistry reactive;
+    int reacted = 0, next = 0;
+
+    reactive.Add("Edit", [&world, &next](SystemContext&)
+    {
+        for (int i = 0; i < CHANGED_COUNT; ++i)
+        {
+            world.velocities.Edit(world.velocities.GetEntity(next))->y += 0.1f;
+            next = (next + 7919) % ENTITY_COUNT;
+        }
+    }).Write<Velocity>();
+
+    // 两个响应系统做同样的逐实体工作，一个遍历全部实体，一个只遍历上次运行后被修改的实体
+    auto React = [&reacted](EntityID, const Velocity& vel)
+    {
+        reacted += std::sqrt(vel.x * vel.x + vel.y * vel.y + vel.z * vel.z) > 0;
+    };
+
+    reactive.Add("FullScan", [&world, &React](SystemContext&)
+    {
+        View<const Velocity> view(world.velocities);
+
+        view.Each(React);
+    }).Read<Velocity>();
+
+    reactive.Add("Changed", [&world, &React](SystemContext& ctx)
+    {
+        View<const Velocity> view(world.velocities);
+
+        view.Filter<Changed<Velocity>>(ctx.GetLastRunTick());
+        view.Each(React);
+    }).Read<Velocity>();
+
+    auto RunReactive = [&](const char* enabled, const char* disabled)
+    {
+        reactive.SetEnabled(enabled, true);
+        reactive.SetEnabled(disabled, false);
+        reactive.Run(DELTA_TIME);                       // 预热：首次运行时所有组件都算作已修改
+
+        reacted = 0;
+
+        const double start = GetPreciseTime();
+
+        for (int f = 0; f < FRAME_COUNT; ++f)
+            reactive.Run(DELTA_TIME);
+
+        std::cout << "  " << std::setw(12) << std::left << enabled << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(3) << (GetPreciseTime() - start) * 1000.0 / FRAME_COUNT << " ms"
+                  << std::setw(10) << reacted / FRAME_COUNT << " entities/frame" << std::endl;
+    };
+
+    std::cout << "Static world, " << CHANGED_COUNT << " edits/frame" << std::endl;
+    RunReactive("FullScan", "Changed");
+    RunReactive("Changed", "FullScan");
+
+    return 0;
+}
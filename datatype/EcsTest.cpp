@@ -2,6 +2,9 @@
 #include "ecs/EntityListManager.h"
 #include "ecs/EntityTreeManager.h"
 #include "ecs/ComponentPool.h"
+#include "ecs/View.h"
+#include "ecs/CommandBuffer.h"
+#include "ecs/SystemScheduler.h"
 #include <iostream>
 
 using namespace hgl::ecs;
@@ -30,6 +33,14 @@ struct NameComponent
     }
 };
 
+// 示例组件：生命值组件，使用SparseSet存储以记录变更计数
+struct HealthComponent
+{
+    int value;
+};
+
+HGL_ECS_COMPONENT_STORAGE(HealthComponent, SparseSet)
+
 // 打印实体ID的回调函数
 void PrintEntity(EntityID entity_id, void* user_data)
 {
@@ -171,6 +182,229 @@ void TestComponentPool()
     }
 }
 
+void TestView()
+{
+    std::cout << "\n=== Test View ===" << std::endl;
+
+    EntityPool pool;
+    ComponentPool<PositionComponent> positions;
+    ComponentPool<NameComponent> names;
+    ComponentPool<int> hidden;                  // 作为排除条件的标记组件
+
+    for (int i = 0; i < 6; ++i)
+    {
+        EntityID id = pool.Create();
+
+        positions.Add(id, PositionComponent(float(i), 0, 0));
+
+        if (i % 2 == 0)
+            names.Add(id)->SetName("Named");
+
+        if (i == 4)
+            hidden.Add(id, 1);
+    }
+
+    // 以较小的names池驱动遍历，跳过有hidden组件的实体
+    View<PositionComponent, const NameComponent> view(positions, names);
+    view.Exclude(hidden);
+
+    view.Each([](EntityID entity_id, PositionComponent& pos, const NameComponent& name)
+    {
+        pos.y = 1.0f;
+        std::cout << "  Entity " << entity_id << " (" << name.name << ") x=" << pos.x << std::endl;
+    });
+
+    std::cout << "Driver pool size: " << view.GetSize() << std::endl;
+}
+
+void TestMapView()
+{
+    std::cout << "\n=== Test View over Map storage ===" << std::endl;
+
+    EntityPool pool;
+    ComponentPool<PositionComponent> positions;             // 默认Map存储
+    ComponentPool<NameComponent> names;
+
+    static_assert(ComponentStorageOf<PositionComponent>::value == ComponentStorageType::Map, "PositionComponent should use Map storage");
+
+    // 逆序添加，Map中的顺序与添加顺序不同
+    EntityID ids[8];
+
+    for (int i = 0; i < 8; ++i)
+        ids[i] = pool.Create();
+
+    for (int i = 7; i >= 0; --i)
+    {
+        positions.Add(ids[i], PositionComponent(float(GetEntityIndex(ids[i])), 0, 0));
+
+        if (i % 2)
+            names.Add(ids[i])->SetName("Odd");
+    }
+
+    bool ok = true;
+
+    for (int i = 0; i < positions.GetCount(); ++i)
+        if (positions.GetAt(i)->x != float(GetEntityIndex(positions.GetEntity(i))))
+            ok = false;
+
+    int visited = 0;
+
+    View<PositionComponent, const NameComponent> view(positions, names);
+
+    view.Each([&](EntityID entity_id, PositionComponent& pos, const NameComponent&)
+    {
+        if (pos.x != float(GetEntityIndex(entity_id)))
+            ok = false;
+
+        ++visited;
+    });
+
+    std::cout << "Visited " << visited << " / " << names.GetCount() << ": " << (ok && visited == names.GetCount() ? "OK" : "MISMATCH") << std::endl;
+}
+
+void TestCommandBuffer()
+{
+    std::cout << "\n=== Test CommandBuffer ===" << std::endl;
+
+    EntityPool pool;
+    ComponentPool<PositionComponent> positions;
+    ComponentPool<NameComponent> names;
+
+    ComponentPoolSet pool_set;
+    pool_set.Register(positions);
+    pool_set.Register(names);
+
+    for (int i = 0; i < 4; ++i)
+        positions.Add(pool.Create(), PositionComponent(float(i), 0, 0));
+
+    CommandQueue commands;
+
+    // 遍历期间不能直接增删，先记录到命令缓冲区
+    positions.Iterate([](EntityID entity_id, PositionComponent* pos, void* user_data)
+    {
+        CommandBuffer& cb = static_cast<CommandQueue*>(user_data)->Get(0);
+
+        if (pos->x >= 2)
+            cb.Destroy(entity_id);
+        else
+            cb.Add(entity_id, NameComponent());
+    }, &commands);
+
+    PendingEntity spawned = commands.Get(0).Create();
+    commands.Get(0).Add(spawned, PositionComponent(100, 0, 0));
+
+    int applied = commands.Playback(pool, pool_set);
+
+    std::cout << "Applied " << applied << " commands, positions: " << positions.GetCount()
+              << ", names: " << names.GetCount() << std::endl;
+    std::cout << "Spawned entity " << commands.Get(0).GetCreated()[0] << std::endl;
+}
+
+void TestCommandBufferStale()
+{
+    std::cout << "\n=== Test CommandBuffer Stale Targets ===" << std::endl;
+
+    EntityPool pool;
+    ComponentPool<PositionComponent> positions;
+
+    ComponentPoolSet pool_set;
+    pool_set.Register(positions);
+
+    EntityID stale = pool.Create();
+    pool.Destroy(stale);
+
+    EntityID reused = pool.Create();            // 复用stale的槽位，代数不同
+    EntityID doomed = pool.Create();
+
+    CommandQueue commands;
+    CommandBuffer& cb = commands.Get(0);
+
+    cb.Add(stale, PositionComponent(1, 0, 0));  // 已失效的ID
+    cb.Destroy(doomed);
+    cb.Add(doomed, PositionComponent(2, 0, 0)); // 同一缓冲区中先被销毁
+    cb.Add(reused, PositionComponent(3, 0, 0));
+
+    commands.Playback(pool, pool_set);
+
+    const bool ok = positions.GetCount() == 1
+                 && positions.Has(reused)
+                 && !positions.Has(stale)
+                 && !positions.Has(doomed)
+                 && !pool.Contains(doomed);
+
+    std::cout << "Positions: " << positions.GetCount() << " / 1: " << (ok ? "OK" : "MISMATCH") << std::endl;
+}
+
+void TestChangeTicks()
+{
+    std::cout << "\n=== Test Change Ticks ===" << std::endl;
+
+    EntityPool pool;
+    ComponentPool<HealthComponent> healths;
+
+    ComponentPoolSet pool_set;
+    pool_set.Register(healths);
+
+    CommandQueue commands;
+    SystemRegistry registry;
+    registry.SetCommandQueue(&commands, &pool, &pool_set);
+
+    EntityID ids[5];
+
+    for (int i = 0; i < 5; ++i)
+        ids[i] = pool.Create();
+
+    bool spawn = false;
+    int seen_added = 0, seen_changed = 0;
+
+    // 组件经命令缓冲区添加，在本层结束时回放
+    registry.Add("Spawn", [&](SystemContext& ctx)
+    {
+        if (!spawn)
+            return;
+
+        for (const EntityID id : ids)
+            ctx.GetCommands()->Add(id, HealthComponent{100});
+
+        spawn = false;
+    });
+
+    registry.Add("Watch", [&](SystemContext& ctx)
+    {
+        View<const HealthComponent> added_view(healths);
+        added_view.Filter<Added<HealthComponent>>(ctx.GetLastRunTick());
+        added_view.Each([&](EntityID, const HealthComponent&) { ++seen_added; });
+
+        View<const HealthComponent> changed_view(healths);
+        changed_view.Filter<Changed<HealthComponent>>(ctx.GetLastRunTick());
+        changed_view.Each([&](EntityID, const HealthComponent&) { ++seen_changed; });
+    }).Read<HealthComponent>();
+
+    registry.Run(0);                // Watch首次运行，记录计数
+
+    spawn = true;
+    registry.Run(0);                // Spawn的命令在本层结束时回放
+
+    seen_added = seen_changed = 0;
+    registry.Run(0);
+
+    std::cout << "Added via CommandBuffer: seen " << seen_added << " / 5: " << (seen_added == 5 ? "OK" : "MISMATCH") << std::endl;
+
+    // 两次Run之间在系统之外修改
+    for (const EntityID id : ids)
+        healths.Edit(id)->value -= 10;
+
+    seen_added = seen_changed = 0;
+    registry.Run(0);
+
+    std::cout << "Changed outside Run: seen " << seen_changed << " / 5: " << (seen_changed == 5 && seen_added == 0 ? "OK" : "MISMATCH") << std::endl;
+
+    seen_added = seen_changed = 0;
+    registry.Run(0);
+
+    std::cout << "No further changes: seen " << seen_added + seen_changed << ": " << (seen_added + seen_changed == 0 ? "OK" : "MISMATCH") << std::endl;
+}
+
 void TestIntegratedSystem()
 {
     std::cout << "\n=== Test Integrated System ===" << std::endl;
@@ -236,12 +470,18 @@ void TestIntegratedSystem()
         if (pos) std::cout << " at [" << pos->x << ", " << pos->y << ", " << pos->z << "]";
         std::cout << std::endl;
 
-        // 打印子节点
+        // 打印子节点，回调只能带一个user_data，把函数与深度一起传入
+        struct ChildContext
+        {
+            std::function<void(EntityID, int)>* func;
+            int depth;
+        } context{&print_tree, depth + 1};
+
         scene_graph.IterateChildren(entity_id, [](EntityID child_id, void* data)
         {
-            auto& func = *static_cast<std::function<void(EntityID, int)>*>(data);
-            func(child_id, *static_cast<int*>(data) + 1);
-        }, nullptr);
+            ChildContext* ctx = static_cast<ChildContext*>(data);
+            (*ctx->func)(child_id, ctx->depth);
+        }, &context);
     };
 
     // 从根节点开始打印
@@ -264,6 +504,11 @@ int main()
     TestEntityListManager();
     TestEntityTreeManager();
     TestComponentPool();
+    TestView();
+    TestMapView();
+    TestCommandBuffer();
+    TestCommandBufferStale();
+    TestChangeTicks();
     TestIntegratedSystem();
 
     std::cout << "\n==================================" << std::endl;
@@ -0,0 +1,159 @@
+#include "ecs/EntityPool.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/FlatEntityTreeManager.h"
+#include "ecs/TransformSystem.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <cmath>
+
+using namespace hgl;
+using namespace hgl::ecs;
+using namespace hgl::math;
+
+constexpr const int NODE_COUNT = 1000000;
+constexpr const int ROOT_COUNT = 256;               // 根节点数
+constexpr const int BRANCH = 4;                     // 每个节点的子节点数
+constexpr const int FRAME_COUNT = 20;
+constexpr const int MOVE_COUNT = 100;               // 每帧修改局部变换的节点数
+
+void PrintTime(const char* name, double seconds, uint32 updated)
+{
+    std::cout << "    " << std::setw(32) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+              << std::setw(10) << updated << " nodes" << std::endl;
+}
+
+// 与逐个节点沿父链重新相乘的结果比较，返回最大误差
+float Verify(FlatEntityTreeManager& tree, TransformSystem& system, ComponentPool<Transform>& transforms, const std::vector<EntityID>& entities, int sample)
+{
+    float max_error = 0;
+
+    for (int i = 0; i < int(entities.size()); i += int(entities.size()) / sample)
+    {
+        Matrix4f expect(1.0f);
+
+        for (EntityID id = entities[i]; id != ENTITY_ID_INVALID; id = tree.GetParent(id))
+            expect = transforms.Get(id)->GetMatrix() * expect;
+
+        const Matrix4f& world = *system.GetWorldMatrix(entities[i]);
+
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                max_error = std::max(max_error, std::fabs(world[c][r] - expect[c][r]));
+    }
+
+    return max_error;
+}
+
+int main()
+{
+    EntityPool pool;
+    FlatEntityTreeManager tree(&pool);
+    ComponentPool<Transform> transforms;
+
+    std::vector<EntityID> entities(NODE_COUNT);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+
+    // 节点i(i>=ROOT_COUNT)的父节点为(i-ROOT_COUNT)/BRANCH
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        entities[i] = pool.Create();
+
+        if (i < ROOT_COUNT)
+            tree.AddAsRoot(entities[i]);
+        else
+            tree.AddAsChild(entities[i], entities[(i - ROOT_COUNT) / BRANCH]);
+
+        Transform* t = transforms.Add(entities[i]);
+
+        t->SetTranslation(Vector3f(dis(rng), dis(rng), dis(rng)));
+        t->SetScale(Vector3f(1.0f, 1.0f, 1.0f));
+    }
+
+    TransformSystem system(&tree, &transforms);
+
+    std::cout << NODE_COUNT << " nodes, " << ROOT_COUNT << " roots" << std::endl;
+
+    auto RunFrames = [&](task::TaskExecutor* te)
+    {
+        system.MarkAllDirty();
+
+        double st = GetPreciseTime();
+        uint32 n = system.Update(te);
+
+        PrintTime("Full update", GetPreciseTime() - st, n);
+
+        // 静态场景：没有任何修改
+        st = GetPreciseTime();
+        n = 0;
+
+        for (int f = 0; f < FRAME_COUNT; ++f)
+            n += system.Update(te);
+
+        PrintTime("Static frame", (GetPreciseTime() - st) / FRAME_COUNT, n / FRAME_COUNT);
+
+        // 每帧修改少量随机节点，只重算它们的子树
+        std::mt19937 move_rng(2);
+        double total = 0;
+        n = 0;
+
+        for (int f = 0; f < FRAME_COUNT; ++f)
+        {
+            for (int i = 0; i < MOVE_COUNT; ++i)
+            {
+                Transform* t = system.EditLocal(entities[move_rng() % NODE_COUNT]);
+
+                t->SetTranslation(Vector3f(dis(move_rng), dis(move_rng), dis(move_rng)));
+            }
+
+            st = GetPreciseTime();
+            n += system.Update(te);
+            total += GetPreciseTime() - st;
+        }
+
+        PrintTime("Frame with 100 edits", total / FRAME_COUNT, n / FRAME_COUNT);
+
+        // 移动一个根：整棵子树重算
+        system.EditLocal(entities[0])->SetTranslation(Vector3f(5, 5, 5));
+
+        st = GetPreciseTime();
+        n = system.Update(te);
+
+        PrintTime("Root edit", GetPreciseTime() - st, n);
+
+        std::cout << "    Max error: " << std::scientific << std::setprecision(2)
+                  << Verify(tree, system, transforms, entities, 1000) << std::fixed << std::endl;
+    };
+
+    std::cout << "Serial" << std::endl;
+    RunFrames(nullptr);
+
+    task::TaskExecutor executor;
+
+    executor.Start();
+
+    std::cout << "Parallel (" << executor.GetComputeWorkerCount() << " compute workers)" << std::endl;
+    RunFrames(&executor);
+
+    executor.Stop();
+
+    // 结构变化后线性位置改变，下一次Update全部重算
+    for (int i = 0; i < MOVE_COUNT; ++i)
+        tree.SetParent(entities[ROOT_COUNT + rng() % (NODE_COUNT - ROOT_COUNT)], entities[rng() % ROOT_COUNT]);
+
+    const double st = GetPreciseTime();
+    const uint32 n = system.Update();
+
+    std::cout << "After " << MOVE_COUNT << " reparents" << std::endl;
+    PrintTime("Rebuild + full update", GetPreciseTime() - st, n);
+
+    std::cout << "    Max error: " << std::scientific << std::setprecision(2)
+              << Verify(tree, system, transforms, entities, 1000) << std::endl;
+
+    return 0;
+}
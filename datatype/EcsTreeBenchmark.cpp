@@ -0,0 +1,207 @@
+#include "ecs/EntityPool.h"
+#include "ecs/EntityTreeManager.h"
+#include "ecs/FlatEntityTreeManager.h"
+#include<hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace hgl;
+using namespace hgl::ecs;
+
+constexpr const int ROOT_COUNT = 64;                // 根节点数
+constexpr const int BRANCH = 4;                     // 每个节点的子节点数
+constexpr const int UPDATE_ROUNDS = 10;
+constexpr const int MOVE_COUNT = 1000;              // 每批移动的子树数
+
+struct Offset
+{
+    float x, y, z;
+};
+
+void PrintTime(const char* name, double seconds, int count)
+{
+    std::cout << "    " << std::setw(28) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+              << std::setw(10) << std::setprecision(2) << seconds * 1e9 / count << " ns/node" << std::endl;
+}
+
+// 节点i(i>=ROOT_COUNT)的父节点为(i-ROOT_COUNT)/BRANCH，得到ROOT_COUNT棵深度约为log4(N)的树
+int ParentOf(int i)
+{
+    return i < ROOT_COUNT ? -1 : (i - ROOT_COUNT) / BRANCH;
+}
+
+struct TreeUpdateData
+{
+    EntityTreeManager* tree;
+    const Offset* local;
+    Offset* world;
+};
+
+// 原有方式：深度优先遍历，每个节点经由Map查父节点
+void TreeUpdate(EntityID entity_id, void* user_data)
+{
+    TreeUpdateData* data = static_cast<TreeUpdateData*>(user_data);
+    const uint32 index = GetEntityIndex(entity_id);
+    const EntityID parent_id = data->tree->GetParent(entity_id);
+
+    Offset w = data->local[index];
+
+    if (parent_id != ENTITY_ID_INVALID)
+    {
+        const Offset& pw = data->world[GetEntityIndex(parent_id)];
+
+        w.x += pw.x;
+        w.y += pw.y;
+        w.z += pw.z;
+    }
+
+    data->world[index] = w;
+}
+
+double Checksum(const std::vector<Offset>& world)
+{
+    double sum = 0;
+
+    for (const Offset& w : world)
+        sum += w.x + w.y + w.z;
+
+    return sum;
+}
+
+void RunBenchmark(int node_count)
+{
+    std::cout << "\n=== " << node_count << " nodes ===" << std::endl;
+
+    EntityPool pool;
+    std::vector<EntityID> entities(node_count);
+    std::vector<Offset> local(node_count);
+
+    for (int i = 0; i < node_count; ++i)
+    {
+        entities[i] = pool.Create();
+        local[i] = Offset{float(i % 7), float(i % 5), 1.0f};
+    }
+
+    double tree_sum = 0, flat_sum = 0;
+
+    {
+        EntityTreeManager tree(&pool);
+        std::vector<Offset> world(node_count);
+
+        double st = GetPreciseTime();
+
+        for (int i = 0; i < node_count; ++i)
+        {
+            const int p = ParentOf(i);
+
+            if (p < 0)
+                tree.AddAsRoot(entities[i]);
+            else
+                tree.AddAsChild(entities[i], entities[p]);
+        }
+
+        PrintTime("EntityTreeManager build", GetPreciseTime() - st, node_count);
+
+        TreeUpdateData data{&tree, local.data(), world.data()};
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+            tree.Iterate(TreeUpdate, &data);
+
+        PrintTime("EntityTreeManager update", (GetPreciseTime() - st) / UPDATE_ROUNDS, node_count);
+
+        tree_sum = Checksum(world);
+    }
+
+    {
+        FlatEntityTreeManager tree(&pool);
+
+        double st = GetPreciseTime();
+
+        for (int i = 0; i < node_count; ++i)
+        {
+            const int p = ParentOf(i);
+
+            if (p < 0)
+                tree.AddAsRoot(entities[i]);
+            else
+                tree.AddAsChild(entities[i], entities[p]);
+        }
+
+        tree.UpdateOrder();
+
+        PrintTime("Flat build", GetPreciseTime() - st, node_count);
+
+        // 线性数组中父节点总在子节点之前，一次顺序遍历完成传播
+        std::vector<Offset> linear_world(node_count);
+
+        st = GetPreciseTime();
+
+        for (int r = 0; r < UPDATE_ROUNDS; ++r)
+        {
+            const uint32 count = tree.GetLinearCount();
+            const EntityID* ids = tree.GetLinearEntities();
+            const uint32* parents = tree.GetLinearParents();
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Offset w = local[GetEntityIndex(ids[i])];
+
+                if (parents[i] != FlatEntityTreeManager::NONE)
+                {
+                    const Offset& pw = linear_world[parents[i]];
+
+                    w.x += pw.x;
+                    w.y += pw.y;
+                    w.z += pw.z;
+                }
+
+                linear_world[i] = w;
+            }
+        }
+
+        PrintTime("Flat update", (GetPreciseTime() - st) / UPDATE_ROUNDS, node_count);
+
+        flat_sum = Checksum(linear_world);
+
+        // 批量移动子树：只改链接，之后统一重建一次线性数组
+        std::mt19937 rng(1);
+        int moved = 0;
+
+        st = GetPreciseTime();
+
+        for (int i = 0; i < MOVE_COUNT; ++i)
+        {
+            const int node = ROOT_COUNT + int(rng() % (node_count - ROOT_COUNT));
+            const int new_parent = int(rng() % node_count);
+
+            if (tree.SetParent(entities[node], entities[new_parent]))
+                ++moved;
+        }
+
+        const double link_time = GetPreciseTime() - st;
+
+        tree.UpdateOrder();
+
+        const double total_time = GetPreciseTime() - st;
+
+        std::cout << "    " << moved << " subtree moves: relink " << std::setprecision(3) << link_time * 1000.0
+                  << " ms, rebuild order " << (total_time - link_time) * 1000.0 << " ms" << std::endl;
+    }
+
+    std::cout << "    Checksum: " << std::setprecision(1) << tree_sum << " / " << flat_sum << std::endl;
+}
+
+int main()
+{
+    std::cout << "EntityTreeManager vs FlatEntityTreeManager, hierarchical offset propagation" << std::endl;
+
+    RunBenchmark(100000);
+    RunBenchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,615 @@
+#pragma once
+
+#include "ComponentType.h"
+#include<algorithm>
+#include<cstring>
+#include<map>
+#include<new>
+#include<tuple>
+#include<type_traits>
+#include<vector>
+
+namespace hgl::ecs
+{
+    class ArchetypeStorage;
+
+    namespace archetype_detail
+    {
+        template<typename... Ts> struct IsDistinct : std::true_type {};
+
+        template<typename T, typename... Ts>
+        struct IsDistinct<T, Ts...> : std::bool_constant<!(std::is_same_v<T, Ts> || ...) && IsDistinct<Ts...>::value> {};
+    }
+
+    /**
+     * CN: 原型：拥有完全相同组件集合的实体存放在一起
+     * EN: Archetype: entities with exactly the same component set are stored together
+     *
+     * CN: 数据按块(Chunk)存放，每块约16KB，块内为SoA布局：先是实体ID数组，之后每种组件一列。
+     *     同一块内的组件连续排列，遍历时按列线性读取。删除时用最后一行填补空洞，块始终紧密。
+     * EN: Data is stored in chunks of about 16KB with SoA layout inside: the entity ID array first,
+     *     then one column per component type. Columns are contiguous within a chunk and are
+     *     streamed linearly. Removal fills the hole with the last row so chunks stay dense.
+     */
+    class Archetype
+    {
+    public:
+
+        static constexpr uint32 CHUNK_BYTES = 16 * 1024;
+        static constexpr uint32 CHUNK_ALIGN = 64;               ///< CN: 列按此对齐，也是支持的最大组件对齐 / EN: Columns are aligned to this, also the largest supported component alignment
+
+        struct Chunk
+        {
+            uint8* memory;
+            uint32 count;           ///< CN: 已使用的行数 / EN: Rows in use
+        };
+
+    private:
+
+        std::vector<ComponentTypeID> types;                 ///< CN: 按编号排序的组件类型 / EN: Component types sorted by ID
+        std::vector<const ComponentTypeInfo*> infos;
+        std::vector<uint32> column_offset;                  ///< CN: 每列在块内的偏移 / EN: Offset of each column inside a chunk
+        uint32 capacity = 0;                                ///< CN: 每块的行数 / EN: Rows per chunk
+        uint32 chunk_bytes = 0;
+
+        std::vector<Chunk> chunks;
+        uint32 entity_count = 0;
+
+        std::map<ComponentTypeID, Archetype*> add_edge;     ///< CN: 加一个组件后到达的原型 / EN: Archetype reached by adding one component
+        std::map<ComponentTypeID, Archetype*> remove_edge;  ///< CN: 去掉一个组件后到达的原型 / EN: Archetype reached by removing one component
+
+        friend class ArchetypeStorage;
+
+        static uint32 AlignUp(uint32 value, uint32 align)
+        {
+            return (value + align - 1) / align * align;
+        }
+
+        uint32 Layout(uint32 rows)
+        {
+            uint32 offset = AlignUp(sizeof(EntityID) * rows, CHUNK_ALIGN);
+
+            column_offset.resize(infos.size());
+
+            for (size_t i = 0; i < infos.size(); ++i)
+            {
+                column_offset[i] = offset;
+                offset = AlignUp(offset + infos[i]->size * rows, CHUNK_ALIGN);
+            }
+
+            return offset;
+        }
+
+        Chunk& AllocRow(uint32& chunk_index, uint32& row)
+        {
+            if (chunks.empty() || chunks.back().count == capacity)
+                chunks.push_back(Chunk{static_cast<uint8*>(::operator new(chunk_bytes, std::align_val_t(CHUNK_ALIGN))), 0});
+
+            chunk_index = static_cast<uint32>(chunks.size() - 1);
+
+            Chunk& chunk = chunks.back();
+
+            row = chunk.count++;
+            ++entity_count;
+            return chunk;
+        }
+
+    public:
+
+        Archetype(const std::vector<const ComponentTypeInfo*>& type_infos)
+            : infos(type_infos)
+        {
+            std::sort(infos.begin(), infos.end(), [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) { return a->id < b->id; });
+
+            uint32 row_bytes = sizeof(EntityID);
+
+            for (const ComponentTypeInfo* info : infos)
+            {
+                types.push_back(info->id);
+                row_bytes += info->size;
+            }
+
+            capacity = CHUNK_BYTES / row_bytes;
+
+            if (capacity < 16)
+                capacity = 16;
+
+            // 对齐填充可能让块略超过CHUNK_BYTES，缩减行数直到放得下
+            while (capacity > 16 && Layout(capacity) > CHUNK_BYTES)
+                --capacity;
+
+            chunk_bytes = Layout(capacity);
+        }
+
+        ~Archetype()
+        {
+            for (Chunk& chunk : chunks)
+            {
+                for (size_t c = 0; c < infos.size(); ++c)
+                    for (uint32 r = 0; r < chunk.count; ++r)
+                        infos[c]->destroy(chunk.memory + column_offset[c] + r * infos[c]->size);
+
+                ::operator delete(chunk.memory, std::align_val_t(CHUNK_ALIGN));
+            }
+        }
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        const std::vector<ComponentTypeID>& GetTypes() const { return types; }
+        uint32 GetEntityCount() const { return entity_count; }
+        uint32 GetChunkCount() const { return static_cast<uint32>(chunks.size()); }
+        uint32 GetChunkCapacity() const { return capacity; }
+
+        /**
+         * CN: 获取组件类型所在的列，不存在返回-1
+         * EN: Get the column of a component type, -1 if absent
+         */
+        int FindColumn(ComponentTypeID type) const
+        {
+            auto it = std::lower_bound(types.begin(), types.end(), type);
+
+            return (it != types.end() && *it == type) ? static_cast<int>(it - types.begin()) : -1;
+        }
+
+        bool HasAll(const ComponentTypeID* ids, size_t count) const
+        {
+            for (size_t i = 0; i < count; ++i)
+                if (FindColumn(ids[i]) < 0)
+                    return false;
+
+            return true;
+        }
+
+        const Chunk& GetChunk(uint32 index) const { return chunks[index]; }
+
+        EntityID* GetEntities(uint32 chunk_index) const
+        {
+            return reinterpret_cast<EntityID*>(chunks[chunk_index].memory);
+        }
+
+        void* GetColumn(uint32 chunk_index, int column) const
+        {
+            return chunks[chunk_index].memory + column_offset[column];
+        }
+
+        template<typename T>
+        T* GetColumn(uint32 chunk_index) const
+        {
+            const int column = FindColumn(GetComponentTypeID<T>());
+
+            return column < 0 ? nullptr : static_cast<T*>(GetColumn(chunk_index, column));
+        }
+
+        void* GetComponent(uint32 chunk_index, uint32 row, int column) const
+        {
+            return chunks[chunk_index].memory + column_offset[column] + row * infos[column]->size;
+        }
+    };
+
+    /**
+     * CN: 原型式组件存储
+     * EN: Archetype-based component storage
+     *
+     * CN: 与每种组件一个ComponentPool的方式不同，这里按实体的组件集合分组存放，
+     *     同时查询多种组件(如Position与Velocity)时直接线性遍历匹配原型的块，不需要逐个实体查表。
+     *     代价是增删组件时实体要在原型之间搬移，适合组件集合相对稳定的实体。
+     * EN: Instead of one ComponentPool per component type, entities are grouped by their component set.
+     *     Queries over several components (e.g. Position and Velocity) stream linearly through the chunks
+     *     of matching archetypes with no per-entity lookup. The cost is moving an entity between archetypes
+     *     when components are added or removed, so it suits entities with a fairly stable component set.
+     */
+    class ArchetypeStorage
+    {
+        struct EntityLocation
+        {
+            Archetype* archetype = nullptr;
+            EntityID entity_id = ENTITY_ID_INVALID;         ///< CN: 完整ID，用于比较代数 / EN: Full ID, used to compare generations
+            uint32 chunk = 0;
+            uint32 row = 0;
+        };
+
+        std::map<std::vector<ComponentTypeID>, Archetype*> archetype_map;
+        std::vector<Archetype*> archetype_list;             ///< CN: 按创建顺序 / EN: In creation order
+
+        std::vector<EntityLocation> locations;              ///< CN: 按实体ID的槽位下标索引 / EN: Indexed by the slot index of the entity ID
+        uint32 entity_count = 0;
+
+    private:
+
+        EntityLocation* FindLocation(const EntityID entity_id)
+        {
+            const size_t index = GetEntityIndex(entity_id);
+
+            if (entity_id == ENTITY_ID_INVALID || index >= locations.size() || locations[index].entity_id != entity_id)
+                return nullptr;
+
+            return &locations[index];
+        }
+
+        const EntityLocation* FindLocation(const EntityID entity_id) const
+        {
+            return const_cast<ArchetypeStorage*>(this)->FindLocation(entity_id);
+        }
+
+        /**
+         * CN: 槽位是否空闲，仍被旧代实体占用时返回false
+         * EN: Whether the slot is free, false while an older generation still holds it
+         */
+        bool IsSlotFree(const EntityID entity_id) const
+        {
+            const size_t index = GetEntityIndex(entity_id);
+
+            return index >= locations.size() || !locations[index].archetype;
+        }
+
+        EntityLocation& GetOrCreateLocation(const EntityID entity_id)
+        {
+            const size_t index = GetEntityIndex(entity_id);
+
+            if (index >= locations.size())
+                locations.resize(std::max(index + 1, locations.size() * 2));
+
+            return locations[index];
+        }
+
+        Archetype* GetArchetype(std::vector<const ComponentTypeInfo*> infos)
+        {
+            std::sort(infos.begin(), infos.end(), [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) { return a->id < b->id; });
+            infos.erase(std::unique(infos.begin(), infos.end()), infos.end());
+
+            std::vector<ComponentTypeID> key;
+
+            for (const ComponentTypeInfo* info : infos)
+                key.push_back(info->id);
+
+            auto it = archetype_map.find(key);
+
+            if (it != archetype_map.end())
+                return it->second;
+
+            Archetype* archetype = new Archetype(infos);
+
+            archetype_map.emplace(key, archetype);
+            archetype_list.push_back(archetype);
+            return archetype;
+        }
+
+        Archetype* GetAddTarget(Archetype* from, const ComponentTypeInfo& info)
+        {
+            auto it = from->add_edge.find(info.id);
+
+            if (it != from->add_edge.end())
+                return it->second;
+
+            std::vector<const ComponentTypeInfo*> infos = from->infos;
+            infos.push_back(&info);
+
+            Archetype* to = GetArchetype(infos);
+
+            from->add_edge[info.id] = to;
+            to->remove_edge[info.id] = from;
+            return to;
+        }
+
+        Archetype* GetRemoveTarget(Archetype* from, ComponentTypeID type)
+        {
+            auto it = from->remove_edge.find(type);
+
+            if (it != from->remove_edge.end())
+                return it->second;
+
+            std::vector<const ComponentTypeInfo*> infos;
+
+            for (const ComponentTypeInfo* info : from->infos)
+                if (info->id != type)
+                    infos.push_back(info);
+
+            Archetype* to = GetArchetype(infos);
+
+            from->remove_edge[type] = to;
+            to->add_edge[type] = from;
+            return to;
+        }
+
+        /**
+         * CN: 删除一行，用最后一行填补；destroy为false时该行的组件已被移走
+         * EN: Remove one row and fill it with the last row; when destroy is false its components were already moved out
+         */
+        void RemoveRow(Archetype* archetype, uint32 chunk_index, uint32 row, bool destroy)
+        {
+            const size_t column_count = archetype->infos.size();
+
+            if (destroy)
+                for (size_t c = 0; c < column_count; ++c)
+                    archetype->infos[c]->destroy(archetype->GetComponent(chunk_index, row, int(c)));
+
+            const uint32 last_chunk = static_cast<uint32>(archetype->chunks.size() - 1);
+            const uint32 last_row = archetype->chunks[last_chunk].count - 1;
+
+            if (last_chunk != chunk_index || last_row != row)
+            {
+                for (size_t c = 0; c < column_count; ++c)
+                    archetype->infos[c]->move(archetype->GetComponent(chunk_index, row, int(c)),
+                                              archetype->GetComponent(last_chunk, last_row, int(c)));
+
+                const EntityID moved = archetype->GetEntities(last_chunk)[last_row];
+
+                archetype->GetEntities(chunk_index)[row] = moved;
+
+                EntityLocation& loc = locations[GetEntityIndex(moved)];
+                loc.chunk = chunk_index;
+                loc.row = row;
+            }
+
+            Archetype::Chunk& chunk = archetype->chunks[last_chunk];
+
+            if (--chunk.count == 0)
+            {
+                ::operator delete(chunk.memory, std::align_val_t(Archetype::CHUNK_ALIGN));
+                archetype->chunks.pop_back();
+            }
+
+            --archetype->entity_count;
+        }
+
+        /**
+         * CN: 把实体搬到另一个原型，两边都有的组件移动过去，源原型独有的组件被析构
+         * EN: Move an entity to another archetype; shared components are moved, components only in the source are destroyed
+         */
+        void MoveEntity(const EntityID entity_id, EntityLocation& loc, Archetype* to)
+        {
+            Archetype* from = loc.archetype;
+            uint32 chunk_index, row;
+
+            to->AllocRow(chunk_index, row);
+            to->GetEntities(chunk_index)[row] = entity_id;
+
+            for (size_t c = 0; c < from->infos.size(); ++c)
+            {
+                void* src = from->GetComponent(loc.chunk, loc.row, int(c));
+                const int dst_column = to->FindColumn(from->types[c]);
+
+                if (dst_column >= 0)
+                    from->infos[c]->move(to->GetComponent(chunk_index, row, dst_column), src);
+                else
+                    from->infos[c]->destroy(src);
+            }
+
+            RemoveRow(from, loc.chunk, loc.row, false);
+
+            loc.archetype = to;
+            loc.chunk = chunk_index;
+            loc.row = row;
+        }
+
+        template<typename T>
+        static void ConstructFrom(void* dst, T&& value)
+        {
+            new(dst) std::decay_t<T>(std::forward<T>(value));
+        }
+
+        template<typename... Ts, size_t... I, typename F>
+        static void ForEachRows(Archetype* archetype, const int* columns, F& func, std::index_sequence<I...>)
+        {
+            for (uint32 c = 0; c < archetype->GetChunkCount(); ++c)
+            {
+                const uint32 count = archetype->chunks[c].count;
+                const EntityID* entities = archetype->GetEntities(c);
+                std::tuple<Ts*...> cols(static_cast<Ts*>(archetype->GetColumn(c, columns[I]))...);
+
+                for (uint32 r = 0; r < count; ++r)
+                    func(entities[r], std::get<I>(cols)[r]...);
+            }
+        }
+
+        template<typename... Ts, size_t... I, typename F>
+        static void ForEachChunks(Archetype* archetype, const int* columns, F& func, std::index_sequence<I...>)
+        {
+            for (uint32 c = 0; c < archetype->GetChunkCount(); ++c)
+                func(archetype->chunks[c].count, archetype->GetEntities(c), static_cast<Ts*>(archetype->GetColumn(c, columns[I]))...);
+        }
+
+    public:
+
+        ArchetypeStorage() = default;
+
+        ~ArchetypeStorage()
+        {
+            Clear();
+        }
+
+        ArchetypeStorage(const ArchetypeStorage&) = delete;
+        ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+        /**
+         * CN: 一次性以一组组件加入实体，直接放进最终原型，不经过中间原型。每种组件类型只能出现一次
+         * EN: Add an entity with a set of components at once, placed directly into its final archetype. Each component type may appear only once
+         * @return CN: 实体已存在或槽位仍被旧代实体占用返回false / EN: Returns false if the entity exists or an older generation still holds the slot
+         */
+        template<typename... Ts>
+        bool AddEntity(const EntityID entity_id, Ts&&... components)
+        {
+            static_assert(archetype_detail::IsDistinct<std::decay_t<Ts>...>::value, "AddEntity: duplicate component type");
+            static_assert(((alignof(std::decay_t<Ts>) <= Archetype::CHUNK_ALIGN) && ...), "component alignment exceeds Archetype::CHUNK_ALIGN");
+
+            if (entity_id == ENTITY_ID_INVALID || !IsSlotFree(entity_id))
+                return false;
+
+            Archetype* archetype = GetArchetype({&GetComponentTypeInfo<std::decay_t<Ts>>()...});
+            uint32 chunk_index, row;
+
+            archetype->AllocRow(chunk_index, row);
+            archetype->GetEntities(chunk_index)[row] = entity_id;
+
+            (ConstructFrom(archetype->GetComponent(chunk_index, row, archetype->FindColumn(GetComponentTypeID<std::decay_t<Ts>>())),
+                           std::forward<Ts>(components)), ...);
+
+            EntityLocation& loc = GetOrCreateLocation(entity_id);
+
+            loc.archetype = archetype;
+            loc.entity_id = entity_id;
+            loc.chunk = chunk_index;
+            loc.row = row;
+
+            ++entity_count;
+            return true;
+        }
+
+        /**
+         * CN: 移除实体及其所有组件
+         * EN: Remove an entity and all of its components
+         */
+        bool RemoveEntity(const EntityID entity_id)
+        {
+            EntityLocation* loc = FindLocation(entity_id);
+
+            if (!loc)
+                return false;
+
+            RemoveRow(loc->archetype, loc->chunk, loc->row, true);
+
+            *loc = EntityLocation();
+            --entity_count;
+            return true;
+        }
+
+        bool Contains(const EntityID entity_id) const
+        {
+            return FindLocation(entity_id) != nullptr;
+        }
+
+        /**
+         * CN: 为实体添加组件，实体会被搬到新的原型；实体不存在时新建
+         * EN: Add a component to an entity, which moves it to a new archetype; creates the entity if absent
+         * @return CN: 返回组件指针，已有该组件返回nullptr / EN: Returns the component pointer, or nullptr if it already has one
+         */
+        template<typename T>
+        T* Add(const EntityID entity_id, const T& component = T())
+        {
+            static_assert(alignof(T) <= Archetype::CHUNK_ALIGN, "component alignment exceeds Archetype::CHUNK_ALIGN");
+
+            EntityLocation* loc = FindLocation(entity_id);
+
+            if (!loc)
+                return AddEntity(entity_id, component) ? Get<T>(entity_id) : nullptr;
+
+            const ComponentTypeInfo& info = GetComponentTypeInfo<T>();
+
+            if (loc->archetype->FindColumn(info.id) >= 0)
+                return nullptr;
+
+            MoveEntity(entity_id, *loc, GetAddTarget(loc->archetype, info));
+
+            T* result = static_cast<T*>(loc->archetype->GetComponent(loc->chunk, loc->row, loc->archetype->FindColumn(info.id)));
+
+            new(result) T(component);
+            return result;
+        }
+
+        /**
+         * CN: 移除实体的一个组件，没有组件后实体仍保留在空原型中
+         * EN: Remove one component of an entity, the entity stays in the empty archetype once it has no components
+         */
+        template<typename T>
+        bool Remove(const EntityID entity_id)
+        {
+            EntityLocation* loc = FindLocation(entity_id);
+            const ComponentTypeID type = GetComponentTypeID<T>();
+
+            if (!loc || loc->archetype->FindColumn(type) < 0)
+                return false;
+
+            MoveEntity(entity_id, *loc, GetRemoveTarget(loc->archetype, type));
+            return true;
+        }
+
+        template<typename T>
+        T* Get(const EntityID entity_id)
+        {
+            EntityLocation* loc = FindLocation(entity_id);
+
+            if (!loc)
+                return nullptr;
+
+            const int column = loc->archetype->FindColumn(GetComponentTypeID<T>());
+
+            return column < 0 ? nullptr : static_cast<T*>(loc->archetype->GetComponent(loc->chunk, loc->row, column));
+        }
+
+        template<typename T>
+        const T* Get(const EntityID entity_id) const
+        {
+            return const_cast<ArchetypeStorage*>(this)->Get<T>(entity_id);
+        }
+
+        template<typename T>
+        bool Has(const EntityID entity_id) const
+        {
+            const EntityLocation* loc = FindLocation(entity_id);
+
+            return loc && loc->archetype->FindColumn(GetComponentTypeID<T>()) >= 0;
+        }
+
+        int GetEntityCount() const { return static_cast<int>(entity_count); }
+        int GetArchetypeCount() const { return static_cast<int>(archetype_list.size()); }
+
+        const std::vector<Archetype*>& GetArchetypes() const { return archetype_list; }
+
+        /**
+         * CN: 遍历拥有全部Ts组件的实体，func(EntityID, Ts&...)，可被内联
+         * EN: Iterate entities owning all Ts components, func(EntityID, Ts&...), inlinable
+         */
+        template<typename... Ts, typename F>
+        void ForEach(F&& func)
+        {
+            const ComponentTypeID ids[] = {GetComponentTypeID<Ts>()...};
+
+            for (Archetype* archetype : archetype_list)
+            {
+                if (archetype->GetEntityCount() == 0 || !archetype->HasAll(ids, sizeof...(Ts)))
+                    continue;
+
+                const int columns[] = {archetype->FindColumn(GetComponentTypeID<Ts>())...};
+
+                ForEachRows<Ts...>(archetype, columns, func, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        /**
+         * CN: 按块遍历，func(uint32 count, const EntityID*, Ts*...)，每列都是连续数组，便于向量化
+         * EN: Iterate by chunk, func(uint32 count, const EntityID*, Ts*...), every column is a contiguous array for vectorization
+         */
+        template<typename... Ts, typename F>
+        void ForEachChunk(F&& func)
+        {
+            const ComponentTypeID ids[] = {GetComponentTypeID<Ts>()...};
+
+            for (Archetype* archetype : archetype_list)
+            {
+                if (archetype->GetEntityCount() == 0 || !archetype->HasAll(ids, sizeof...(Ts)))
+                    continue;
+
+                const int columns[] = {archetype->FindColumn(GetComponentTypeID<Ts>())...};
+
+                ForEachChunks<Ts...>(archetype, columns, func, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        /**
+         * CN: 清空所有实体与原型
+         * EN: Clear all entities and archetypes
+         */
+        void Clear()
+        {
+            for (Archetype* archetype : archetype_list)
+                delete archetype;
+
+            archetype_list.clear();
+            archetype_map.clear();
+            locations.clear();
+            entity_count = 0;
+        }
+    };
+
+} // namespace hgl::ecs
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "EntityPool.h"
+#include<atomic>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 全局变更计数。写入组件时记录当前计数，查询时与上次运行时的计数比较，大于即为之后发生的变化。
+     *     计数从1开始，0表示"从未运行"，此时所有组件都算作新增/修改过。
+     *     SystemRegistry在每层开始前、命令回放前与Run结束时推进，同一层的系统互不冲突，所以不会漏掉同一计数内的写入；
+     *     系统运行期间的写入与系统记录的计数相同，不会被自己下一次运行看到。
+     * EN: Global change tick. Component writes record the current tick, queries compare it with the tick of their
+     *     previous run; anything greater happened afterwards. Ticks start at 1, 0 means "never ran" so every
+     *     component counts as added/changed.
+     *     SystemRegistry advances it before every stage, before command playback and at the end of Run; systems in
+     *     one stage never conflict, so no write within the same tick is missed. Writes made while a system runs share
+     *     the tick it records, so its own next run does not see them.
+     */
+    namespace change_detail
+    {
+        inline std::atomic<uint32>& TickCounter()
+        {
+            static std::atomic<uint32> tick{1};
+            return tick;
+        }
+    }
+
+    inline uint32 GetChangeTick()
+    {
+        return change_detail::TickCounter().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * CN: 推进变更计数，返回新的计数
+     * EN: Advance the change tick, returns the new tick
+     */
+    inline uint32 AdvanceChangeTick()
+    {
+        return change_detail::TickCounter().fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /**
+     * CN: 查询过滤器：组件在给定计数之后被添加 / 被修改（添加也算修改）
+     * EN: Query filters: the component was added / changed (adding counts as a change) after the given tick
+     */
+    template<typename T> struct Added {};
+    template<typename T> struct Changed {};
+
+    /**
+     * CN: 紧密数组的变更计数表
+     * EN: Change tick table of a dense array
+     *
+     * CN: 每个元素记录添加与最后修改的计数，另外每CHUNK_SIZE个元素为一块，记录块内最大的添加/修改计数与最后一次删除的计数。
+     *     查询先看块计数，未变化的块整块跳过，再逐个元素精确比较。
+     *     删除时最后一个元素移入空位，连同它的计数一起移动，并抬高空位所在块的计数，块计数始终不小于块内元素的计数。
+     *     块计数是原子量，不同线程写入同一块的不同元素是安全的。
+     * EN: Every element records the tick it was added and last changed at. Every CHUNK_SIZE elements form a chunk
+     *     recording the largest added/changed tick inside and the tick of the last removal.
+     *     Queries check the chunk ticks first and skip unchanged chunks whole, then compare elements exactly.
+     *     On removal the last element moves into the hole together with its ticks and raises the ticks of the hole's
+     *     chunk, so chunk ticks never fall below the ticks of their elements.
+     *     Chunk ticks are atomics, different threads may write different elements of one chunk.
+     */
+    class ChangeTickTable
+    {
+    public:
+
+        static constexpr uint32 CHUNK_BITS = 8;
+        static constexpr uint32 CHUNK_SIZE = 1u << CHUNK_BITS;
+
+        struct ChunkTicks
+        {
+            std::atomic<uint32> added{0};
+            std::atomic<uint32> changed{0};
+            std::atomic<uint32> removed{0};
+
+            ChunkTicks() = default;
+
+            ChunkTicks(const ChunkTicks& other)
+                : added(other.added.load(std::memory_order_relaxed))
+                , changed(other.changed.load(std::memory_order_relaxed))
+                , removed(other.removed.load(std::memory_order_relaxed))
+            {
+            }
+        };
+
+    private:
+
+        std::vector<uint32> added_list;
+        std::vector<uint32> changed_list;
+        std::vector<ChunkTicks> chunk_list;
+        uint32 removed_tick = 0;                        ///< CN: 整个数组最后一次删除 / EN: Last removal anywhere in the array
+
+        static void Raise(std::atomic<uint32>& value, uint32 tick)
+        {
+            if (value.load(std::memory_order_relaxed) < tick)
+                value.store(tick, std::memory_order_relaxed);
+        }
+
+    public:
+
+        void OnAdd(uint32 index)
+        {
+            const uint32 tick = GetChangeTick();
+
+            added_list.push_back(tick);
+            changed_list.push_back(tick);
+
+            if ((index >> CHUNK_BITS) >= chunk_list.size())
+                chunk_list.emplace_back();
+
+            ChunkTicks& chunk = chunk_list[index >> CHUNK_BITS];
+
+            Raise(chunk.added, tick);
+            Raise(chunk.changed, tick);
+        }
+
+        void OnChange(uint32 index)
+        {
+            const uint32 tick = GetChangeTick();
+
+            changed_list[index] = tick;
+            Raise(chunk_list[index >> CHUNK_BITS].changed, tick);
+        }
+
+        /**
+         * CN: index被删除，last（最后一个元素）移入index
+         * EN: index was removed and last (the final element) moved into it
+         */
+        void OnRemove(uint32 index, uint32 last)
+        {
+            const uint32 tick = GetChangeTick();
+            ChunkTicks& chunk = chunk_list[index >> CHUNK_BITS];
+
+            if (index != last)
+            {
+                added_list[index] = added_list[last];
+                changed_list[index] = changed_list[last];
+
+                Raise(chunk.added, added_list[index]);
+                Raise(chunk.changed, changed_list[index]);
+            }
+
+            Raise(chunk.removed, tick);
+            removed_tick = tick;
+
+            added_list.pop_back();
+            changed_list.pop_back();
+
+            if (chunk_list.size() > (added_list.size() + CHUNK_SIZE - 1) >> CHUNK_BITS)
+                chunk_list.pop_back();
+        }
+
+        /**
+         * CN: 整体替换为count个刚添加的元素
+         * EN: Replace everything with count freshly added elements
+         */
+        void Assign(uint32 count)
+        {
+            const uint32 tick = GetChangeTick();
+
+            if (!added_list.empty())
+                removed_tick = tick;
+
+            added_list.assign(count, tick);
+            changed_list.assign(count, tick);
+            chunk_list.clear();
+            chunk_list.resize((count + CHUNK_SIZE - 1) >> CHUNK_BITS);
+
+            for (ChunkTicks& chunk : chunk_list)
+            {
+                chunk.added.store(tick, std::memory_order_relaxed);
+                chunk.changed.store(tick, std::memory_order_relaxed);
+            }
+        }
+
+        void Clear()
+        {
+            Assign(0);
+        }
+
+        void Reserve(uint32 count)
+        {
+            added_list.reserve(count);
+            changed_list.reserve(count);
+        }
+
+        void Shrink()
+        {
+            added_list.shrink_to_fit();
+            changed_list.shrink_to_fit();
+            chunk_list.shrink_to_fit();
+        }
+
+        uint32 GetAddedTick(uint32 index) const { return added_list[index]; }
+        uint32 GetChangedTick(uint32 index) const { return changed_list[index]; }
+        uint32 GetRemovedTick() const { return removed_tick; }
+
+        uint32 GetChunkCount() const { return static_cast<uint32>(chunk_list.size()); }
+        const ChunkTicks& GetChunk(uint32 chunk) const { return chunk_list[chunk]; }
+
+        bool IsAddedSince(uint32 index, uint32 since) const { return added_list[index] > since; }
+        bool IsChangedSince(uint32 index, uint32 since) const { return changed_list[index] > since; }
+
+        bool IsChunkAddedSince(uint32 chunk, uint32 since) const { return chunk_list[chunk].added.load(std::memory_order_relaxed) > since; }
+        bool IsChunkChangedSince(uint32 chunk, uint32 since) const { return chunk_list[chunk].changed.load(std::memory_order_relaxed) > since; }
+        bool IsChunkRemovedSince(uint32 chunk, uint32 since) const { return chunk_list[chunk].removed.load(std::memory_order_relaxed) > since; }
+    };
+
+} // namespace hgl::ecs
@@ -0,0 +1,434 @@
+#pragma once
+
+#include "EntityPool.h"
+#include "ComponentPool.h"
+#include "ComponentType.h"
+#include<algorithm>
+#include<new>
+#include<type_traits>
+#include<utility>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 延迟命令的类型
+     * EN: Deferred command type
+     */
+    enum class CommandType : uint8
+    {
+        Create,
+        Destroy,
+        Add,
+        Remove
+    };
+
+    /**
+     * CN: 尚未创建的实体，回放时才得到真正的EntityID
+     * EN: Entity that is not created yet, it gets a real EntityID during playback
+     */
+    struct PendingEntity
+    {
+        uint32 index;                                   ///< CN: 在所属命令缓冲区中的创建序号 / EN: Creation index inside its command buffer
+    };
+
+    /**
+     * CN: 组件池集合：按组件类型编号登记组件池，供命令回放时以类型擦除的方式增删组件
+     * EN: Component pool set: pools registered by component type ID, used by playback to add/remove components type-erased
+     */
+    class ComponentPoolSet
+    {
+    public:
+
+        struct PoolOps
+        {
+            void* pool = nullptr;
+            void (*add)(void* pool, EntityID entity_id, void* value) = nullptr;    ///< CN: 添加或替换，value被移走 / EN: Add or replace, value is moved from
+            bool (*remove)(void* pool, EntityID entity_id) = nullptr;
+        };
+
+    private:
+
+        std::vector<PoolOps> ops_list;                  ///< CN: 以ComponentTypeID为下标 / EN: Indexed by ComponentTypeID
+        std::vector<ComponentTypeID> type_list;         ///< CN: 已登记的类型 / EN: Registered types
+
+        template<typename P, typename T>
+        static void AddTo(void* pool, EntityID entity_id, void* value)
+        {
+            P* p = static_cast<P*>(pool);
+            T* component = p->Edit(entity_id);
+
+            if (!component)
+                component = p->Add(entity_id);
+
+            if (component)
+                *component = std::move(*static_cast<T*>(value));
+        }
+
+        template<typename P>
+        static bool RemoveFrom(void* pool, EntityID entity_id)
+        {
+            return static_cast<P*>(pool)->Remove(entity_id);
+        }
+
+    public:
+
+        template<typename T, ComponentStorageType S>
+        void Register(ComponentPool<T, S>& pool)
+        {
+            const ComponentTypeID id = GetComponentTypeID<T>();
+
+            if (id >= ops_list.size())
+                ops_list.resize(id + 1);
+
+            if (!ops_list[id].pool)
+                type_list.push_back(id);
+
+            ops_list[id] = {&pool, &AddTo<ComponentPool<T, S>, T>, &RemoveFrom<ComponentPool<T, S>>};
+        }
+
+        const PoolOps* Find(ComponentTypeID id) const
+        {
+            return (id < ops_list.size() && ops_list[id].pool) ? &ops_list[id] : nullptr;
+        }
+
+        /**
+         * CN: 从所有登记的池中移除实体的组件
+         * EN: Remove the entity's components from every registered pool
+         */
+        void RemoveAll(EntityID entity_id) const
+        {
+            for (ComponentTypeID id : type_list)
+                ops_list[id].remove(ops_list[id].pool, entity_id);
+        }
+    };
+
+    class CommandQueue;
+
+    /**
+     * CN: 命令缓冲区：记录创建/销毁实体与增删组件，遍历期间或并行系统中使用，在同步点统一回放
+     * EN: Command buffer: records entity create/destroy and component add/remove while iterating or inside
+     *     parallel systems, played back together at a sync point
+     *
+     * CN: 组件值移动到缓冲区自带的分块内存中，回放时再移入组件池。一个缓冲区只能由一个线程写入。
+     * EN: Component values are moved into block memory owned by the buffer and moved into pools on playback.
+     *     A buffer must only be written by one thread.
+     */
+    class CommandBuffer
+    {
+        static constexpr uint32 BLOCK_BYTES = 16 * 1024;
+        static constexpr uint32 BLOCK_ALIGN = 64;           ///< CN: 支持的最大组件对齐 / EN: Largest supported component alignment
+        static constexpr uint32 NO_PENDING = 0xFFFFFFFF;
+
+        struct Command
+        {
+            CommandType type;
+            ComponentTypeID component;
+            EntityID entity;
+            uint32 pending;                             ///< CN: 目标为PendingEntity时的创建序号 / EN: Creation index when targeting a PendingEntity
+            void* value;                                ///< CN: Add的组件值 / EN: Component value of Add
+            const ComponentTypeInfo* info;
+        };
+
+        struct Block
+        {
+            uint8* memory;
+            uint32 size;
+        };
+
+        std::vector<Command> command_list;
+        uint32 create_count = 0;
+        std::vector<EntityID> created_list;             ///< CN: 上次回放创建的实体 / EN: Entities created by the last playback
+
+        std::vector<Block> block_list;
+        uint32 block_index = 0;
+        uint32 block_used = 0;
+
+        friend class CommandQueue;
+
+        void* Alloc(uint32 size, uint32 align)
+        {
+            while (block_index < block_list.size())
+            {
+                const uint32 offset = (block_used + align - 1) & ~(align - 1);
+
+                if (offset + size <= block_list[block_index].size)
+                {
+                    block_used = offset + size;
+                    return block_list[block_index].memory + offset;
+                }
+
+                ++block_index;
+                block_used = 0;
+            }
+
+            const uint32 block_size = std::max(BLOCK_BYTES, size + align);
+
+            block_list.push_back({static_cast<uint8*>(::operator new(block_size, std::align_val_t(BLOCK_ALIGN))), block_size});
+            block_index = static_cast<uint32>(block_list.size() - 1);
+            block_used = 0;
+
+            return Alloc(size, align);
+        }
+
+        template<typename T>
+        void PushAdd(EntityID entity_id, uint32 pending, T&& value)
+        {
+            using U = std::decay_t<T>;
+
+            static_assert(alignof(U) <= BLOCK_ALIGN, "component alignment exceeds CommandBuffer::BLOCK_ALIGN");
+
+            const ComponentTypeInfo& info = GetComponentTypeInfo<U>();
+            void* memory = Alloc(info.size, info.align);
+
+            new(memory) U(std::forward<T>(value));
+
+            command_list.push_back({CommandType::Add, info.id, entity_id, pending, memory, &info});
+        }
+
+    public:
+
+        CommandBuffer() = default;
+
+        ~CommandBuffer()
+        {
+            Clear();
+
+            for (const Block& block : block_list)
+                ::operator delete(block.memory, std::align_val_t(BLOCK_ALIGN));
+        }
+
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        /**
+         * CN: 延迟创建实体，返回的PendingEntity可用于后续Add
+         * EN: Create an entity later, the returned PendingEntity can be used by following Add calls
+         */
+        PendingEntity Create()
+        {
+            command_list.push_back({CommandType::Create, COMPONENT_TYPE_INVALID, ENTITY_ID_INVALID, create_count, nullptr, nullptr});
+            return PendingEntity{create_count++};
+        }
+
+        void Destroy(EntityID entity_id)
+        {
+            command_list.push_back({CommandType::Destroy, COMPONENT_TYPE_INVALID, entity_id, NO_PENDING, nullptr, nullptr});
+        }
+
+        /**
+         * CN: 延迟添加组件，已存在时替换
+         * EN: Add a component later, replaces an existing one
+         */
+        template<typename T>
+        void Add(EntityID entity_id, T&& value)
+        {
+            PushAdd(entity_id, NO_PENDING, std::forward<T>(value));
+        }
+
+        template<typename T>
+        void Add(PendingEntity entity, T&& value)
+        {
+            PushAdd(ENTITY_ID_INVALID, entity.index, std::forward<T>(value));
+        }
+
+        template<typename T>
+        void Remove(EntityID entity_id)
+        {
+            command_list.push_back({CommandType::Remove, GetComponentTypeID<T>(), entity_id, NO_PENDING, nullptr, nullptr});
+        }
+
+        int GetCount() const { return static_cast<int>(command_list.size()); }
+        bool IsEmpty() const { return command_list.empty(); }
+
+        /**
+         * CN: 上次回放时创建的实体，下标即PendingEntity::index
+         * EN: Entities created by the last playback, indexed by PendingEntity::index
+         */
+        const std::vector<EntityID>& GetCreated() const { return created_list; }
+
+        /**
+         * CN: 丢弃所有命令，保留分块内存供下次使用
+         * EN: Drop all commands, keeping the block memory for reuse
+         */
+        void Clear()
+        {
+            for (const Command& cmd : command_list)
+                if (cmd.value)
+                    cmd.info->destroy(cmd.value);
+
+            command_list.clear();
+            create_count = 0;
+            block_index = 0;
+            block_used = 0;
+        }
+    };
+
+    /**
+     * CN: 命令队列：每个线程一个命令缓冲区，在同步点一次回放
+     * EN: Command queue: one command buffer per thread, played back at a sync point in one pass
+     *
+     * CN: 回放顺序：先按缓冲区顺序创建实体；再把所有Add/Remove按组件类型稳定排序，逐个池批量应用，
+     *     同一个池的命令连续执行，同一实体的命令保持记录顺序；最后销毁实体（并从所有登记的池中移除其组件）。
+     *     目标实体已失效，或在同一缓冲区中先被Destroy的Add/Remove被丢弃，不会给失效ID（或复用槽位的新实体）添加组件。
+     * EN: Playback order: entities are created first in buffer order; then every Add/Remove is stable-sorted
+     *     by component type and applied pool by pool, so commands of one pool run back to back and commands on
+     *     one entity keep their recorded order; entities are destroyed last (with their components in every
+     *     registered pool).
+     *     Add/Remove whose target is stale, or was destroyed earlier in the same buffer, are dropped, so no
+     *     component is ever attached to a dead ID (or to a new entity reusing its slot).
+     */
+    class CommandQueue
+    {
+        struct CommandRef
+        {
+            ComponentTypeID component;
+            uint32 buffer;
+            uint32 index;
+        };
+
+        std::vector<CommandBuffer*> buffer_list;
+        std::vector<CommandRef> ref_list;
+        std::vector<uint32> destroy_mark;               ///< CN: 按实体下标，在哪个缓冲区(序号+1)中已记录Destroy / EN: Per entity index, buffer (index + 1) that recorded a Destroy so far
+
+    public:
+
+        CommandQueue(uint32 thread_count = 1)
+        {
+            Resize(thread_count);
+        }
+
+        ~CommandQueue()
+        {
+            for (CommandBuffer* buffer : buffer_list)
+                delete buffer;
+        }
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        /**
+         * CN: 调整缓冲区数量，只增不减，不可在记录命令期间调用
+         * EN: Grow the number of buffers, never shrinks, must not be called while commands are recorded
+         */
+        void Resize(uint32 thread_count)
+        {
+            while (buffer_list.size() < thread_count)
+                buffer_list.push_back(new CommandBuffer);
+        }
+
+        uint32 GetBufferCount() const { return static_cast<uint32>(buffer_list.size()); }
+
+        CommandBuffer& Get(uint32 thread_index) { return *buffer_list[thread_index]; }
+
+        bool IsEmpty() const
+        {
+            for (const CommandBuffer* buffer : buffer_list)
+                if (!buffer->IsEmpty())
+                    return false;
+
+            return true;
+        }
+
+        /**
+         * CN: 回放并清空所有缓冲区，未登记池的组件命令与目标已失效的组件命令被丢弃
+         * EN: Play back and clear every buffer, component commands for unregistered pools or dead targets are dropped
+         * @return CN: 执行的命令数 / EN: Number of commands applied
+         */
+        int Playback(EntityPool& entity_pool, const ComponentPoolSet& pools)
+        {
+            int applied = 0;
+
+            ref_list.clear();
+
+            uint32 capacity = entity_pool.GetCapacity();
+
+            for (const CommandBuffer* buffer : buffer_list)
+                capacity += buffer->create_count;
+
+            if (destroy_mark.size() < capacity)
+                destroy_mark.resize(capacity, 0);
+
+            for (uint32 b = 0; b < buffer_list.size(); ++b)
+            {
+                CommandBuffer* buffer = buffer_list[b];
+
+                buffer->created_list.clear();
+
+                for (uint32 i = 0; i < buffer->command_list.size(); ++i)
+                {
+                    const CommandBuffer::Command& cmd = buffer->command_list[i];
+
+                    if (cmd.type == CommandType::Create)
+                    {
+                        buffer->created_list.push_back(entity_pool.Create());
+                        ++applied;
+                    }
+                    else if (cmd.type == CommandType::Destroy)
+                    {
+                        if (entity_pool.Contains(cmd.entity))
+                            destroy_mark[GetEntityIndex(cmd.entity)] = b + 1;
+                    }
+                    else if (cmd.pending < buffer->created_list.size())
+                    {
+                        ref_list.push_back({cmd.component, b, i});
+                    }
+                    else if (entity_pool.Contains(cmd.entity) && destroy_mark[GetEntityIndex(cmd.entity)] != b + 1)
+                    {
+                        ref_list.push_back({cmd.component, b, i});
+                    }
+                }
+            }
+
+            std::stable_sort(ref_list.begin(), ref_list.end(),
+                             [](const CommandRef& a, const CommandRef& b) { return a.component < b.component; });
+
+            const ComponentPoolSet::PoolOps* ops = nullptr;
+            ComponentTypeID ops_type = COMPONENT_TYPE_INVALID;
+
+            for (const CommandRef& ref : ref_list)
+            {
+                if (ref.component != ops_type)
+                {
+                    ops_type = ref.component;
+                    ops = pools.Find(ops_type);
+                }
+
+                if (!ops)
+                    continue;
+
+                const CommandBuffer* buffer = buffer_list[ref.buffer];
+                const CommandBuffer::Command& cmd = buffer->command_list[ref.index];
+                const EntityID entity_id = cmd.pending < buffer->created_list.size() ? buffer->created_list[cmd.pending] : cmd.entity;
+
+                if (cmd.type == CommandType::Add)
+                    ops->add(ops->pool, entity_id, cmd.value);
+                else
+                    ops->remove(ops->pool, entity_id);
+
+                ++applied;
+            }
+
+            for (CommandBuffer* buffer : buffer_list)
+            {
+                for (const CommandBuffer::Command& cmd : buffer->command_list)
+                {
+                    if (cmd.type != CommandType::Destroy)
+                        continue;
+
+                    if (GetEntityIndex(cmd.entity) < destroy_mark.size())
+                        destroy_mark[GetEntityIndex(cmd.entity)] = 0;
+
+                    pools.RemoveAll(cmd.entity);
+                    entity_pool.Destroy(cmd.entity);
+                    ++applied;
+                }
+
+                buffer->Clear();
+            }
+
+            return applied;
+        }
+    };
+
+} // namespace hgl::ecs
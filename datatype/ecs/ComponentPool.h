@@ -1,24 +1,61 @@
 #pragma once
 
 #include "EntityPool.h"
+#include "EntitySparseSet.h"
+#include "ChangeTick.h"
+#include<hgl/type/MonotonicIDList.h>
 #include<hgl/type/Map.h>
+#include<cstring>
+#include<type_traits>
+#include<utility>
+#include<vector>
 
 namespace hgl::ecs
 {
+    /**
+     * CN: 组件池的存储方式
+     * EN: Storage backend of a component pool
+     */
+    enum class ComponentStorageType
+    {
+        Map,            ///< CN: MonotonicIDList + Map<EntityID, MonotonicID>（默认） / EN: MonotonicIDList + Map<EntityID, MonotonicID> (default)
+        SparseSet       ///< CN: 分页稀疏索引 + 紧密数组，增删查均为O(1) / EN: Paged sparse index + dense array, O(1) add/remove/lookup
+    };
+
+    /**
+     * CN: 按组件类型选择存储方式，默认为Map，用HGL_ECS_COMPONENT_STORAGE为某个类型指定
+     * EN: Storage selection per component type, Map by default, override with HGL_ECS_COMPONENT_STORAGE
+     */
+    template<typename T>
+    struct ComponentStorageOf
+    {
+        static constexpr ComponentStorageType value = ComponentStorageType::Map;
+    };
+
     /**
      * CN: 组件池模板类
      * EN: Component Pool Template Class
      * 
      * CN: 为特定类型的组件提供池化管理，支持组件与实体的关联。
      *     每个组件池管理一种类型的组件。
+     *     ComponentPool<T>使用ComponentStorageOf<T>选择的存储方式，两种存储方式接口相同。
      * EN: Provides pooled management for specific component types,
      *     supports component-entity association.
      *     Each component pool manages one type of component.
+     *     ComponentPool<T> uses the backend chosen by ComponentStorageOf<T>, both backends share one interface.
      * 
      * @tparam T CN: 组件类型 / EN: Component type
+     * @tparam S CN: 存储方式 / EN: Storage backend
+     */
+    template<typename T, ComponentStorageType S = ComponentStorageOf<T>::value>
+    class ComponentPool;
+
+    /**
+     * CN: Map存储：组件存放在MonotonicIDList中，经由Map<EntityID, MonotonicID>查找
+     * EN: Map storage: components live in a MonotonicIDList and are found through Map<EntityID, MonotonicID>
      */
     template<typename T>
-    class ComponentPool
+    class ComponentPool<T, ComponentStorageType::Map>
     {
         struct ComponentData
         {
@@ -112,7 +149,16 @@ namespace hgl::ecs
          */
         const T* Get(const EntityID entity_id) const
         {
-            return const_cast<ComponentPool<T>*>(this)->Get(entity_id);
+            return const_cast<ComponentPool*>(this)->Get(entity_id);
+        }
+
+        /**
+         * CN: 取得组件用于写入。Map存储不记录变更计数，与Get相同，仅为与SparseSet存储接口一致
+         * EN: Get a component for writing. Map storage keeps no change ticks, this equals Get and only mirrors the SparseSet interface
+         */
+        T* Edit(const EntityID entity_id)
+        {
+            return Get(entity_id);
         }
 
         /**
@@ -152,6 +198,22 @@ namespace hgl::ecs
             return component_list.Shrink();
         }
 
+        /**
+         * CN: 按下标访问，下标[0, GetCount())，用于View按区间遍历
+         * EN: Indexed access over [0, GetCount()), used by View to iterate sub ranges
+         */
+        EntityID GetEntity(int index) const
+        {
+            return const_cast<ComponentPool*>(this)->entity_to_component.GetDataList()[index]->key;
+        }
+
+        T* GetAt(int index)
+        {
+            ComponentData* data = component_list.Get(entity_to_component.GetDataList()[index]->value);
+
+            return data ? &data->component : nullptr;
+        }
+
         /**
          * CN: 遍历所有组件
          * EN: Iterate through all components
@@ -163,21 +225,238 @@ namespace hgl::ecs
             if (!func)
                 return;
 
-            auto** keys = entity_to_component.GetKeyList();
-            auto** values = entity_to_component.GetDataList();
+            auto** pairs = entity_to_component.GetDataList();         // CN: 键值对指针数组 / EN: Array of key/value pair pointers
             int count = entity_to_component.GetCount();
 
             for (int i = 0; i < count; ++i)
             {
-                ComponentData* data = component_list.Get(values[i]);
+                ComponentData* data = component_list.Get(pairs[i]->value);
                 if (data)
                 {
-                    func(keys[i], &data->component, user_data);
+                    func(pairs[i]->key, &data->component, user_data);
                 }
             }
         }
     };
 
+    /**
+     * CN: 稀疏集合存储：分页稀疏索引从实体ID映射到紧密组件数组，删除时用最后一个组件填补
+     * EN: Sparse-set storage: a paged sparse index maps entity IDs into a dense component array, removal swaps in the last component
+     *
+     * CN: 增删查均为O(1)，遍历是对紧密数组的线性扫描，无空洞。
+     *     添加组件可能使紧密数组扩容，删除会移动最后一个组件，所以返回的指针只在下一次Add/Remove之前有效。
+     * EN: Add, remove and lookup are O(1), iteration is a linear scan over the gap-free dense array.
+     *     Adding may grow the dense array and removing moves the last component, so returned pointers
+     *     are only valid until the next Add/Remove.
+     *
+     * CN: 同时维护变更计数(ChangeTickTable)：Add、Edit、MarkChanged以及View中以非const类型访问时记录，
+     *     View的Filter<Added<T>>/Filter<Changed<T>>据此跳过未变化的块。
+     * EN: Change ticks (ChangeTickTable) are kept as well: Add, Edit, MarkChanged and non-const access through a View
+     *     record them, and View's Filter<Added<T>>/Filter<Changed<T>> use them to skip unchanged chunks.
+     */
+    template<typename T>
+    class ComponentPool<T, ComponentStorageType::SparseSet>
+    {
+        EntitySparseSet entity_set;
+        std::vector<T> component_list;                      ///< CN: 与entity_set下标一致的紧密组件数组 / EN: Dense components indexed like entity_set
+        ChangeTickTable change_ticks;                       ///< CN: 与entity_set下标一致的变更计数 / EN: Change ticks indexed like entity_set
+
+    public:
+
+        ComponentPool() = default;
+        ~ComponentPool() = default;
+
+        /**
+         * CN: 为实体添加组件
+         * EN: Add component to entity
+         * @return CN: 返回组件指针，已有组件或ID无效返回nullptr / EN: Returns component pointer, or nullptr if it already exists or the ID is invalid
+         */
+        T* Add(const EntityID entity_id)
+        {
+            const uint32 index = entity_set.Insert(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return nullptr;
+
+            component_list.emplace_back();
+            change_ticks.OnAdd(index);
+            return &component_list.back();
+        }
+
+        bool Add(const EntityID entity_id, const T& component)
+        {
+            const uint32 index = entity_set.Insert(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            component_list.push_back(component);
+            change_ticks.OnAdd(index);
+            return true;
+        }
+
+        bool Remove(const EntityID entity_id)
+        {
+            uint32 index;
+
+            if (!entity_set.Remove(entity_id, index))
+                return false;
+
+            const uint32 last = static_cast<uint32>(component_list.size() - 1);
+
+            if (index != last)
+                component_list[index] = std::move(component_list.back());
+
+            component_list.pop_back();
+            change_ticks.OnRemove(index, last);
+            return true;
+        }
+
+        T* Get(const EntityID entity_id)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index == EntitySparseSet::NPOS ? nullptr : &component_list[index];
+        }
+
+        const T* Get(const EntityID entity_id) const
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index == EntitySparseSet::NPOS ? nullptr : &component_list[index];
+        }
+
+        /**
+         * CN: 取得组件用于写入，并记为已修改。Get不记录修改，只读访问不影响Changed过滤
+         * EN: Get a component for writing and mark it changed. Get does not mark, so read-only access never trips Changed filters
+         */
+        T* Edit(const EntityID entity_id)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return nullptr;
+
+            change_ticks.OnChange(index);
+            return &component_list[index];
+        }
+
+        bool MarkChanged(const EntityID entity_id)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            change_ticks.OnChange(index);
+            return true;
+        }
+
+        void MarkChangedAt(int index) { change_ticks.OnChange(static_cast<uint32>(index)); }
+
+        /**
+         * CN: 变更计数表，下标与紧密数组一致
+         * EN: Change tick table, indexed like the dense arrays
+         */
+        const ChangeTickTable& GetChangeTicks() const { return change_ticks; }
+
+        bool Has(const EntityID entity_id) const
+        {
+            return entity_set.Contains(entity_id);
+        }
+
+        int GetCount() const
+        {
+            return static_cast<int>(entity_set.GetCount());
+        }
+
+        void Clear()
+        {
+            entity_set.Clear();
+            component_list.clear();
+            change_ticks.Clear();
+        }
+
+        /**
+         * CN: 收缩内存
+         * EN: Shrink memory
+         * @return CN: 释放的稀疏页数 / EN: Number of sparse pages released
+         */
+        int Shrink()
+        {
+            component_list.shrink_to_fit();
+            change_ticks.Shrink();
+            return entity_set.Shrink();
+        }
+
+        void Reserve(int count)
+        {
+            entity_set.Reserve(static_cast<uint32>(count));
+            component_list.reserve(count);
+            change_ticks.Reserve(static_cast<uint32>(count));
+        }
+
+        /**
+         * CN: 紧密数组，下标[0, GetCount())，实体与组件一一对应
+         * EN: Dense arrays indexed [0, GetCount()), entities and components correspond one to one
+         */
+        const EntityID* GetEntities() const { return entity_set.GetEntities(); }
+        T* GetData() { return component_list.data(); }
+        const T* GetData() const { return component_list.data(); }
+
+        EntityID GetEntity(int index) const { return entity_set.GetEntity(static_cast<uint32>(index)); }
+        T* GetAt(int index) { return &component_list[index]; }
+
+        /**
+         * CN: 用紧密数组整体替换当前内容，data为count个按位拷贝的T，不必对齐。用于快照恢复，避免逐个Add。
+         * EN: Replace the whole content from dense arrays, data holds count bitwise copies of T and need not be aligned.
+         *     Used to restore snapshots without per-entity Add calls.
+         * @return CN: 实体ID无效或重复时返回false，池被清空 / EN: false if an entity ID is invalid or repeated, the pool is left empty
+         */
+        bool AssignRaw(const EntityID* ids, const void* data, uint32 count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "AssignRaw requires a trivially copyable component");
+
+            if (!entity_set.Assign(ids, count))
+            {
+                component_list.clear();
+                change_ticks.Clear();
+                return false;
+            }
+
+            component_list.resize(count);
+            memcpy(component_list.data(), data, count * sizeof(T));
+            change_ticks.Assign(count);
+            return true;
+        }
+
+        using IterateFunc = void(*)(EntityID entity_id, T* component, void* user_data);
+
+        void Iterate(IterateFunc func, void* user_data = nullptr)
+        {
+            if (!func)
+                return;
+
+            const EntityID* entities = entity_set.GetEntities();
+            const uint32 count = entity_set.GetCount();
+
+            for (uint32 i = 0; i < count; ++i)
+                func(entities[i], &component_list[i], user_data);
+        }
+    };
+
+    /**
+     * CN: 为组件类型指定存储方式，需在全局命名空间、首次使用ComponentPool<T>之前使用
+     * EN: Select the storage backend of a component type, use at global scope before the first use of ComponentPool<T>
+     *
+     *     HGL_ECS_COMPONENT_STORAGE(PositionComponent, SparseSet)
+     */
+    #define HGL_ECS_COMPONENT_STORAGE(component_type, storage_type)                                       \
+        template<> struct hgl::ecs::ComponentStorageOf<component_type>                                    \
+        {                                                                                                   \
+            static constexpr hgl::ecs::ComponentStorageType value = hgl::ecs::ComponentStorageType::storage_type;  \
+        };
+
     /**
      * CN: 组件管理器 - 管理多种类型的组件池
      * EN: Component Manager - Manages multiple component pool types
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "EntityPool.h"
+#include<atomic>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+namespace hgl::ecs
+{
+    using ComponentTypeID = uint32;
+    constexpr const ComponentTypeID COMPONENT_TYPE_INVALID = 0xFFFFFFFF;
+
+    /**
+     * CN: 组件类型的运行时描述，用于按类型擦除的方式管理列式存储
+     * EN: Runtime description of a component type, used by type-erased column storage
+     */
+    struct ComponentTypeInfo
+    {
+        ComponentTypeID id;
+        uint32 size;
+        uint32 align;
+
+        void (*construct)(void* dst);                   ///< CN: 默认构造 / EN: Default construct
+        void (*destroy)(void* obj);
+        void (*move)(void* dst, void* src);             ///< CN: 移动构造到dst并析构src / EN: Move construct into dst and destroy src
+    };
+
+    namespace component_detail
+    {
+        inline ComponentTypeID NextTypeID()
+        {
+            static std::atomic<ComponentTypeID> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template<typename T> ComponentTypeID TypeID()
+        {
+            static const ComponentTypeID id = NextTypeID();
+            return id;
+        }
+
+        template<typename T> void Construct(void* dst) { new(dst) T(); }
+        template<typename T> void Destroy(void* obj) { static_cast<T*>(obj)->~T(); }
+
+        template<typename T> void Move(void* dst, void* src)
+        {
+            new(dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        }
+    }
+
+    /**
+     * CN: 获取组件类型编号，编号按首次使用的顺序从0开始分配
+     * EN: Get the component type ID, IDs are assigned from 0 in order of first use
+     */
+    template<typename T>
+    ComponentTypeID GetComponentTypeID()
+    {
+        return component_detail::TypeID<std::remove_cv_t<T>>();
+    }
+
+    template<typename T>
+    const ComponentTypeInfo &GetComponentTypeInfo()
+    {
+        using U = std::remove_cv_t<T>;
+
+        static const ComponentTypeInfo info
+        {
+            GetComponentTypeID<U>(),
+            static_cast<uint32>(sizeof(U)),
+            static_cast<uint32>(alignof(U)),
+            &component_detail::Construct<U>,
+            &component_detail::Destroy<U>,
+            &component_detail::Move<U>
+        };
+
+        return info;
+    }
+
+} // namespace hgl::ecs
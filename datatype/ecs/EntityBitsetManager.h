@@ -0,0 +1,442 @@
+#pragma once
+
+#include "IEntityManager.h"
+#include<algorithm>
+#include<cstring>
+#include<vector>
+
+#if defined(_MSC_VER)
+#include<intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include<immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define HGL_ECS_BITSET_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include<arm_neon.h>
+#define HGL_ECS_BITSET_NEON
+#endif
+
+namespace hgl::ecs
+{
+    namespace bitset_detail
+    {
+        inline int PopCount(uint64 v)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return static_cast<int>(__popcnt64(v));
+#else
+            v = v - ((v >> 1) & 0x5555555555555555ull);
+            v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+            v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return static_cast<int>((v * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        inline uint32 CountTrailingZeros(uint64 v)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<uint32>(__builtin_ctzll(v));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index;
+            _BitScanForward64(&index, v);
+            return index;
+#else
+            uint32 n = 0;
+            while (!(v & 1)) { v >>= 1; ++n; }
+            return n;
+#endif
+        }
+
+        enum class Op { And, Or, AndNot };
+
+        template<Op OP> inline uint64 Apply(uint64 a, uint64 b)
+        {
+            if constexpr (OP == Op::And)    return a & b;
+            else if constexpr (OP == Op::Or) return a | b;
+            else                            return a & ~b;
+        }
+
+        /**
+         * CN: dst = dst OP src，共n个64位字，返回结果中1的个数；每组字写回后立即统计，仍在同一遍循环中
+         * EN: dst = dst OP src over n 64-bit words, returns the number of set bits in the result; every group of words
+         *     is counted right after it is stored, within the same loop
+         */
+        template<Op OP> inline int Combine(uint64* dst, const uint64* src, size_t n)
+        {
+            size_t i = 0;
+            int count = 0;
+
+#if defined(__AVX2__)
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                __m256i r;
+
+                if constexpr (OP == Op::And)        r = _mm256_and_si256(a, b);
+                else if constexpr (OP == Op::Or)    r = _mm256_or_si256(a, b);
+                else                                r = _mm256_andnot_si256(b, a);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+
+                count += PopCount(dst[i]) + PopCount(dst[i + 1]) + PopCount(dst[i + 2]) + PopCount(dst[i + 3]);
+            }
+#elif defined(HGL_ECS_BITSET_SSE2)
+            for (; i + 2 <= n; i += 2)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i r;
+
+                if constexpr (OP == Op::And)        r = _mm_and_si128(a, b);
+                else if constexpr (OP == Op::Or)    r = _mm_or_si128(a, b);
+                else                                r = _mm_andnot_si128(b, a);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+
+                count += PopCount(dst[i]) + PopCount(dst[i + 1]);
+            }
+#elif defined(HGL_ECS_BITSET_NEON)
+            for (; i + 2 <= n; i += 2)
+            {
+                const uint64x2_t a = vld1q_u64(dst + i);
+                const uint64x2_t b = vld1q_u64(src + i);
+                uint64x2_t r;
+
+                if constexpr (OP == Op::And)        r = vandq_u64(a, b);
+                else if constexpr (OP == Op::Or)    r = vorrq_u64(a, b);
+                else                                r = vbicq_u64(a, b);
+
+                vst1q_u64(dst + i, r);
+
+                count += PopCount(dst[i]) + PopCount(dst[i + 1]);
+            }
+#endif
+
+            for (; i < n; ++i)
+            {
+                dst[i] = Apply<OP>(dst[i], src[i]);
+                count += PopCount(dst[i]);
+            }
+
+            return count;
+        }
+
+        /**
+         * CN: 只统计a OP b中1的个数，不写结果
+         * EN: Only count the set bits of a OP b, without storing the result
+         */
+        template<Op OP> inline int CountCombined(const uint64* a, const uint64* b, size_t n)
+        {
+            int count = 0;
+
+            for (size_t i = 0; i < n; ++i)
+                count += PopCount(Apply<OP>(a[i], b[i]));
+
+            return count;
+        }
+    }
+
+    /**
+     * CN: 位集实体管理器
+     * EN: Bitset-based Entity Manager
+     *
+     * CN: 与EntityListManager用途相同（无层级的实体集合/标签），但按实体槽位下标存为稠密位集：
+     *     - Add/Remove/Contains只改写或测试一位，O(1)，没有查找与数组移动
+     *     - 集合运算(AndWith/OrWith/AndNotWith)按字进行，有AVX2/SSE2/NEON时每次处理128/256位，并用popcount同时得出数量
+     *     - CountAnd等只统计交集/差集的数量，不生成结果
+     *     每个槽位另存代数，Contains与Iterate使用完整的EntityID，旧ID不会命中复用槽位的新实体。
+     *     集合运算只看位，参与运算的集合中同一槽位应是同一实体（销毁实体前先从集合中移除）。
+     *     内存与最大槽位下标成正比（每实体1位+4字节代数），适合覆盖大部分实体的列表；很稀疏的小列表仍宜用EntityListManager。
+     * EN: Same purpose as EntityListManager (a flat entity set / tag) but stored as a dense bitset indexed by the
+     *     entity slot index:
+     *     - Add/Remove/Contains write or test one bit, O(1), no search and no array shifting
+     *     - Set algebra (AndWith/OrWith/AndNotWith) runs word by word, 128/256 bits at a time with AVX2/SSE2/NEON,
+     *       and popcount yields the resulting count in the same pass
+     *     - CountAnd and friends only count an intersection/difference without building it
+     *     Every slot also keeps its generation, so Contains and Iterate use full EntityIDs and a stale ID never hits
+     *     the new entity of a recycled slot. Set algebra only looks at bits, so a slot present in several sets must
+     *     be the same entity in all of them (remove entities from sets before destroying them).
+     *     Memory follows the highest slot index (1 bit + 4 bytes of generation per entity), which suits lists that
+     *     cover a good share of all entities; small, very sparse lists are still better off in EntityListManager.
+     */
+    class EntityBitsetManager : public IEntityManager
+    {
+        std::vector<uint64> word_list;
+        std::vector<uint32> generation_list;            ///< CN: 按槽位下标，仅在对应位为1时有效 / EN: By slot index, only meaningful where the bit is set
+        int count = 0;
+
+        void Grow(size_t words)
+        {
+            if (word_list.size() < words)
+            {
+                word_list.resize(words, 0);
+                generation_list.resize(words * 64, 0);
+            }
+        }
+
+        bool TestBit(uint32 index) const
+        {
+            const size_t w = index >> 6;
+
+            return w < word_list.size() && (word_list[w] >> (index & 63)) & 1;
+        }
+
+    public:
+
+        EntityBitsetManager(EntityPool* pool) : IEntityManager(pool) {}
+        ~EntityBitsetManager() override = default;
+
+        bool Add(const EntityID entity_id) override
+        {
+            if (!entity_pool || !entity_pool->Contains(entity_id))
+                return false;
+
+            const uint32 index = GetEntityIndex(entity_id);
+            const uint32 generation = GetEntityGeneration(entity_id);
+
+            if (TestBit(index))
+            {
+                if (generation_list[index] == generation)
+                    return false;
+
+                generation_list[index] = generation;    // 槽位中是已销毁的旧实体，直接替换
+                return true;
+            }
+
+            Grow((size_t(index) >> 6) + 1);
+
+            word_list[index >> 6] |= uint64(1) << (index & 63);
+            generation_list[index] = generation;
+            ++count;
+            return true;
+        }
+
+        bool Remove(const EntityID entity_id) override
+        {
+            if (!Contains(entity_id))
+                return false;
+
+            const uint32 index = GetEntityIndex(entity_id);
+
+            word_list[index >> 6] &= ~(uint64(1) << (index & 63));
+            --count;
+            return true;
+        }
+
+        bool Contains(const EntityID entity_id) const override
+        {
+            const uint32 index = GetEntityIndex(entity_id);
+
+            return TestBit(index) && generation_list[index] == GetEntityGeneration(entity_id);
+        }
+
+        int GetCount() const override
+        {
+            return count;
+        }
+
+        /**
+         * CN: 清空集合，保留已分配的内存
+         * EN: Clear the set, keeping the allocated memory
+         */
+        void Clear() override
+        {
+            std::fill(word_list.begin(), word_list.end(), 0);
+            count = 0;
+        }
+
+        /**
+         * CN: 按槽位下标从小到大遍历
+         * EN: Iterate in ascending slot order
+         */
+        void Iterate(IterateFunc func, void* user_data = nullptr) override
+        {
+            if (!func)
+                return;
+
+            ForEach([func, user_data](EntityID entity_id) { func(entity_id, user_data); });
+        }
+
+        template<typename F>
+        void ForEach(F&& func) const
+        {
+            for (size_t w = 0; w < word_list.size(); ++w)
+            {
+                uint64 bits = word_list[w];
+
+                while (bits)
+                {
+                    const uint32 index = static_cast<uint32>(w * 64 + bitset_detail::CountTrailingZeros(bits));
+
+                    func(MakeEntityID(index, generation_list[index]));
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        int AddBatch(const EntityID* ids, int num)
+        {
+            if (!ids || num <= 0)
+                return 0;
+
+            int added = 0;
+
+            for (int i = 0; i < num; ++i)
+                if (Add(ids[i]))
+                    ++added;
+
+            return added;
+        }
+
+        int RemoveBatch(const EntityID* ids, int num)
+        {
+            if (!ids || num <= 0)
+                return 0;
+
+            int removed = 0;
+
+            for (int i = 0; i < num; ++i)
+                if (Remove(ids[i]))
+                    ++removed;
+
+            return removed;
+        }
+
+        /**
+         * CN: 复制另一个集合的内容
+         * EN: Copy the contents of another set
+         */
+        void Assign(const EntityBitsetManager& other)
+        {
+            if (this == &other)
+                return;
+
+            Grow(other.word_list.size());
+
+            std::copy(other.word_list.begin(), other.word_list.end(), word_list.begin());
+            std::fill(word_list.begin() + other.word_list.size(), word_list.end(), 0);
+            std::copy(other.generation_list.begin(), other.generation_list.end(), generation_list.begin());
+            count = other.count;
+        }
+
+        /**
+         * CN: 只保留同时在other中的实体
+         * EN: Keep only entities that are also in other
+         */
+        void AndWith(const EntityBitsetManager& other)
+        {
+            const size_t n = std::min(word_list.size(), other.word_list.size());
+
+            std::fill(word_list.begin() + n, word_list.end(), 0);
+            count = bitset_detail::Combine<bitset_detail::Op::And>(word_list.data(), other.word_list.data(), n);
+        }
+
+        /**
+         * CN: 加入other中的所有实体
+         * EN: Add every entity of other
+         */
+        void OrWith(const EntityBitsetManager& other)
+        {
+            Grow(other.word_list.size());
+
+            // 只在other中的位从other取代数
+            for (size_t w = 0; w < other.word_list.size(); ++w)
+            {
+                uint64 bits = other.word_list[w] & ~word_list[w];
+
+                while (bits)
+                {
+                    const size_t index = w * 64 + bitset_detail::CountTrailingZeros(bits);
+
+                    generation_list[index] = other.generation_list[index];
+                    bits &= bits - 1;
+                }
+            }
+
+            count = bitset_detail::Combine<bitset_detail::Op::Or>(word_list.data(), other.word_list.data(), other.word_list.size());
+
+            for (size_t w = other.word_list.size(); w < word_list.size(); ++w)
+                count += bitset_detail::PopCount(word_list[w]);
+        }
+
+        /**
+         * CN: 去掉在other中的实体
+         * EN: Drop entities that are in other
+         */
+        void AndNotWith(const EntityBitsetManager& other)
+        {
+            const size_t n = std::min(word_list.size(), other.word_list.size());
+
+            count = bitset_detail::Combine<bitset_detail::Op::AndNot>(word_list.data(), other.word_list.data(), n);
+
+            for (size_t w = n; w < word_list.size(); ++w)
+                count += bitset_detail::PopCount(word_list[w]);
+        }
+
+        /**
+         * CN: 交集的数量
+         * EN: Size of the intersection
+         */
+        int CountAnd(const EntityBitsetManager& other) const
+        {
+            return bitset_detail::CountCombined<bitset_detail::Op::And>(word_list.data(), other.word_list.data(), std::min(word_list.size(), other.word_list.size()));
+        }
+
+        /**
+         * CN: 在本集合而不在other中的数量
+         * EN: Number of entities in this set but not in other
+         */
+        int CountAndNot(const EntityBitsetManager& other) const
+        {
+            const size_t n = std::min(word_list.size(), other.word_list.size());
+            int result = bitset_detail::CountCombined<bitset_detail::Op::AndNot>(word_list.data(), other.word_list.data(), n);
+
+            for (size_t w = n; w < word_list.size(); ++w)
+                result += bitset_detail::PopCount(word_list[w]);
+
+            return result;
+        }
+
+        bool Intersects(const EntityBitsetManager& other) const
+        {
+            const size_t n = std::min(word_list.size(), other.word_list.size());
+
+            for (size_t w = 0; w < n; ++w)
+                if (word_list[w] & other.word_list[w])
+                    return true;
+
+            return false;
+        }
+
+        /**
+         * CN: 底层的位数组，第i位对应槽位下标i
+         * EN: Underlying words, bit i maps to slot index i
+         */
+        const uint64* GetWords() const { return word_list.data(); }
+        uint32 GetWordCount() const { return static_cast<uint32>(word_list.size()); }
+
+        /**
+         * CN: 去掉末尾的全0字并释放多余内存
+         * EN: Trim trailing zero words and release spare memory
+         */
+        void Shrink()
+        {
+            size_t n = word_list.size();
+
+            while (n > 0 && word_list[n - 1] == 0)
+                --n;
+
+            word_list.resize(n);
+            generation_list.resize(n * 64);
+            word_list.shrink_to_fit();
+            generation_list.shrink_to_fit();
+        }
+    };
+
+} // namespace hgl::ecs
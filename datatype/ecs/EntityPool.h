@@ -1,12 +1,28 @@
 #pragma once
 
-#include<hgl/type/MonotonicIDList.h>
+#include<hgl/type/DataType.h>
+#include<algorithm>
+#include<vector>
 
 namespace hgl::ecs
 {
-    using EntityID = MonotonicID;
+    /**
+     * CN: 实体ID：低32位为槽位下标，高32位为代数。槽位被回收再使用时代数加1，旧ID随之失效。
+     *     代数从1开始，所以有效ID永远不为0。
+     * EN: Entity ID: low 32 bits are the slot index, high 32 bits the generation. The generation is bumped
+     *     whenever a slot is recycled, so stale IDs stop matching. Generations start at 1, so a valid ID is never 0.
+     */
+    using EntityID = uint64;
     constexpr const EntityID ENTITY_ID_INVALID = 0;
 
+    inline constexpr EntityID MakeEntityID(uint32 index, uint32 generation)
+    {
+        return (EntityID(generation) << 32) | index;
+    }
+
+    inline constexpr uint32 GetEntityIndex(EntityID id) { return static_cast<uint32>(id); }
+    inline constexpr uint32 GetEntityGeneration(EntityID id) { return static_cast<uint32>(id >> 32); }
+
     /**
      * CN: 实体基础数据结构
      * EN: Entity base data structure
@@ -39,7 +55,10 @@ namespace hgl::ecs
      */
     class EntityPool
     {
-        MonotonicIDList<Entity, EntityID> entity_list;
+        std::vector<Entity> entity_list;                ///< CN: 按槽位下标存放，空闲槽位的entity_id为ENTITY_ID_INVALID / EN: Indexed by slot, free slots hold ENTITY_ID_INVALID
+        std::vector<uint32> generation_list;            ///< CN: 每个槽位当前的代数 / EN: Current generation of each slot
+        std::vector<uint32> free_list;                  ///< CN: 空闲槽位，从末尾取用 / EN: Free slots, taken from the back
+        uint32 alive_count = 0;
 
     public:
 
@@ -47,46 +66,71 @@ namespace hgl::ecs
         ~EntityPool() = default;
 
         /**
-         * CN: 创建一个新实体
-         * EN: Create a new entity
+         * CN: 创建一个新实体，优先复用空闲槽位
+         * EN: Create a new entity, reusing a free slot first
          * @return CN: 返回新实体的ID，失败返回ENTITY_ID_INVALID
          *         EN: Returns the new entity ID, or ENTITY_ID_INVALID on failure
          */
         EntityID Create()
         {
-            Entity* entity = entity_list.Add();
-            if (!entity)
-                return ENTITY_ID_INVALID;
+            uint32 index;
+
+            if (!free_list.empty())
+            {
+                index = free_list.back();
+                free_list.pop_back();
+            }
+            else
+            {
+                if (entity_list.size() >= 0xFFFFFFFF)
+                    return ENTITY_ID_INVALID;
+
+                index = static_cast<uint32>(entity_list.size());
+                entity_list.emplace_back();
+                generation_list.push_back(1);
+            }
+
+            Entity* entity = &entity_list[index];
 
             entity->Init();
-            entity->entity_id = static_cast<EntityID>(entity_list.GetLocation(entity->entity_id) + 1);
-            
+            entity->entity_id = MakeEntityID(index, generation_list[index]);
+
+            ++alive_count;
             return entity->entity_id;
         }
 
         /**
-         * CN: 销毁一个实体
-         * EN: Destroy an entity
+         * CN: 销毁一个实体，槽位的代数加1后放入空闲列表，所有旧ID随即失效
+         * EN: Destroy an entity, the slot generation is bumped and the slot goes to the free list, invalidating every old ID
          * @param id CN: 要销毁的实体ID / EN: Entity ID to destroy
          * @return CN: 成功返回true / EN: Returns true on success
          */
         bool Destroy(const EntityID id)
         {
-            if (!entity_list.Contains(id))
+            if (!Contains(id))
                 return false;
 
-            return entity_list.Remove(id);
+            const uint32 index = GetEntityIndex(id);
+
+            entity_list[index].Init();
+
+            if (++generation_list[index] == 0)          // 代数回绕时跳过0，保证有效ID不为0
+                generation_list[index] = 1;
+
+            free_list.push_back(index);
+            --alive_count;
+            return true;
         }
 
         /**
          * CN: 获取实体指针
          * EN: Get entity pointer
          * @param id CN: 实体ID / EN: Entity ID
-         * @return CN: 返回实体指针，不存在返回nullptr / EN: Returns entity pointer, or nullptr if not found
+         * @return CN: 返回实体指针，不存在或已失效返回nullptr / EN: Returns entity pointer, or nullptr if not found or stale
          */
         Entity* Get(const EntityID id)
         {
-            return entity_list.Get(id);
+            return Contains(id) ? &entity_list[GetEntityIndex(id)] : nullptr;
         }
 
         /**
@@ -95,18 +139,28 @@ namespace hgl::ecs
          */
         const Entity* Get(const EntityID id) const
         {
-            return const_cast<EntityPool*>(this)->entity_list.Get(id);
+            return const_cast<EntityPool*>(this)->Get(id);
         }
 
         /**
-         * CN: 检查实体是否存在
-         * EN: Check if entity exists
+         * CN: 检查实体是否存在，O(1)：槽位有效且代数一致
+         * EN: Check if entity exists, O(1): the slot is alive and the generation matches
          */
         bool Contains(const EntityID id) const
         {
-            return entity_list.Contains(id);
+            const uint32 index = GetEntityIndex(id);
+
+            return index < entity_list.size() && entity_list[index].entity_id == id && id != ENTITY_ID_INVALID;
         }
 
+        int GetCount() const { return static_cast<int>(alive_count); }
+
+        /**
+         * CN: 槽位总数，实体下标的上限
+         * EN: Total slot count, the upper bound of entity indices
+         */
+        uint32 GetCapacity() const { return static_cast<uint32>(entity_list.size()); }
+
         /**
          * CN: 获取实体的用户数据
          * EN: Get entity user data
@@ -153,21 +207,99 @@ namespace hgl::ecs
         }
 
         /**
-         * CN: 收缩内存，移除碎片
-         * EN: Shrink memory, remove fragmentation
+         * CN: 各槽位当前的代数，下标[0, GetCapacity())，用于保存快照
+         * EN: Current generation of every slot, indexed [0, GetCapacity()), used for snapshots
+         */
+        const uint32* GetGenerations() const { return generation_list.data(); }
+
+        /**
+         * CN: 空闲槽位列表，按复用顺序的逆序排列（从末尾取用）
+         * EN: Free slot list in reverse reuse order (taken from the back)
+         */
+        const uint32* GetFreeSlots() const { return free_list.data(); }
+        uint32 GetFreeCount() const { return static_cast<uint32>(free_list.size()); }
+
+        /**
+         * CN: 按槽位状态整体恢复实体池，原有实体全部丢弃，用户数据清空。
+         *     不在free_slots中的槽位均为存活实体，其ID为MakeEntityID(槽位, generations[槽位])。
+         * EN: Restore the whole pool from slot state, discarding every current entity and all user data.
+         *     Every slot not listed in free_slots is alive with ID MakeEntityID(slot, generations[slot]).
+         * @param flags CN: 各槽位的标志位，可为nullptr / EN: Per-slot flags, may be nullptr
+         * @return CN: 代数为0、空闲槽位越界或重复时返回false，实体池被清空
+         *         EN: false if a generation is 0 or a free slot is out of range or repeated, the pool is left empty
+         */
+        bool Restore(const uint32* generations, const uint32* flags, uint32 slot_count, const uint32* free_slots, uint32 free_count)
+        {
+            entity_list.resize(slot_count);
+            generation_list.assign(generations, generations + slot_count);
+            free_list.assign(free_slots, free_slots + free_count);
+
+            bool valid = free_count <= slot_count;
+
+            for (uint32 i = 0; i < slot_count; ++i)
+            {
+                Entity& entity = entity_list[i];
+
+                entity.entity_id = MakeEntityID(i, generation_list[i]);
+                entity.flags = flags ? flags[i] : 0;
+                entity.user_data = nullptr;
+
+                if (generation_list[i] == 0)
+                    valid = false;
+            }
+
+            for (const uint32 slot : free_list)
+            {
+                if (slot >= slot_count || entity_list[slot].entity_id == ENTITY_ID_INVALID)
+                {
+                    valid = false;
+                    break;
+                }
+
+                entity_list[slot].Init();
+            }
+
+            if (!valid)
+            {
+                entity_list.clear();
+                generation_list.clear();
+                free_list.clear();
+                alive_count = 0;
+                return false;
+            }
+
+            alive_count = slot_count - free_count;
+            return true;
+        }
+
+        /**
+         * CN: 收缩内存。槽位的代数必须保留，所以只释放多余容量，并让空闲槽位按下标从小到大复用，使实体保持紧凑
+         * EN: Shrink memory. Slot generations must be kept, so only spare capacity is released and free slots are
+         *     reused from the lowest index up to keep entities compact
+         * @return CN: 空闲槽位数 / EN: Number of free slots
          */
         int Shrink()
         {
-            return entity_list.Shrink();
+            std::sort(free_list.begin(), free_list.end(), [](uint32 a, uint32 b) { return a > b; });
+
+            entity_list.shrink_to_fit();
+            generation_list.shrink_to_fit();
+            free_list.shrink_to_fit();
+
+            return static_cast<int>(free_list.size());
         }
 
         /**
-         * CN: 重新编号所有实体ID
-         * EN: Reindex all entity IDs
+         * CN: 原先用于重新编号实体ID。代数式ID在槽位复用时不会与旧实体混淆，不再需要重新编号，
+         *     这里只整理空闲列表，现有ID保持有效
+         * EN: Used to renumber entity IDs. Generational IDs never alias recycled slots, so no renumbering is needed;
+         *     this only reorders the free list and every existing ID stays valid
+         * @return CN: 被重新编号的实体数，恒为0 / EN: Number of renumbered entities, always 0
          */
         int Reindex()
         {
-            return entity_list.Reindex();
+            Shrink();
+            return 0;
         }
     };
 
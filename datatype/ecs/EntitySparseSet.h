@@ -0,0 +1,236 @@
+#pragma once
+
+#include "EntityPool.h"
+#include<cstring>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 实体稀疏集合
+     * EN: Entity sparse set
+     *
+     * CN: 稀疏索引按页(4096项)分配，从实体ID直接映射到紧密数组中的位置；紧密数组无空洞，删除时用最后一项填补。
+     *     查找、添加、删除都是O(1)，遍历顺序就是紧密数组的顺序。调用方按相同的下标维护自己的数据数组。
+     * EN: The sparse index is allocated in pages of 4096 entries and maps an entity ID straight to its position
+     *     in the dense array; the dense array has no holes, removal fills the slot with the last entry.
+     *     Lookup, insert and remove are O(1), iteration follows the dense array.
+     *     Callers keep their own data arrays in step with the dense indices.
+     *
+     * CN: 稀疏索引按实体ID的槽位下标寻址，紧密数组保存完整ID，查找时比较代数，旧ID不会命中复用槽位的新实体。
+     * EN: The sparse index is addressed by the slot index of the entity ID and the dense array keeps the full ID,
+     *     lookups compare generations so a stale ID never hits the new entity in a recycled slot.
+     */
+    class EntitySparseSet
+    {
+    public:
+
+        static constexpr uint32 PAGE_BITS = 12;
+        static constexpr uint32 PAGE_SIZE = 1u << PAGE_BITS;
+        static constexpr uint32 NPOS = 0xFFFFFFFF;
+
+    private:
+
+        std::vector<uint32*> pages;                 ///< CN: 稀疏索引页，未使用的页为nullptr / EN: Sparse index pages, nullptr when unused
+        std::vector<EntityID> dense;                ///< CN: 紧密排列的实体ID / EN: Densely packed entity IDs
+
+        static size_t ToIndex(const EntityID entity_id)
+        {
+            return GetEntityIndex(entity_id);
+        }
+
+        uint32* FindSlot(const EntityID entity_id) const
+        {
+            const size_t index = ToIndex(entity_id);
+            const size_t page = index >> PAGE_BITS;
+
+            if (page >= pages.size() || !pages[page])
+                return nullptr;
+
+            return pages[page] + (index & (PAGE_SIZE - 1));
+        }
+
+        uint32& GetOrCreateSlot(const EntityID entity_id)
+        {
+            const size_t index = ToIndex(entity_id);
+            const size_t page = index >> PAGE_BITS;
+
+            if (page >= pages.size())
+                pages.resize(page + 1, nullptr);
+
+            if (!pages[page])
+            {
+                pages[page] = new uint32[PAGE_SIZE];
+                memset(pages[page], 0xFF, PAGE_SIZE * sizeof(uint32));
+            }
+
+            return pages[page][index & (PAGE_SIZE - 1)];
+        }
+
+    public:
+
+        EntitySparseSet() = default;
+
+        ~EntitySparseSet()
+        {
+            for (uint32* page : pages)
+                delete[] page;
+        }
+
+        EntitySparseSet(const EntitySparseSet&) = delete;
+        EntitySparseSet& operator=(const EntitySparseSet&) = delete;
+
+        /**
+         * CN: 查找实体在紧密数组中的位置
+         * EN: Find the dense index of an entity
+         * @return CN: 不存在返回NPOS / EN: NPOS if absent
+         */
+        uint32 Find(const EntityID entity_id) const
+        {
+            const uint32* slot = FindSlot(entity_id);
+
+            if (!slot || *slot == NPOS || dense[*slot] != entity_id)
+                return NPOS;
+
+            return *slot;
+        }
+
+        bool Contains(const EntityID entity_id) const
+        {
+            return Find(entity_id) != NPOS;
+        }
+
+        /**
+         * CN: 加入实体，返回其在紧密数组中的位置（总在末尾）
+         * EN: Insert an entity and return its dense index (always at the end)
+         * @return CN: 已存在、ID无效或槽位仍被旧代实体占用返回NPOS / EN: NPOS if already present, the ID is invalid or the slot is still held by an older generation
+         */
+        uint32 Insert(const EntityID entity_id)
+        {
+            if (entity_id == ENTITY_ID_INVALID)
+                return NPOS;
+
+            uint32& slot = GetOrCreateSlot(entity_id);
+
+            if (slot != NPOS)
+                return NPOS;
+
+            slot = static_cast<uint32>(dense.size());
+            dense.push_back(entity_id);
+            return slot;
+        }
+
+        /**
+         * CN: 移除实体，最后一项被移到空出的位置
+         * EN: Remove an entity, the last entry moves into the freed slot
+         * @param removed_index CN: 被移除的位置，调用方需把last位置的数据移到这里 / EN: Freed dense index, callers move their data from the last index here
+         * @return CN: 不存在返回false / EN: false if absent
+         */
+        bool Remove(const EntityID entity_id, uint32& removed_index)
+        {
+            uint32* slot = FindSlot(entity_id);
+
+            if (!slot || *slot == NPOS || dense[*slot] != entity_id)
+                return false;
+
+            removed_index = *slot;
+
+            const uint32 last = static_cast<uint32>(dense.size() - 1);
+
+            if (removed_index != last)
+            {
+                const EntityID moved = dense[last];
+
+                dense[removed_index] = moved;
+                *FindSlot(moved) = removed_index;
+            }
+
+            dense.pop_back();
+            *slot = NPOS;
+            return true;
+        }
+
+        uint32 GetCount() const { return static_cast<uint32>(dense.size()); }
+        bool IsEmpty() const { return dense.empty(); }
+
+        const EntityID* GetEntities() const { return dense.data(); }
+        EntityID GetEntity(uint32 index) const { return dense[index]; }
+
+        void Reserve(uint32 count) { dense.reserve(count); }
+
+        /**
+         * CN: 用一组实体整体替换当前内容，紧密数组的顺序与ids相同
+         * EN: Replace the whole content with a list of entities, the dense order matches ids
+         * @return CN: 有无效或重复的槽位时返回false，集合被清空 / EN: false if an ID is invalid or a slot repeats, the set is left empty
+         */
+        bool Assign(const EntityID* ids, uint32 count)
+        {
+            Clear();
+
+            dense.resize(count);
+            memcpy(dense.data(), ids, count * sizeof(EntityID));
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if (dense[i] == ENTITY_ID_INVALID)
+                {
+                    Clear();
+                    return false;
+                }
+
+                uint32& slot = GetOrCreateSlot(dense[i]);
+
+                if (slot != NPOS)
+                {
+                    Clear();
+                    return false;
+                }
+
+                slot = i;
+            }
+
+            return true;
+        }
+
+        void Clear()
+        {
+            for (uint32* page : pages)
+                delete[] page;
+
+            pages.clear();
+            dense.clear();
+        }
+
+        /**
+         * CN: 释放没有任何实体的稀疏页与紧密数组的多余容量
+         * EN: Release sparse pages holding no entity and spare dense capacity
+         * @return CN: 释放的页数 / EN: Number of pages released
+         */
+        int Shrink()
+        {
+            std::vector<bool> used(pages.size(), false);
+
+            for (const EntityID id : dense)
+                used[ToIndex(id) >> PAGE_BITS] = true;
+
+            int released = 0;
+
+            for (size_t i = 0; i < pages.size(); ++i)
+            {
+                if (pages[i] && !used[i])
+                {
+                    delete[] pages[i];
+                    pages[i] = nullptr;
+                    ++released;
+                }
+            }
+
+            while (!pages.empty() && !pages.back())
+                pages.pop_back();
+
+            dense.shrink_to_fit();
+            return released;
+        }
+    };
+
+} // namespace hgl::ecs
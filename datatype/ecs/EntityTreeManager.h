@@ -147,11 +147,14 @@ namespace hgl::ecs
             if (node_map.ContainsKey(entity_id))
                 return false;
 
+            // node_map.Add可能使parent_node_ptr失效，先取出节点
+            TreeNode* parent_node = *parent_node_ptr;
+
             TreeNode* node = new TreeNode();
             node->Init(entity_id, parent_id);
 
             node_map.Add(entity_id, node);
-            (*parent_node_ptr)->children.Add(entity_id);
+            parent_node->children.Add(entity_id);
 
             return true;
         }
@@ -300,12 +303,12 @@ namespace hgl::ecs
         void Clear() override
         {
             // 删除所有节点
-            auto** nodes = node_map.GetDataList();
+            auto** pairs = node_map.GetDataList();         // CN: 键值对指针数组 / EN: Array of key/value pair pointers
             int count = node_map.GetCount();
 
             for (int i = 0; i < count; ++i)
             {
-                delete nodes[i];
+                delete pairs[i]->value;
             }
 
             node_map.Clear();
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "EntityPool.h"
+#include<atomic>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+#include<vector>
+
+namespace hgl::ecs
+{
+    using EventTypeID = uint32;
+    constexpr const EventTypeID EVENT_TYPE_INVALID = 0xFFFFFFFF;
+
+    namespace event_detail
+    {
+        inline EventTypeID NextTypeID()
+        {
+            static std::atomic<EventTypeID> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template<typename E> EventTypeID TypeID()
+        {
+            static const EventTypeID id = NextTypeID();
+            return id;
+        }
+    }
+
+    /**
+     * CN: 获取事件类型编号，编号按首次使用的顺序从0开始分配，与组件类型编号互不相干
+     * EN: Get the event type ID, IDs are assigned from 0 in order of first use, independent of component type IDs
+     */
+    template<typename E>
+    EventTypeID GetEventTypeID()
+    {
+        return event_detail::TypeID<std::remove_cv_t<E>>();
+    }
+
+    /**
+     * CN: 事件队列的类型擦除接口，供EventBus统一调整与交换
+     * EN: Type-erased event queue interface, lets EventBus resize and swap every queue alike
+     */
+    class IEventQueue
+    {
+    public:
+
+        virtual ~IEventQueue() = default;
+
+        virtual void Resize(uint32 thread_count) = 0;
+        virtual void Swap() = 0;
+        virtual void Clear() = 0;
+    };
+
+    /**
+     * CN: 类型化的双缓冲事件队列
+     * EN: Typed double-buffered event queue
+     *
+     * CN: 写入端每个线程一个追加缓冲区，各线程只写自己的缓冲区，不需要加锁或原子操作。
+     *     Swap（帧末同步点）把所有写入缓冲区按线程顺序合并为一个连续数组，成为读取端，写入缓冲区清空后保留容量。
+     *     所以本帧发送的事件在下一帧被读取，读取期间数组不变，任意多个系统可以并发读取，也可以按下标拆给多个线程。
+     *     同一线程发送的事件保持发送顺序。
+     * EN: The write side has one append buffer per thread; every thread only writes its own buffer, so no locks
+     *     or atomics are needed.
+     *     Swap (the end-of-frame sync point) merges all write buffers in thread order into one contiguous array that
+     *     becomes the read side; write buffers are cleared but keep their capacity.
+     *     Events sent in one frame are therefore read in the next; the array does not change while being read, so
+     *     any number of systems may read it concurrently or split it by index across threads.
+     *     Events sent from one thread keep their order.
+     */
+    template<typename E>
+    class EventQueue : public IEventQueue
+    {
+        // 按缓存行对齐，不同线程的vector头部不会落在同一缓存行上
+        struct alignas(64) WriteBuffer
+        {
+            std::vector<E> event_list;
+        };
+
+        std::vector<WriteBuffer*> buffer_list;
+        std::vector<E> read_list;
+
+    public:
+
+        EventQueue(uint32 thread_count = 1)
+        {
+            Resize(thread_count);
+        }
+
+        ~EventQueue() override
+        {
+            for (WriteBuffer* buffer : buffer_list)
+                delete buffer;
+        }
+
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        /**
+         * CN: 调整写入缓冲区数量，只增不减，不可在发送事件期间调用
+         * EN: Grow the number of write buffers, never shrinks, must not be called while events are being sent
+         */
+        void Resize(uint32 thread_count) override
+        {
+            while (buffer_list.size() < thread_count)
+                buffer_list.push_back(new WriteBuffer);
+        }
+
+        uint32 GetBufferCount() const { return static_cast<uint32>(buffer_list.size()); }
+
+        void Send(uint32 thread_index, const E& event)
+        {
+            buffer_list[thread_index]->event_list.push_back(event);
+        }
+
+        void Send(uint32 thread_index, E&& event)
+        {
+            buffer_list[thread_index]->event_list.push_back(std::move(event));
+        }
+
+        template<typename... Args>
+        E& Emplace(uint32 thread_index, Args&&... args)
+        {
+            return buffer_list[thread_index]->event_list.emplace_back(std::forward<Args>(args)...);
+        }
+
+        /**
+         * CN: 已发送、等待下次Swap的事件数，只能在同步点调用
+         * EN: Events sent and waiting for the next Swap, only valid at a sync point
+         */
+        uint32 GetPendingCount() const
+        {
+            size_t count = 0;
+
+            for (const WriteBuffer* buffer : buffer_list)
+                count += buffer->event_list.size();
+
+            return static_cast<uint32>(count);
+        }
+
+        /**
+         * CN: 丢弃上一批可读事件，把写入缓冲区合并为新的一批
+         * EN: Drop the previous readable batch and merge the write buffers into a new one
+         */
+        void Swap() override
+        {
+            read_list.clear();
+            read_list.reserve(GetPendingCount());
+
+            for (WriteBuffer* buffer : buffer_list)
+            {
+                read_list.insert(read_list.end(),
+                                 std::make_move_iterator(buffer->event_list.begin()),
+                                 std::make_move_iterator(buffer->event_list.end()));
+                buffer->event_list.clear();
+            }
+        }
+
+        void Clear() override
+        {
+            read_list.clear();
+
+            for (WriteBuffer* buffer : buffer_list)
+                buffer->event_list.clear();
+        }
+
+        // 读取端：上一次Swap合并的事件，连续存放
+
+        const E* GetData() const { return read_list.data(); }
+        uint32 GetCount() const { return static_cast<uint32>(read_list.size()); }
+        bool IsEmpty() const { return read_list.empty(); }
+
+        const E& operator[](uint32 index) const { return read_list[index]; }
+
+        const E* begin() const { return read_list.data(); }
+        const E* end() const { return read_list.data() + read_list.size(); }
+    };
+
+    /**
+     * CN: 事件总线：按事件类型编号保存各类型的事件队列
+     * EN: Event bus: holds one event queue per event type, indexed by event type ID
+     *
+     * CN: 事件类型须在开始运行系统之前登记(Register)，运行期间只查找，不创建队列。
+     * EN: Event types must be registered before systems start running; while running queues are only looked up, never created.
+     */
+    class EventBus
+    {
+        std::vector<IEventQueue*> queue_list;           ///< CN: 以EventTypeID为下标，未登记为nullptr / EN: Indexed by EventTypeID, nullptr when unregistered
+        uint32 thread_count;
+
+    public:
+
+        EventBus(uint32 threads = 1) : thread_count(threads) {}
+
+        ~EventBus()
+        {
+            for (IEventQueue* queue : queue_list)
+                delete queue;
+        }
+
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        template<typename E>
+        EventQueue<std::remove_cv_t<E>>& Register()
+        {
+            const EventTypeID id = GetEventTypeID<E>();
+
+            if (id >= queue_list.size())
+                queue_list.resize(id + 1, nullptr);
+
+            if (!queue_list[id])
+                queue_list[id] = new EventQueue<std::remove_cv_t<E>>(thread_count);
+
+            return *static_cast<EventQueue<std::remove_cv_t<E>>*>(queue_list[id]);
+        }
+
+        /**
+         * CN: 查找已登记的队列，未登记返回nullptr
+         * EN: Find a registered queue, nullptr if unregistered
+         */
+        template<typename E>
+        EventQueue<std::remove_cv_t<E>>* Find() const
+        {
+            const EventTypeID id = GetEventTypeID<E>();
+
+            return id < queue_list.size() ? static_cast<EventQueue<std::remove_cv_t<E>>*>(queue_list[id]) : nullptr;
+        }
+
+        /**
+         * CN: 调整所有队列的写入缓冲区数量，只增不减
+         * EN: Grow the write buffers of every queue, never shrinks
+         */
+        void Resize(uint32 threads)
+        {
+            if (threads <= thread_count)
+                return;
+
+            thread_count = threads;
+
+            for (IEventQueue* queue : queue_list)
+                if (queue)
+                    queue->Resize(thread_count);
+        }
+
+        uint32 GetThreadCount() const { return thread_count; }
+
+        /**
+         * CN: 交换所有队列，本帧发送的事件变为可读
+         * EN: Swap every queue, events sent this frame become readable
+         */
+        void Swap()
+        {
+            for (IEventQueue* queue : queue_list)
+                if (queue)
+                    queue->Swap();
+        }
+
+        void Clear()
+        {
+            for (IEventQueue* queue : queue_list)
+                if (queue)
+                    queue->Clear();
+        }
+    };
+
+} // namespace hgl::ecs
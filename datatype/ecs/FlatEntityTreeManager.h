@@ -0,0 +1,477 @@
+#pragma once
+
+#include "IEntityManager.h"
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 扁平树形实体管理器
+     * EN: Flat tree-based entity manager
+     *
+     * CN: 与EntityTreeManager功能相同，但不为每个节点分配TreeNode，也不经由Map查找：
+     *     - 层级关系存放在以实体槽位下标(GetEntityIndex)为下标的SoA数组中：parent、first_child、last_child、next_sibling、prev_sibling，
+     *       增删节点与移动子树都只改几个链接，为O(1)（移动子树另需O(深度)的环检查）。
+     *     - 需要按层级顺序遍历时，把整片森林展开成线性数组：每棵根的子树占一段连续区间，区间内按深度排序，
+     *       父节点总在子节点之前。层级变换可以在这些数组上一次线性完成，各根区间互不依赖，可以并行。
+     *     - 线性数组在结构变化后的第一次访问时重建一次，所以连续的多次移动只付出一次重建的代价。
+     * EN: Same features as EntityTreeManager without a heap TreeNode per node or Map lookups:
+     *     - The hierarchy lives in SoA arrays indexed by the entity slot index (GetEntityIndex): parent, first_child,
+     *       last_child, next_sibling, prev_sibling. Adding/removing nodes and moving subtrees only relinks, O(1)
+     *       (moves add an O(depth) cycle check).
+     *     - For ordered traversal the forest is flattened into linear arrays: every root subtree is one contiguous
+     *       range sorted by depth, parents always precede children. Hierarchical transforms are one linear pass over
+     *       these arrays and root ranges are independent, so they can run in parallel.
+     *     - The linear arrays are rebuilt once on the first access after a structural change, so a batch of moves
+     *       pays for a single rebuild.
+     */
+    class FlatEntityTreeManager : public IEntityManager
+    {
+    public:
+
+        static constexpr uint32 NONE = 0xFFFFFFFF;
+
+        /**
+         * CN: 线性数组中的半开区间[begin, end)
+         * EN: Half-open range [begin, end) in the linear arrays
+         */
+        struct Range
+        {
+            uint32 begin;
+            uint32 end;
+        };
+
+    private:
+
+        // 以实体槽位下标为下标的链接表
+        std::vector<EntityID> slot_entity;              ///< CN: 槽位中的实体，不在树中为ENTITY_ID_INVALID / EN: Entity in the slot, ENTITY_ID_INVALID when not in the tree
+        std::vector<uint32> parent;
+        std::vector<uint32> first_child;
+        std::vector<uint32> last_child;
+        std::vector<uint32> next_sibling;
+        std::vector<uint32> prev_sibling;
+
+        uint32 root_first = NONE;                       ///< CN: 根节点同样以兄弟链表相连 / EN: Roots are linked as siblings too
+        uint32 root_last = NONE;
+        uint32 node_count = 0;
+        uint32 root_count = 0;
+
+        // 按层级展开的线性数组
+        bool order_dirty = false;
+        uint32 order_version = 0;                       ///< CN: 每次重建加1 / EN: Incremented on every rebuild
+        std::vector<EntityID> linear_entity;
+        std::vector<uint32> linear_parent;              ///< CN: 父节点在线性数组中的位置，根为NONE / EN: Linear index of the parent, NONE for roots
+        std::vector<uint32> linear_depth;
+        std::vector<uint32> slot_to_linear;
+        std::vector<Range> root_ranges;
+
+        std::vector<uint32> scratch;
+
+        uint32 FindSlot(const EntityID entity_id) const
+        {
+            const uint32 slot = GetEntityIndex(entity_id);
+
+            if (entity_id == ENTITY_ID_INVALID || slot >= slot_entity.size() || slot_entity[slot] != entity_id)
+                return NONE;
+
+            return slot;
+        }
+
+        void EnsureSlot(uint32 slot)
+        {
+            if (slot < slot_entity.size())
+                return;
+
+            const size_t size = slot + 1;
+
+            slot_entity.resize(size, ENTITY_ID_INVALID);
+            parent.resize(size, NONE);
+            first_child.resize(size, NONE);
+            last_child.resize(size, NONE);
+            next_sibling.resize(size, NONE);
+            prev_sibling.resize(size, NONE);
+        }
+
+        /**
+         * CN: 把slot接到p的子节点链表末尾，p为NONE时接到根链表
+         * EN: Append slot to the child list of p, or to the root list when p is NONE
+         */
+        void Link(uint32 slot, uint32 p)
+        {
+            uint32& head = (p == NONE) ? root_first : first_child[p];
+            uint32& tail = (p == NONE) ? root_last : last_child[p];
+
+            parent[slot] = p;
+            prev_sibling[slot] = tail;
+            next_sibling[slot] = NONE;
+
+            if (tail != NONE)
+                next_sibling[tail] = slot;
+            else
+                head = slot;
+
+            tail = slot;
+
+            if (p == NONE)
+                ++root_count;
+        }
+
+        void Unlink(uint32 slot)
+        {
+            const uint32 p = parent[slot];
+            uint32& head = (p == NONE) ? root_first : first_child[p];
+            uint32& tail = (p == NONE) ? root_last : last_child[p];
+
+            if (prev_sibling[slot] != NONE)
+                next_sibling[prev_sibling[slot]] = next_sibling[slot];
+            else
+                head = next_sibling[slot];
+
+            if (next_sibling[slot] != NONE)
+                prev_sibling[next_sibling[slot]] = prev_sibling[slot];
+            else
+                tail = prev_sibling[slot];
+
+            parent[slot] = NONE;
+            prev_sibling[slot] = NONE;
+            next_sibling[slot] = NONE;
+
+            if (p == NONE)
+                --root_count;
+        }
+
+        void ClearSlot(uint32 slot)
+        {
+            slot_entity[slot] = ENTITY_ID_INVALID;
+            parent[slot] = NONE;
+            first_child[slot] = NONE;
+            last_child[slot] = NONE;
+            next_sibling[slot] = NONE;
+            prev_sibling[slot] = NONE;
+        }
+
+        /**
+         * CN: 按广度优先把slot的子树追加到scratch，不递归
+         * EN: Append the subtree of slot to scratch breadth first, without recursion
+         */
+        void CollectSubtree(uint32 slot)
+        {
+            scratch.clear();
+            scratch.push_back(slot);
+
+            for (size_t i = 0; i < scratch.size(); ++i)
+                for (uint32 c = first_child[scratch[i]]; c != NONE; c = next_sibling[c])
+                    scratch.push_back(c);
+        }
+
+        bool AddNode(const EntityID entity_id, uint32 parent_slot)
+        {
+            if (!entity_pool || !entity_pool->Contains(entity_id) || FindSlot(entity_id) != NONE)
+                return false;
+
+            const uint32 slot = GetEntityIndex(entity_id);
+
+            EnsureSlot(slot);
+
+            if (slot_entity[slot] != ENTITY_ID_INVALID)         // 槽位仍被已销毁的旧实体占用
+                return false;
+
+            slot_entity[slot] = entity_id;
+            Link(slot, parent_slot);
+
+            ++node_count;
+            order_dirty = true;
+            return true;
+        }
+
+    public:
+
+        FlatEntityTreeManager(EntityPool* pool) : IEntityManager(pool) {}
+        ~FlatEntityTreeManager() override = default;
+
+        bool Add(const EntityID entity_id) override
+        {
+            return AddAsRoot(entity_id);
+        }
+
+        bool AddAsRoot(const EntityID entity_id)
+        {
+            return AddNode(entity_id, NONE);
+        }
+
+        bool AddAsChild(const EntityID entity_id, const EntityID parent_id)
+        {
+            const uint32 parent_slot = FindSlot(parent_id);
+
+            if (parent_slot == NONE)
+                return false;
+
+            return AddNode(entity_id, parent_slot);
+        }
+
+        /**
+         * CN: 移除实体及其所有子节点
+         * EN: Remove entity and all its children
+         */
+        bool Remove(const EntityID entity_id) override
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE)
+                return false;
+
+            Unlink(slot);
+            CollectSubtree(slot);
+
+            for (uint32 s : scratch)
+                ClearSlot(s);
+
+            node_count -= static_cast<uint32>(scratch.size());
+            order_dirty = true;
+            return true;
+        }
+
+        /**
+         * CN: 仅移除实体，将其子节点提升到父节点
+         * EN: Remove entity only, promote its children to parent
+         */
+        bool RemoveOnly(const EntityID entity_id)
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE)
+                return false;
+
+            const uint32 p = parent[slot];
+
+            for (uint32 c = first_child[slot]; c != NONE; )
+            {
+                const uint32 next = next_sibling[c];
+
+                Link(c, p);
+                c = next;
+            }
+
+            first_child[slot] = NONE;
+            last_child[slot] = NONE;
+
+            Unlink(slot);
+            ClearSlot(slot);
+
+            --node_count;
+            order_dirty = true;
+            return true;
+        }
+
+        /**
+         * CN: 把实体连同子树移到新的父节点下，new_parent为ENTITY_ID_INVALID时变为根节点。
+         *     只修改链接，线性数组在下次访问时统一重建，所以多次移动可以连续调用。
+         * EN: Move an entity with its subtree under a new parent, or make it a root when new_parent is ENTITY_ID_INVALID.
+         *     Only links change, the linear arrays are rebuilt once on next access, so many moves can be issued in a row.
+         * @return CN: 实体或新父节点不在树中、或新父节点位于该子树内时返回false
+         *         EN: false if either node is not in the tree or the new parent lies inside the subtree
+         */
+        bool SetParent(const EntityID entity_id, const EntityID new_parent)
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE)
+                return false;
+
+            uint32 parent_slot = NONE;
+
+            if (new_parent != ENTITY_ID_INVALID)
+            {
+                parent_slot = FindSlot(new_parent);
+
+                if (parent_slot == NONE)
+                    return false;
+
+                for (uint32 p = parent_slot; p != NONE; p = parent[p])
+                    if (p == slot)
+                        return false;
+            }
+
+            if (parent[slot] == parent_slot)
+                return true;
+
+            Unlink(slot);
+            Link(slot, parent_slot);
+
+            order_dirty = true;
+            return true;
+        }
+
+        bool Contains(const EntityID entity_id) const override
+        {
+            return FindSlot(entity_id) != NONE;
+        }
+
+        int GetCount() const override { return static_cast<int>(node_count); }
+        int GetRootCount() const { return static_cast<int>(root_count); }
+
+        int GetChildCount(const EntityID entity_id) const
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE)
+                return 0;
+
+            int count = 0;
+
+            for (uint32 c = first_child[slot]; c != NONE; c = next_sibling[c])
+                ++count;
+
+            return count;
+        }
+
+        EntityID GetParent(const EntityID entity_id) const
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE || parent[slot] == NONE)
+                return ENTITY_ID_INVALID;
+
+            return slot_entity[parent[slot]];
+        }
+
+        bool IsRoot(const EntityID entity_id) const
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            return slot != NONE && parent[slot] == NONE;
+        }
+
+        void Clear() override
+        {
+            slot_entity.clear();
+            parent.clear();
+            first_child.clear();
+            last_child.clear();
+            next_sibling.clear();
+            prev_sibling.clear();
+
+            root_first = root_last = NONE;
+            node_count = root_count = 0;
+
+            linear_entity.clear();
+            linear_parent.clear();
+            linear_depth.clear();
+            slot_to_linear.clear();
+            root_ranges.clear();
+            order_dirty = false;
+            ++order_version;
+        }
+
+        /**
+         * CN: 按线性顺序遍历（父节点先于子节点）
+         * EN: Iterate in linear order (parents before children)
+         */
+        void Iterate(IterateFunc func, void* user_data = nullptr) override
+        {
+            if (!func)
+                return;
+
+            UpdateOrder();
+
+            for (const EntityID id : linear_entity)
+                func(id, user_data);
+        }
+
+        void IterateChildren(EntityID entity_id, IterateFunc func, void* user_data = nullptr)
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (!func || slot == NONE)
+                return;
+
+            for (uint32 c = first_child[slot]; c != NONE; c = next_sibling[c])
+                func(slot_entity[c], user_data);
+        }
+
+        /**
+         * CN: 结构变化后重建线性数组，否则什么也不做
+         * EN: Rebuild the linear arrays after structural changes, does nothing otherwise
+         */
+        void UpdateOrder()
+        {
+            if (!order_dirty)
+                return;
+
+            linear_entity.resize(node_count);
+            linear_parent.resize(node_count);
+            linear_depth.resize(node_count);
+            slot_to_linear.assign(slot_entity.size(), NONE);
+            root_ranges.clear();
+
+            scratch.resize(node_count);                     // scratch[i]为线性位置i的槽位，兼作广度优先队列
+
+            uint32 count = 0;
+
+            for (uint32 root = root_first; root != NONE; root = next_sibling[root])
+            {
+                const uint32 begin = count;
+
+                scratch[count] = root;
+                linear_parent[count] = NONE;
+                linear_depth[count] = 0;
+                ++count;
+
+                for (uint32 i = begin; i < count; ++i)
+                {
+                    const uint32 slot = scratch[i];
+
+                    linear_entity[i] = slot_entity[slot];
+                    slot_to_linear[slot] = i;
+
+                    for (uint32 c = first_child[slot]; c != NONE; c = next_sibling[c])
+                    {
+                        scratch[count] = c;
+                        linear_parent[count] = i;
+                        linear_depth[count] = linear_depth[i] + 1;
+                        ++count;
+                    }
+                }
+
+                root_ranges.push_back({begin, count});
+            }
+
+            order_dirty = false;
+            ++order_version;
+        }
+
+        bool IsOrderDirty() const { return order_dirty; }
+
+        /**
+         * CN: 线性数组的版本，每次重建或清空后改变，缓存了线性位置的使用者据此判断是否失效
+         * EN: Version of the linear arrays, changes on every rebuild or Clear; users caching linear indices compare it to detect invalidation
+         */
+        uint32 GetOrderVersion() { UpdateOrder(); return order_version; }
+
+        /**
+         * CN: 以下线性数组访问会先调用UpdateOrder，返回的数据在下一次结构变化前有效
+         * EN: The linear accessors below call UpdateOrder first, data stays valid until the next structural change
+         */
+        uint32 GetLinearCount() { UpdateOrder(); return static_cast<uint32>(linear_entity.size()); }
+        const EntityID* GetLinearEntities() { UpdateOrder(); return linear_entity.data(); }
+        const uint32* GetLinearParents() { UpdateOrder(); return linear_parent.data(); }
+        const uint32* GetLinearDepths() { UpdateOrder(); return linear_depth.data(); }
+        const std::vector<Range>& GetRootRanges() { UpdateOrder(); return root_ranges; }
+
+        /**
+         * CN: 实体在线性数组中的位置，不在树中返回NONE
+         * EN: Position of an entity in the linear arrays, NONE if not in the tree
+         */
+        uint32 GetLinearIndex(const EntityID entity_id)
+        {
+            const uint32 slot = FindSlot(entity_id);
+
+            if (slot == NONE)
+                return NONE;
+
+            UpdateOrder();
+            return slot_to_linear[slot];
+        }
+    };
+
+} // namespace hgl::ecs
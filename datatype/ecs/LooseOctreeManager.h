@@ -0,0 +1,493 @@
+#pragma once
+
+#include "IEntityManager.h"
+#include "EntitySparseSet.h"
+#include<hgl/math/VectorTypes.h>
+#include<hgl/math/geometry/AABB.h>
+#include<hgl/math/geometry/Frustum.h>
+#include<algorithm>
+#include<cmath>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 三维松散八叉树空间管理器
+     * EN: 3D loose octree spatial manager
+     *
+     * CN: 每个实体是一个包围球(中心+半径)。节点的松散范围是格子向每边各扩大半个格子(松散系数2)，
+     *     所以半径不超过半格、中心落在格子里的球一定在松散范围内：
+     *     - 插入时由半径直接算出深度、由中心算出格子，不需要逐层比较，子节点按需创建
+     *     - Update时若深度与格子都没变只改坐标，否则从旧节点摘下挂到新节点，都是O(深度)
+     *     - 查询按松散范围剪枝，整个节点都在查询范围内时不再逐个测试
+     *     中心在世界范围之外的实体挂在根节点上，根节点的实体总是逐个测试。
+     * EN: Every entity is a bounding sphere (center + radius). The loose bounds of a node are its cell grown by
+     *     half a cell on every side (loose factor 2), so any sphere with a radius up to half a cell and its center
+     *     in the cell lies inside them:
+     *     - Insertion computes the depth from the radius and the cell from the center directly, without testing
+     *       level by level; children are created on demand
+     *     - Update only writes the position when depth and cell stay the same, otherwise it unlinks the entity and
+     *       links it into the new node, O(depth) either way
+     *     - Queries prune by the loose bounds and stop testing one by one once a whole node is inside the query
+     *     Entities centered outside the world bounds hang on the root, whose entities are always tested singly.
+     */
+    class LooseOctreeManager : public IEntityManager
+    {
+    public:
+
+        static constexpr uint32 NONE = 0xFFFFFFFF;
+        static constexpr uint32 MAX_DEPTH_LIMIT = 20;
+
+    private:
+
+        struct Node
+        {
+            uint32 depth;
+            uint32 cell[3];                             ///< CN: 该深度上的格子坐标 / EN: Cell coordinates at this depth
+            uint32 parent;
+            uint32 child[8];
+            uint32 subtree_count;                       ///< CN: 本节点及子孙中的实体数 / EN: Entities in this node and below
+            math::Vector3f loose_min;
+            math::Vector3f loose_max;
+            std::vector<uint32> items;                  ///< CN: 挂在本节点的实体紧密下标 / EN: Dense indices of the entities on this node
+        };
+
+        math::Vector3f world_min;
+        float world_size;
+        uint32 max_depth;
+
+        EntitySparseSet entity_set;
+        std::vector<math::Vector3f> position_list;      ///< CN: 按紧密下标 / EN: By dense index
+        std::vector<float> radius_list;
+        std::vector<uint32> node_of;                    ///< CN: 实体所在节点 / EN: Node of the entity
+        std::vector<uint32> node_slot;                  ///< CN: 实体在节点items中的位置 / EN: Position inside the node's items
+
+        std::vector<Node> node_list;                    ///< CN: [0]为根 / EN: [0] is the root
+
+        uint32 NewNode(uint32 parent, uint32 depth, uint32 cx, uint32 cy, uint32 cz)
+        {
+            Node node;
+            const float size = world_size / float(1u << depth);
+            const float loose = size * 0.5f;
+
+            node.depth = depth;
+            node.cell[0] = cx;
+            node.cell[1] = cy;
+            node.cell[2] = cz;
+            node.parent = parent;
+            std::fill(node.child, node.child + 8, NONE);
+            node.subtree_count = 0;
+            node.loose_min = math::Vector3f(world_min.x + cx * size - loose, world_min.y + cy * size - loose, world_min.z + cz * size - loose);
+            node.loose_max = math::Vector3f(world_min.x + (cx + 1) * size + loose, world_min.y + (cy + 1) * size + loose, world_min.z + (cz + 1) * size + loose);
+
+            node_list.push_back(std::move(node));
+            return static_cast<uint32>(node_list.size() - 1);
+        }
+
+        /**
+         * CN: 计算包围球应挂的深度与格子
+         * EN: Compute the depth and cell a bounding sphere belongs to
+         */
+        void Locate(const math::Vector3f& pos, float radius, uint32& depth, uint32 cell[3]) const
+        {
+            const float rel[3] = { pos.x - world_min.x, pos.y - world_min.y, pos.z - world_min.z };
+
+            depth = 0;
+            cell[0] = cell[1] = cell[2] = 0;
+
+            for (int i = 0; i < 3; ++i)
+                if (!(rel[i] >= 0 && rel[i] < world_size))      // 世界之外(含NaN)挂在根上
+                    return;
+
+            // 深度d的半格为world_size/2^(d+1)，取半格不小于半径的最深一层
+            while (depth < max_depth && world_size / float(4u << depth) >= radius)
+                ++depth;
+
+            const float scale = float(1u << depth) / world_size;
+            const uint32 limit = (1u << depth) - 1;
+
+            for (int i = 0; i < 3; ++i)
+                cell[i] = std::min(static_cast<uint32>(rel[i] * scale), limit);
+        }
+
+        void Link(uint32 index, uint32 depth, const uint32 cell[3])
+        {
+            uint32 node = 0;
+
+            ++node_list[0].subtree_count;
+
+            for (uint32 d = 1; d <= depth; ++d)
+            {
+                const uint32 shift = depth - d;
+                const uint32 cx = cell[0] >> shift, cy = cell[1] >> shift, cz = cell[2] >> shift;
+                const uint32 octant = (cx & 1) | ((cy & 1) << 1) | ((cz & 1) << 2);
+
+                uint32 child = node_list[node].child[octant];
+
+                if (child == NONE)
+                {
+                    child = NewNode(node, d, cx, cy, cz);
+                    node_list[node].child[octant] = child;
+                }
+
+                node = child;
+                ++node_list[node].subtree_count;
+            }
+
+            std::vector<uint32>& items = node_list[node].items;
+
+            node_of[index] = node;
+            node_slot[index] = static_cast<uint32>(items.size());
+            items.push_back(index);
+        }
+
+        void Unlink(uint32 index)
+        {
+            Node& node = node_list[node_of[index]];
+            const uint32 slot = node_slot[index];
+
+            node.items[slot] = node.items.back();
+            node_slot[node.items[slot]] = slot;
+            node.items.pop_back();
+
+            for (uint32 n = node_of[index]; n != NONE; n = node_list[n].parent)
+                --node_list[n].subtree_count;
+        }
+
+        void CollectSubtree(uint32 node, std::vector<EntityID>& result) const
+        {
+            const Node& n = node_list[node];
+
+            for (const uint32 index : n.items)
+                result.push_back(entity_set.GetEntity(index));
+
+            for (const uint32 child : n.child)
+                if (child != NONE && node_list[child].subtree_count)
+                    CollectSubtree(child, result);
+        }
+
+        /**
+         * CN: 通用查询。test_node返回节点松散范围与查询的关系，test_item测试单个包围球
+         * EN: Generic query. test_node classifies a node's loose bounds against the query, test_item tests one sphere
+         */
+        template<typename NodeTest, typename ItemTest>
+        int Query(std::vector<EntityID>& result, NodeTest&& test_node, ItemTest&& test_item) const
+        {
+            const size_t start = result.size();
+
+            if (node_list[0].subtree_count == 0)
+                return 0;
+
+            uint32 stack[MAX_DEPTH_LIMIT * 8 + 8];
+            int top = 0;
+
+            stack[top++] = 0;
+
+            while (top > 0)
+            {
+                const uint32 node = stack[--top];
+                const Node& n = node_list[node];
+
+                math::Frustum::Scope scope = math::Frustum::Scope::INTERSECT;
+
+                if (node != 0)                                  // 根上可能有世界之外的实体，不按范围判断
+                {
+                    scope = test_node(n.loose_min, n.loose_max);
+
+                    if (scope == math::Frustum::Scope::OUTSIDE)
+                        continue;
+
+                    if (scope == math::Frustum::Scope::INSIDE)
+                    {
+                        CollectSubtree(node, result);
+                        continue;
+                    }
+                }
+
+                for (const uint32 index : n.items)
+                    if (test_item(position_list[index], radius_list[index]))
+                        result.push_back(entity_set.GetEntity(index));
+
+                for (const uint32 child : n.child)
+                    if (child != NONE && node_list[child].subtree_count)
+                        stack[top++] = child;
+            }
+
+            return static_cast<int>(result.size() - start);
+        }
+
+    public:
+
+        /**
+         * @param min CN: 世界范围的最小角 / EN: Minimum corner of the world
+         * @param size CN: 世界范围的边长(立方体) / EN: Edge length of the (cubic) world
+         * @param depth CN: 最大深度，取使最深一层每格平均有十几个实体的值，过深时节点稀疏，查询反而变慢 /
+         *              EN: Maximum depth; pick one that leaves a dozen or so entities per deepest cell on average,
+         *              deeper trees are sparse and query slower
+         */
+        LooseOctreeManager(EntityPool* pool, const math::Vector3f& min, float size, uint32 depth = 5)
+            : IEntityManager(pool)
+            , world_min(min)
+            , world_size(size > 0 ? size : 1.0f)
+            , max_depth(std::min(depth, MAX_DEPTH_LIMIT))
+        {
+            NewNode(NONE, 0, 0, 0, 0);
+        }
+
+        ~LooseOctreeManager() override = default;
+
+        int GetNodeCount() const { return static_cast<int>(node_list.size()); }
+
+        /**
+         * CN: 以原点、半径0加入
+         * EN: Add at the origin with radius 0
+         */
+        bool Add(const EntityID entity_id) override
+        {
+            return Add(entity_id, math::Vector3f(0, 0, 0), 0);
+        }
+
+        bool Add(const EntityID entity_id, const math::Vector3f& position, float radius = 0)
+        {
+            if (!entity_pool || !entity_pool->Contains(entity_id))
+                return false;
+
+            const uint32 index = entity_set.Insert(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            position_list.push_back(position);
+            radius_list.push_back(radius);
+            node_of.push_back(0);
+            node_slot.push_back(0);
+
+            uint32 depth, cell[3];
+
+            Locate(position, radius, depth, cell);
+            Link(index, depth, cell);
+            return true;
+        }
+
+        bool Remove(const EntityID entity_id) override
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            Unlink(index);
+
+            uint32 removed = 0;
+            entity_set.Remove(entity_id, removed);
+
+            // 最后一项移入空位，它所在节点中的下标也要改
+            const uint32 last = static_cast<uint32>(position_list.size() - 1);
+
+            if (removed != last)
+            {
+                position_list[removed] = position_list[last];
+                radius_list[removed] = radius_list[last];
+                node_of[removed] = node_of[last];
+                node_slot[removed] = node_slot[last];
+
+                node_list[node_of[removed]].items[node_slot[removed]] = removed;
+            }
+
+            position_list.pop_back();
+            radius_list.pop_back();
+            node_of.pop_back();
+            node_slot.pop_back();
+            return true;
+        }
+
+        /**
+         * CN: 更新实体的包围球，深度与格子都没变时只改坐标
+         * EN: Update the entity's bounding sphere; only the position is written when depth and cell stay the same
+         */
+        bool Update(const EntityID entity_id, const math::Vector3f& position, float radius)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            position_list[index] = position;
+            radius_list[index] = radius;
+
+            uint32 depth, cell[3];
+
+            Locate(position, radius, depth, cell);
+
+            const Node& node = node_list[node_of[index]];
+
+            if (node.depth != depth || node.cell[0] != cell[0] || node.cell[1] != cell[1] || node.cell[2] != cell[2])
+            {
+                Unlink(index);
+                Link(index, depth, cell);
+            }
+
+            return true;
+        }
+
+        bool Update(const EntityID entity_id, const math::Vector3f& position)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index != EntitySparseSet::NPOS && Update(entity_id, position, radius_list[index]);
+        }
+
+        const math::Vector3f* GetPosition(const EntityID entity_id) const
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index == EntitySparseSet::NPOS ? nullptr : &position_list[index];
+        }
+
+        float GetRadius(const EntityID entity_id) const
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index == EntitySparseSet::NPOS ? 0 : radius_list[index];
+        }
+
+        bool Contains(const EntityID entity_id) const override
+        {
+            return entity_set.Contains(entity_id);
+        }
+
+        int GetCount() const override
+        {
+            return static_cast<int>(entity_set.GetCount());
+        }
+
+        /**
+         * CN: 清空实体并释放所有子节点
+         * EN: Clear entities and release all child nodes
+         */
+        void Clear() override
+        {
+            entity_set.Clear();
+            position_list.clear();
+            radius_list.clear();
+            node_of.clear();
+            node_slot.clear();
+            node_list.clear();
+
+            NewNode(NONE, 0, 0, 0, 0);
+        }
+
+        void Iterate(IterateFunc func, void* user_data = nullptr) override
+        {
+            if (!func)
+                return;
+
+            for (uint32 i = 0; i < entity_set.GetCount(); ++i)
+                func(entity_set.GetEntity(i), user_data);
+        }
+
+        /**
+         * CN: 查询包围球与球(center, radius)相交的实体，追加到result
+         * EN: Query entities whose bounding sphere intersects the sphere (center, radius), appended to result
+         * @return CN: 找到的数量 / EN: Number found
+         */
+        int QueryRadius(const math::Vector3f& center, float radius, std::vector<EntityID>& result) const
+        {
+            const float c[3] = { center.x, center.y, center.z };
+
+            return Query(result,
+                [&](const math::Vector3f& min, const math::Vector3f& max)
+                {
+                    const float lo[3] = { min.x, min.y, min.z };
+                    const float hi[3] = { max.x, max.y, max.z };
+                    float near_d2 = 0, far_d2 = 0;
+
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        const float dn = c[i] < lo[i] ? lo[i] - c[i] : (c[i] > hi[i] ? c[i] - hi[i] : 0);
+                        const float df = std::max(c[i] - lo[i], hi[i] - c[i]);
+
+                        near_d2 += dn * dn;
+                        far_d2 += df * df;
+                    }
+
+                    if (near_d2 > radius * radius)
+                        return math::Frustum::Scope::OUTSIDE;
+
+                    // 松散范围整个在查询球内，其中的包围球都与查询球相交
+                    return far_d2 <= radius * radius ? math::Frustum::Scope::INSIDE : math::Frustum::Scope::INTERSECT;
+                },
+                [&](const math::Vector3f& p, float r)
+                {
+                    const float dx = p.x - c[0], dy = p.y - c[1], dz = p.z - c[2];
+                    const float reach = radius + r;
+
+                    return dx * dx + dy * dy + dz * dz <= reach * reach;
+                });
+        }
+
+        /**
+         * CN: 查询包围球与box相交的实体，追加到result
+         * EN: Query entities whose bounding sphere intersects box, appended to result
+         */
+        int QueryAABB(const math::AABB& box, std::vector<EntityID>& result) const
+        {
+            const math::Vector3f bmin = box.GetMin();
+            const math::Vector3f bmax = box.GetMax();
+            const float lo[3] = { bmin.x, bmin.y, bmin.z };
+            const float hi[3] = { bmax.x, bmax.y, bmax.z };
+
+            return Query(result,
+                [&](const math::Vector3f& min, const math::Vector3f& max)
+                {
+                    const float nlo[3] = { min.x, min.y, min.z };
+                    const float nhi[3] = { max.x, max.y, max.z };
+                    bool inside = true;
+
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        if (nhi[i] < lo[i] || nlo[i] > hi[i])
+                            return math::Frustum::Scope::OUTSIDE;
+
+                        inside = inside && nlo[i] >= lo[i] && nhi[i] <= hi[i];
+                    }
+
+                    return inside ? math::Frustum::Scope::INSIDE : math::Frustum::Scope::INTERSECT;
+                },
+                [&](const math::Vector3f& p, float r)
+                {
+                    const float c[3] = { p.x, p.y, p.z };
+                    float d2 = 0;
+
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        const float d = c[i] < lo[i] ? lo[i] - c[i] : (c[i] > hi[i] ? c[i] - hi[i] : 0);
+                        d2 += d * d;
+                    }
+
+                    return d2 <= r * r;
+                });
+        }
+
+        /**
+         * CN: 查询包围球不完全在视锥体外的实体，追加到result
+         * EN: Query entities whose bounding sphere is not entirely outside the frustum, appended to result
+         */
+        int QueryFrustum(const math::Frustum& frustum, std::vector<EntityID>& result) const
+        {
+            return Query(result,
+                [&](const math::Vector3f& min, const math::Vector3f& max)
+                {
+                    math::AABB box;
+
+                    box.SetMinMax(min, max);
+                    return frustum.BoxIn(box);
+                },
+                [&](const math::Vector3f& p, float r)
+                {
+                    return frustum.SphereIn(p, r) != math::Frustum::Scope::OUTSIDE;
+                });
+        }
+    };
+
+} // namespace hgl::ecs
@@ -0,0 +1,707 @@
+#pragma once
+
+#include "EntityPool.h"
+#include "ComponentPool.h"
+#include<cstdio>
+#include<cstring>
+#include<functional>
+#include<string>
+#include<type_traits>
+#include<vector>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif//WIN32_LEAN_AND_MEAN
+    #include<windows.h>
+#else
+    #include<fcntl.h>
+    #include<sys/mman.h>
+    #include<sys/stat.h>
+    #include<unistd.h>
+#endif
+
+namespace hgl::ecs
+{
+    constexpr const uint32 SNAPSHOT_MAGIC = 0x53434548;        ///< "HECS"
+    constexpr const uint32 SNAPSHOT_FORMAT_VERSION = 1;
+    constexpr const size_t SNAPSHOT_BLOCK_ALIGN = 16;           ///< CN: 每个数据块的对齐 / EN: Alignment of every data block
+
+    /**
+     * CN: 快照写入流，数据追加到内存缓冲区
+     * EN: Snapshot write stream, appends to a memory buffer
+     */
+    class SnapshotWriter
+    {
+        std::vector<uint8> buffer;
+
+    public:
+
+        void Write(const void* data, size_t size)
+        {
+            const size_t pos = buffer.size();
+
+            buffer.resize(pos + size);
+
+            if (size)
+                memcpy(buffer.data() + pos, data, size);
+        }
+
+        template<typename T>
+        void WriteValue(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "WriteValue requires a trivially copyable type");
+            Write(&value, sizeof(T));
+        }
+
+        void WriteString(const std::string& str)
+        {
+            WriteValue(static_cast<uint32>(str.size()));
+            Write(str.data(), str.size());
+        }
+
+        /**
+         * CN: 补零到SNAPSHOT_BLOCK_ALIGN的整数倍，使下一个块可以按原位使用
+         * EN: Pad with zeros to a multiple of SNAPSHOT_BLOCK_ALIGN so the next block can be used in place
+         */
+        void Align()
+        {
+            buffer.resize((buffer.size() + SNAPSHOT_BLOCK_ALIGN - 1) & ~(SNAPSHOT_BLOCK_ALIGN - 1), 0);
+        }
+
+        /**
+         * CN: 预留位置，之后用Patch填写（如块长度）
+         * EN: Reserve room for a value filled in later with Patch (e.g. a block size)
+         */
+        template<typename T>
+        size_t Reserve()
+        {
+            const size_t pos = buffer.size();
+
+            buffer.resize(pos + sizeof(T), 0);
+            return pos;
+        }
+
+        template<typename T>
+        void Patch(size_t pos, const T& value)
+        {
+            memcpy(buffer.data() + pos, &value, sizeof(T));
+        }
+
+        size_t GetSize() const { return buffer.size(); }
+        const uint8* GetData() const { return buffer.data(); }
+
+        std::vector<uint8>& GetBuffer() { return buffer; }
+    };
+
+    /**
+     * CN: 快照读取流，直接读取内存中（读入或映射）的快照，越界后IsOK()为false，之后的读取都失败
+     * EN: Snapshot read stream over a snapshot in memory (read or mapped), IsOK() turns false on overrun and every later read fails
+     */
+    class SnapshotReader
+    {
+        const uint8* data;
+        size_t size;
+        size_t pos = 0;
+        bool ok = true;
+
+    public:
+
+        SnapshotReader(const void* d, size_t s) : data(static_cast<const uint8*>(d)), size(s) {}
+
+        bool IsOK() const { return ok; }
+        size_t GetPosition() const { return pos; }
+        size_t GetRemain() const { return ok ? size - pos : 0; }
+
+        /**
+         * CN: 取得接下来size字节的原位指针并跳过它们，越界返回nullptr
+         * EN: Get an in-place pointer to the next size bytes and skip them, nullptr on overrun
+         */
+        const void* Skip(size_t bytes)
+        {
+            if (!ok || bytes > size - pos)
+            {
+                ok = false;
+                return nullptr;
+            }
+
+            const void* p = data + pos;
+
+            pos += bytes;
+            return p;
+        }
+
+        bool Read(void* out, size_t bytes)
+        {
+            const void* p = Skip(bytes);
+
+            if (!p)
+                return false;
+
+            if (bytes)
+                memcpy(out, p, bytes);
+
+            return true;
+        }
+
+        template<typename T>
+        bool ReadValue(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "ReadValue requires a trivially copyable type");
+            return Read(&value, sizeof(T));
+        }
+
+        bool ReadString(std::string& str)
+        {
+            uint32 length;
+
+            if (!ReadValue(length))
+                return false;
+
+            const char* p = static_cast<const char*>(Skip(length));
+
+            if (!p)
+                return false;
+
+            str.assign(p, length);
+            return true;
+        }
+
+        void Align()
+        {
+            const size_t aligned = (pos + SNAPSHOT_BLOCK_ALIGN - 1) & ~(SNAPSHOT_BLOCK_ALIGN - 1);
+
+            Skip(aligned - pos);
+        }
+    };
+
+    /**
+     * CN: 非平凡组件的序列化，为组件类型特化：
+     * EN: Serialization of non-trivial components, specialize it for the component type:
+     *
+     *     template<> struct hgl::ecs::ComponentSerializer<NameComponent>
+     *     {
+     *         static constexpr uint32 VERSION = 2;
+     *
+     *         static void Save(SnapshotWriter& w, const NameComponent& c) { w.WriteString(c.name); }
+     *
+     *         static bool Load(SnapshotReader& r, NameComponent& c, uint32 version)  // version为写入时的VERSION
+     *         {
+     *             return r.ReadString(c.name);
+     *         }
+     *     };
+     *
+     * CN: 可平凡复制且没有特化的组件按原始字节块保存；特化后即使可平凡复制也走带版本的路径，用于需要兼容旧格式的类型。
+     * EN: Trivially copyable components without a specialization are saved as raw byte blocks; a specialization selects
+     *     the versioned path even for trivially copyable types, for types whose layout must stay loadable across changes.
+     */
+    template<typename T>
+    struct ComponentSerializer
+    {
+    };
+
+    namespace snapshot_detail
+    {
+        template<typename T, typename = void>
+        struct HasSerializer : std::false_type {};
+
+        template<typename T>
+        struct HasSerializer<T, std::void_t<decltype(ComponentSerializer<T>::VERSION)>> : std::true_type {};
+
+        enum class BlockKind : uint32
+        {
+            Raw = 0,            ///< CN: 实体ID块 + 组件原始字节块 / EN: Entity ID block + raw component bytes
+            Versioned = 1       ///< CN: 实体ID块 + ComponentSerializer写入的数据 / EN: Entity ID block + data written by ComponentSerializer
+        };
+
+        /**
+         * CN: 只读映射整个文件，不支持映射时读入内存（一次读取）
+         * EN: Map a whole file read-only, or read it into memory in one call where mapping is unavailable
+         */
+        class MappedFile
+        {
+            const void* data = nullptr;
+            size_t size = 0;
+            std::vector<uint8> fallback;
+
+#if defined(_WIN32)
+            HANDLE file = INVALID_HANDLE_VALUE;
+            HANDLE mapping = nullptr;
+#else
+            bool mapped = false;
+#endif
+
+            bool ReadAll(const std::string& filename)
+            {
+                FILE* fp = fopen(filename.c_str(), "rb");
+
+                if (!fp)
+                    return false;
+
+                fseek(fp, 0, SEEK_END);
+                const long length = ftell(fp);
+                fseek(fp, 0, SEEK_SET);
+
+                if (length > 0)
+                {
+                    fallback.resize(static_cast<size_t>(length));
+
+                    if (fread(fallback.data(), 1, fallback.size(), fp) != fallback.size())
+                        fallback.clear();
+                }
+
+                fclose(fp);
+
+                data = fallback.data();
+                size = fallback.size();
+                return size > 0;
+            }
+
+        public:
+
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile() { Close(); }
+
+            bool Open(const std::string& filename)
+            {
+                Close();
+
+#if defined(_WIN32)
+                file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+                if (file == INVALID_HANDLE_VALUE)
+                    return false;
+
+                LARGE_INTEGER length;
+
+                if (GetFileSizeEx(file, &length) && length.QuadPart > 0)
+                {
+                    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+                    if (mapping)
+                    {
+                        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                        size = static_cast<size_t>(length.QuadPart);
+                    }
+                }
+
+                if (data)
+                    return true;
+
+                Close();
+#else
+                const int fd = open(filename.c_str(), O_RDONLY);
+
+                if (fd < 0)
+                    return false;
+
+                struct stat st;
+
+                if (fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+                    if (p != MAP_FAILED)
+                    {
+                        data = p;
+                        size = static_cast<size_t>(st.st_size);
+                        mapped = true;
+                    }
+                }
+
+                close(fd);
+
+                if (mapped)
+                    return true;
+#endif
+
+                return ReadAll(filename);
+            }
+
+            void Close()
+            {
+#if defined(_WIN32)
+                if (data && fallback.empty())
+                    UnmapViewOfFile(data);
+
+                if (mapping)
+                    CloseHandle(mapping);
+
+                if (file != INVALID_HANDLE_VALUE)
+                    CloseHandle(file);
+
+                mapping = nullptr;
+                file = INVALID_HANDLE_VALUE;
+#else
+                if (mapped)
+                    munmap(const_cast<void*>(data), size);
+
+                mapped = false;
+#endif
+
+                fallback.clear();
+                data = nullptr;
+                size = 0;
+            }
+
+            const void* GetData() const { return data; }
+            size_t GetSize() const { return size; }
+        };
+    } // namespace snapshot_detail
+
+    /**
+     * CN: ECS世界快照
+     * EN: ECS world snapshot
+     *
+     * CN: 保存实体池与已登记的组件池，恢复时整体替换它们的内容。
+     *     - 可平凡复制的组件写成原始字节块：实体ID块与组件块各一段，块按16字节对齐。
+     *       稀疏集合存储的池直接写出紧密数组，恢复时经AssignRaw一次拷贝并重建稀疏索引，不逐个Add。
+     *     - 其它组件（或特化了ComponentSerializer的组件）逐个经ComponentSerializer写入，带版本号，恢复时把版本交给Load。
+     *     - 实体池保存各槽位的代数、标志位与空闲列表，恢复后原有的EntityID仍然有效，之后Create复用槽位的顺序也与保存时相同。
+     *     - 组件池按名称匹配：快照中未登记的块被跳过，登记了但快照中没有的池被清空。
+     *     - LoadFromFile映射整个文件（不支持时一次读入），各块原位读取。
+     *     Entity的user_data是运行时指针，不保存，恢复后为nullptr。
+     * EN: Saves the entity pool and the registered component pools, restoring replaces their whole content.
+     *     - Trivially copyable components are written as raw byte blocks: one entity ID block and one component block,
+     *       each aligned to 16 bytes. Sparse-set pools write their dense arrays directly and restore them through
+     *       AssignRaw in one copy plus a sparse index rebuild, without per-entity Add calls.
+     *     - Other components (or components with a ComponentSerializer specialization) go through ComponentSerializer
+     *       one by one with a version number that is handed back to Load.
+     *     - The entity pool stores every slot's generation, flags and the free list, so existing EntityIDs stay valid
+     *       after a restore and later Create calls reuse slots in the same order as before saving.
+     *     - Component pools are matched by name: blocks without a registered pool are skipped, registered pools missing
+     *       from the snapshot are cleared.
+     *     - LoadFromFile maps the whole file (or reads it in one call where mapping is unavailable) and reads blocks in place.
+     *     The user_data of an Entity is a runtime pointer and is not saved, it is nullptr after a restore.
+     */
+    class WorldSnapshot
+    {
+        using BlockKind = snapshot_detail::BlockKind;
+
+        struct PoolEntry
+        {
+            std::string name;
+            std::function<void(SnapshotWriter&)> save;                                  ///< CN: 写入类型、版本、数量与数据 / EN: Writes kind, version, count and data
+            std::function<bool(SnapshotReader&, BlockKind, uint32, uint32)> load;       ///< CN: (reader, kind, version, count) / EN: (reader, kind, version, count)
+            std::function<void()> clear;
+        };
+
+        EntityPool* entity_pool;
+        std::vector<PoolEntry> pool_list;
+
+        template<typename T, ComponentStorageType S>
+        static bool LoadRaw(ComponentPool<T, S>& pool, const EntityID* ids, const void* data, uint32 count)
+        {
+            if constexpr (S == ComponentStorageType::SparseSet)
+            {
+                return pool.AssignRaw(ids, data, count);
+            }
+            else
+            {
+                pool.Clear();
+
+                const uint8* p = static_cast<const uint8*>(data);
+
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    T* component = pool.Add(ids[i]);
+
+                    if (!component)
+                        return false;
+
+                    memcpy(static_cast<void*>(component), p + size_t(i) * sizeof(T), sizeof(T));
+                }
+
+                return true;
+            }
+        }
+
+        template<typename T, ComponentStorageType S>
+        static void SaveIDs(SnapshotWriter& w, ComponentPool<T, S>& pool, uint32 count)
+        {
+            if constexpr (S == ComponentStorageType::SparseSet)
+            {
+                w.Write(pool.GetEntities(), size_t(count) * sizeof(EntityID));
+            }
+            else
+            {
+                for (uint32 i = 0; i < count; ++i)
+                    w.WriteValue(pool.GetEntity(static_cast<int>(i)));
+            }
+
+            w.Align();
+        }
+
+        void SaveEntityPool(SnapshotWriter& w) const
+        {
+            const uint32 slot_count = entity_pool->GetCapacity();
+            const uint32 free_count = entity_pool->GetFreeCount();
+            const uint32* generations = entity_pool->GetGenerations();
+
+            std::vector<uint32> flags(slot_count);
+
+            for (uint32 i = 0; i < slot_count; ++i)
+                flags[i] = entity_pool->GetFlags(MakeEntityID(i, generations[i]));
+
+            w.WriteValue(slot_count);
+            w.WriteValue(free_count);
+            w.Align();
+            w.Write(generations, size_t(slot_count) * sizeof(uint32));
+            w.Align();
+            w.Write(flags.data(), size_t(slot_count) * sizeof(uint32));
+            w.Align();
+            w.Write(entity_pool->GetFreeSlots(), size_t(free_count) * sizeof(uint32));
+            w.Align();
+        }
+
+        bool LoadEntityPool(SnapshotReader& r)
+        {
+            uint32 slot_count, free_count;
+
+            r.ReadValue(slot_count);
+            r.ReadValue(free_count);
+            r.Align();
+
+            const void* generations = r.Skip(size_t(slot_count) * sizeof(uint32));
+            r.Align();
+            const void* flags = r.Skip(size_t(slot_count) * sizeof(uint32));
+            r.Align();
+            const void* free_slots = r.Skip(size_t(free_count) * sizeof(uint32));
+            r.Align();
+
+            if (!r.IsOK())
+                return false;
+
+            return entity_pool->Restore(static_cast<const uint32*>(generations), static_cast<const uint32*>(flags), slot_count,
+                                        static_cast<const uint32*>(free_slots), free_count);
+        }
+
+    public:
+
+        WorldSnapshot(EntityPool* pool) : entity_pool(pool) {}
+
+        /**
+         * CN: 登记组件池，名称在快照中标识该池，需在保存与恢复两端一致
+         * EN: Register a component pool; the name identifies the pool in the snapshot and must match on save and load
+         */
+        template<typename T, ComponentStorageType S>
+        void Register(const std::string& name, ComponentPool<T, S>& pool)
+        {
+            constexpr bool versioned = snapshot_detail::HasSerializer<T>::value;
+
+            static_assert(versioned || std::is_trivially_copyable_v<T>,
+                          "Non-trivially copyable components need a ComponentSerializer specialization");
+
+            PoolEntry entry;
+
+            entry.name = name;
+            entry.clear = [&pool]() { pool.Clear(); };
+
+            entry.save = [&pool](SnapshotWriter& w)
+            {
+                const uint32 count = static_cast<uint32>(pool.GetCount());
+
+                if constexpr (versioned)
+                {
+                    w.WriteValue(static_cast<uint32>(BlockKind::Versioned));
+                    w.WriteValue(static_cast<uint32>(ComponentSerializer<T>::VERSION));
+                }
+                else
+                {
+                    w.WriteValue(static_cast<uint32>(BlockKind::Raw));
+                    w.WriteValue(static_cast<uint32>(sizeof(T)));      // 原始块以组件大小作为布局检查
+                }
+
+                w.WriteValue(count);
+                w.Align();
+
+                SaveIDs(w, pool, count);
+
+                if constexpr (versioned)
+                {
+                    for (uint32 i = 0; i < count; ++i)
+                        ComponentSerializer<T>::Save(w, *pool.GetAt(static_cast<int>(i)));
+                }
+                else if constexpr (S == ComponentStorageType::SparseSet)
+                {
+                    w.Write(pool.GetData(), size_t(count) * sizeof(T));
+                }
+                else
+                {
+                    for (uint32 i = 0; i < count; ++i)
+                        w.Write(pool.GetAt(static_cast<int>(i)), sizeof(T));
+                }
+
+                w.Align();
+            };
+
+            entry.load = [&pool](SnapshotReader& r, BlockKind kind, uint32 version, uint32 count) -> bool
+            {
+                r.Align();
+
+                const EntityID* ids = static_cast<const EntityID*>(r.Skip(size_t(count) * sizeof(EntityID)));
+                r.Align();
+
+                if (!ids)
+                    return false;
+
+                if constexpr (versioned)
+                {
+                    if (kind != BlockKind::Versioned)
+                        return false;
+
+                    pool.Clear();
+
+                    for (uint32 i = 0; i < count; ++i)
+                    {
+                        T component{};
+
+                        if (!ComponentSerializer<T>::Load(r, component, version) || !pool.Add(ids[i], component))
+                            return false;
+                    }
+
+                    r.Align();
+                    return r.IsOK();
+                }
+                else
+                {
+                    if (kind != BlockKind::Raw || version != sizeof(T))
+                        return false;
+
+                    const void* data = r.Skip(size_t(count) * sizeof(T));
+                    r.Align();
+
+                    return data && LoadRaw(pool, ids, data, count);
+                }
+            };
+
+            pool_list.push_back(std::move(entry));
+        }
+
+        /**
+         * CN: 保存到内存缓冲区
+         * EN: Save into a memory buffer
+         */
+        void Save(SnapshotWriter& w) const
+        {
+            w.WriteValue(SNAPSHOT_MAGIC);
+            w.WriteValue(SNAPSHOT_FORMAT_VERSION);
+            w.WriteValue(static_cast<uint32>(pool_list.size()));
+            w.Align();
+
+            SaveEntityPool(w);
+
+            for (const PoolEntry& entry : pool_list)
+            {
+                w.WriteString(entry.name);
+
+                const size_t size_pos = w.Reserve<uint64>();    // 块长度，用于跳过未登记的池
+                w.Align();
+
+                const size_t begin = w.GetSize();
+
+                entry.save(w);
+
+                w.Patch(size_pos, static_cast<uint64>(w.GetSize() - begin));
+            }
+        }
+
+        bool SaveToFile(const std::string& filename) const
+        {
+            SnapshotWriter w;
+
+            Save(w);
+
+            FILE* fp = fopen(filename.c_str(), "wb");
+
+            if (!fp)
+                return false;
+
+            const bool ok = fwrite(w.GetData(), 1, w.GetSize(), fp) == w.GetSize();
+
+            return fclose(fp) == 0 && ok;
+        }
+
+        /**
+         * CN: 从内存中的快照恢复，data需按SNAPSHOT_BLOCK_ALIGN对齐（new/malloc/映射的内存均满足）
+         * EN: Restore from a snapshot in memory, data must be aligned to SNAPSHOT_BLOCK_ALIGN (new/malloc/mapped memory is)
+         * @return CN: 格式错误时返回false，此时实体池与组件池的内容不确定 / EN: false on a malformed snapshot, pool contents are then unspecified
+         */
+        bool Load(const void* data, size_t size)
+        {
+            SnapshotReader r(data, size);
+
+            uint32 magic = 0, format = 0, block_count = 0;
+
+            r.ReadValue(magic);
+            r.ReadValue(format);
+            r.ReadValue(block_count);
+            r.Align();
+
+            if (!r.IsOK() || magic != SNAPSHOT_MAGIC || format != SNAPSHOT_FORMAT_VERSION)
+                return false;
+
+            if (!LoadEntityPool(r))
+                return false;
+
+            for (PoolEntry& entry : pool_list)
+                entry.clear();
+
+            for (uint32 b = 0; b < block_count; ++b)
+            {
+                std::string name;
+                uint64 block_size = 0;
+
+                r.ReadString(name);
+                r.ReadValue(block_size);
+                r.Align();
+
+                if (!r.IsOK() || block_size > r.GetRemain())
+                    return false;
+
+                const size_t begin = r.GetPosition();
+
+                PoolEntry* entry = nullptr;
+
+                for (PoolEntry& e : pool_list)
+                    if (e.name == name)
+                        entry = &e;
+
+                if (entry)
+                {
+                    uint32 kind = 0, version = 0, count = 0;
+
+                    r.ReadValue(kind);
+                    r.ReadValue(version);
+                    r.ReadValue(count);
+
+                    if (!r.IsOK() || !entry->load(r, static_cast<BlockKind>(kind), version, count))
+                        return false;
+
+                    if (r.GetPosition() - begin != block_size)
+                        return false;
+                }
+                else
+                {
+                    r.Skip(static_cast<size_t>(block_size));
+                }
+            }
+
+            return r.IsOK();
+        }
+
+        bool LoadFromFile(const std::string& filename)
+        {
+            snapshot_detail::MappedFile file;
+
+            if (!file.Open(filename))
+                return false;
+
+            return Load(file.GetData(), file.GetSize());
+        }
+    };
+
+} // namespace hgl::ecs
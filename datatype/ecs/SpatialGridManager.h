@@ -0,0 +1,303 @@
+#pragma once
+
+#include "IEntityManager.h"
+#include "EntitySparseSet.h"
+#include<hgl/math/VectorTypes.h>
+#include<hgl/math/geometry/AABB.h>
+#include<cmath>
+#include<unordered_map>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 二维均匀哈希网格空间管理器
+     * EN: 2D uniform hash grid spatial manager
+     *
+     * CN: 平面按cell_size划分为无限大的正方形格子，只有非空的格子存在于哈希表中。每个实体是一个点，记录所在格子与在格子中的位置：
+     *     - Update移动实体时只在跨格时从旧格子换到新格子(O(1))，同一格内只改坐标
+     *     - 半径/矩形查询只访问覆盖查询范围的格子，代价与范围内的实体数相关，与总数无关
+     *     cell_size取常用查询半径的量级效果最好。
+     * EN: The plane is split into an unbounded grid of square cells of cell_size; only non-empty cells live in the
+     *     hash table. Every entity is a point and records its cell and its position inside the cell:
+     *     - Update only moves an entity between cells when it crosses a border (O(1)); inside one cell only the
+     *       position is written
+     *     - Radius/rectangle queries only visit the cells covering the query, so the cost follows the entities
+     *       nearby rather than the total count
+     *     A cell_size around the usual query radius works best.
+     */
+    class SpatialGridManager : public IEntityManager
+    {
+        struct Cell
+        {
+            std::vector<uint32> items;                  ///< CN: 格内实体的紧密下标 / EN: Dense indices of the entities in the cell
+        };
+
+        float cell_size;
+        float inv_cell_size;
+
+        EntitySparseSet entity_set;
+        std::vector<math::Vector2f> position_list;      ///< CN: 按紧密下标 / EN: By dense index
+        std::vector<uint64> cell_key;                   ///< CN: 实体所在格子 / EN: Cell of the entity
+        std::vector<uint32> cell_slot;                  ///< CN: 实体在格子items中的位置 / EN: Position inside the cell's items
+
+        std::unordered_map<uint64, Cell> cell_map;
+
+        int32 ToCell(float v) const
+        {
+            return static_cast<int32>(std::floor(v * inv_cell_size));
+        }
+
+        static uint64 MakeKey(int32 cx, int32 cy)
+        {
+            return (uint64(uint32(cx)) << 32) | uint32(cy);
+        }
+
+        uint64 KeyOf(const math::Vector2f& pos) const
+        {
+            return MakeKey(ToCell(pos.x), ToCell(pos.y));
+        }
+
+        void Link(uint32 index, uint64 key)
+        {
+            Cell& cell = cell_map[key];
+
+            cell_key[index] = key;
+            cell_slot[index] = static_cast<uint32>(cell.items.size());
+            cell.items.push_back(index);
+        }
+
+        void Unlink(uint32 index)
+        {
+            auto it = cell_map.find(cell_key[index]);
+            std::vector<uint32>& items = it->second.items;
+            const uint32 slot = cell_slot[index];
+
+            items[slot] = items.back();
+            cell_slot[items[slot]] = slot;
+            items.pop_back();
+
+            if (items.empty())
+                cell_map.erase(it);
+        }
+
+        template<typename F>
+        void ForCells(int32 x0, int32 y0, int32 x1, int32 y1, F&& func) const
+        {
+            // 范围内的格子比非空格子还多时，直接遍历哈希表
+            if (double(x1 - x0 + 1) * double(y1 - y0 + 1) > double(cell_map.size()))
+            {
+                for (const auto& [key, cell] : cell_map)
+                {
+                    const int32 cx = int32(uint32(key >> 32));
+                    const int32 cy = int32(uint32(key));
+
+                    if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1)
+                        func(cell);
+                }
+
+                return;
+            }
+
+            for (int32 cy = y0; cy <= y1; ++cy)
+                for (int32 cx = x0; cx <= x1; ++cx)
+                {
+                    auto it = cell_map.find(MakeKey(cx, cy));
+
+                    if (it != cell_map.end())
+                        func(it->second);
+                }
+        }
+
+    public:
+
+        SpatialGridManager(EntityPool* pool, float size = 1.0f)
+            : IEntityManager(pool)
+            , cell_size(size > 0 ? size : 1.0f)
+            , inv_cell_size(1.0f / cell_size)
+        {
+        }
+
+        ~SpatialGridManager() override = default;
+
+        float GetCellSize() const { return cell_size; }
+        int GetCellCount() const { return static_cast<int>(cell_map.size()); }
+
+        /**
+         * CN: 以原点位置加入
+         * EN: Add at the origin
+         */
+        bool Add(const EntityID entity_id) override
+        {
+            return Add(entity_id, math::Vector2f(0, 0));
+        }
+
+        bool Add(const EntityID entity_id, const math::Vector2f& position)
+        {
+            if (!entity_pool || !entity_pool->Contains(entity_id))
+                return false;
+
+            const uint32 index = entity_set.Insert(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            position_list.push_back(position);
+            cell_key.push_back(0);
+            cell_slot.push_back(0);
+
+            Link(index, KeyOf(position));
+            return true;
+        }
+
+        bool Remove(const EntityID entity_id) override
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            Unlink(index);
+
+            uint32 removed = 0;
+            entity_set.Remove(entity_id, removed);
+
+            // 最后一项移入空位，它所在格子中的下标也要改
+            const uint32 last = static_cast<uint32>(position_list.size() - 1);
+
+            if (removed != last)
+            {
+                position_list[removed] = position_list[last];
+                cell_key[removed] = cell_key[last];
+                cell_slot[removed] = cell_slot[last];
+
+                cell_map.find(cell_key[removed])->second.items[cell_slot[removed]] = removed;
+            }
+
+            position_list.pop_back();
+            cell_key.pop_back();
+            cell_slot.pop_back();
+            return true;
+        }
+
+        /**
+         * CN: 更新实体位置，跨格时才移动格子
+         * EN: Update the entity position, cells only change when it crosses a border
+         */
+        bool Update(const EntityID entity_id, const math::Vector2f& position)
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            if (index == EntitySparseSet::NPOS)
+                return false;
+
+            position_list[index] = position;
+
+            const uint64 key = KeyOf(position);
+
+            if (key != cell_key[index])
+            {
+                Unlink(index);
+                Link(index, key);
+            }
+
+            return true;
+        }
+
+        const math::Vector2f* GetPosition(const EntityID entity_id) const
+        {
+            const uint32 index = entity_set.Find(entity_id);
+
+            return index == EntitySparseSet::NPOS ? nullptr : &position_list[index];
+        }
+
+        bool Contains(const EntityID entity_id) const override
+        {
+            return entity_set.Contains(entity_id);
+        }
+
+        int GetCount() const override
+        {
+            return static_cast<int>(entity_set.GetCount());
+        }
+
+        void Clear() override
+        {
+            entity_set.Clear();
+            position_list.clear();
+            cell_key.clear();
+            cell_slot.clear();
+            cell_map.clear();
+        }
+
+        void Iterate(IterateFunc func, void* user_data = nullptr) override
+        {
+            if (!func)
+                return;
+
+            for (uint32 i = 0; i < entity_set.GetCount(); ++i)
+                func(entity_set.GetEntity(i), user_data);
+        }
+
+        /**
+         * CN: 查询与center距离不超过radius的实体，追加到result
+         * EN: Query entities within radius of center, appended to result
+         * @return CN: 找到的数量 / EN: Number found
+         */
+        int QueryRadius(const math::Vector2f& center, float radius, std::vector<EntityID>& result) const
+        {
+            const size_t start = result.size();
+            const float r2 = radius * radius;
+
+            ForCells(ToCell(center.x - radius), ToCell(center.y - radius),
+                     ToCell(center.x + radius), ToCell(center.y + radius), [&](const Cell& cell)
+            {
+                for (const uint32 index : cell.items)
+                {
+                    const float dx = position_list[index].x - center.x;
+                    const float dy = position_list[index].y - center.y;
+
+                    if (dx * dx + dy * dy <= r2)
+                        result.push_back(entity_set.GetEntity(index));
+                }
+            });
+
+            return static_cast<int>(result.size() - start);
+        }
+
+        /**
+         * CN: 查询落在矩形[min, max]内的实体，追加到result
+         * EN: Query entities inside the rectangle [min, max], appended to result
+         */
+        int QueryRect(const math::Vector2f& min, const math::Vector2f& max, std::vector<EntityID>& result) const
+        {
+            const size_t start = result.size();
+
+            ForCells(ToCell(min.x), ToCell(min.y), ToCell(max.x), ToCell(max.y), [&](const Cell& cell)
+            {
+                for (const uint32 index : cell.items)
+                {
+                    const math::Vector2f& p = position_list[index];
+
+                    if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y)
+                        result.push_back(entity_set.GetEntity(index));
+                }
+            });
+
+            return static_cast<int>(result.size() - start);
+        }
+
+        /**
+         * CN: 以AABB的XY范围查询，Z被忽略
+         * EN: Query by the XY extent of an AABB, Z is ignored
+         */
+        int QueryAABB(const math::AABB& box, std::vector<EntityID>& result) const
+        {
+            const math::Vector3f& min = box.GetMin();
+            const math::Vector3f& max = box.GetMax();
+
+            return QueryRect(math::Vector2f(min.x, min.y), math::Vector2f(max.x, max.y), result);
+        }
+    };
+
+} // namespace hgl::ecs
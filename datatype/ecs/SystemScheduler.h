@@ -0,0 +1,467 @@
+#pragma once
+
+#include "ComponentType.h"
+#include "View.h"
+#include "CommandBuffer.h"
+#include "EventQueue.h"
+#include "../../task/ParallelFor.h"
+#include<algorithm>
+#include<atomic>
+#include<functional>
+#include<string>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 系统执行时的上下文
+     * EN: Context passed to a running system
+     *
+     * CN: 除帧时间外还提供系统内部的并行：把View的驱动区间或ArchetypeView的块区间拆给计算线程。
+     *     没有执行器（串行运行）时直接在当前线程完成。
+     *     系统内的结构变化（创建/销毁实体、增删组件）写入GetCommands()返回的当前线程命令缓冲区，在本层结束时回放。
+     *     Send发送的事件写入当前线程的事件缓冲区，下一帧经GetEvents读取。
+     * EN: Besides the frame time it offers parallelism inside a system: the driving range of a View or the
+     *     chunk range of an ArchetypeView is split across compute workers. Without an executor (serial run)
+     *     everything runs on the calling thread.
+     *     Structural changes (creating/destroying entities, adding/removing components) go to the calling
+     *     thread's command buffer from GetCommands() and are played back when the stage ends.
+     *     Events from Send go to the calling thread's event buffer and are read next frame through GetEvents.
+     */
+    class SystemContext
+    {
+        task::TaskExecutor* executor;
+        CommandQueue* command_queue;
+        EventBus* event_bus;
+        float delta_time;
+        uint32 last_run_tick;
+
+        static uint32 GetThreadIndex()
+        {
+            return static_cast<uint32>(task::TaskExecutor::GetCurrentWorkerID() + 1);
+        }
+
+    public:
+
+        SystemContext(task::TaskExecutor* te, CommandQueue* queue, float dt, uint32 last_tick = 0, EventBus* bus = nullptr)
+            : executor(te), command_queue(queue), event_bus(bus), delta_time(dt), last_run_tick(last_tick) {}
+
+        float GetDeltaTime() const { return delta_time; }
+        task::TaskExecutor* GetExecutor() const { return executor; }
+
+        /**
+         * CN: 本系统上一次运行时的变更计数，从未运行为0，用作View::Filter的参数只处理之后的变化
+         * EN: Change tick of this system's previous run, 0 if it never ran; pass it to View::Filter to handle only later changes
+         */
+        uint32 GetLastRunTick() const { return last_run_tick; }
+
+        /**
+         * CN: 当前线程的命令缓冲区，未设置命令队列时返回nullptr
+         * EN: Command buffer of the calling thread, nullptr if no command queue is set
+         */
+        CommandBuffer* GetCommands() const
+        {
+            if (!command_queue)
+                return nullptr;
+
+            return &command_queue->Get(GetThreadIndex());
+        }
+
+        /**
+         * CN: 从当前线程发送事件，下一帧可读
+         * EN: Send an event from the calling thread, readable next frame
+         * @return CN: 未设置事件总线或事件类型未登记返回false / EN: false if no event bus is set or the event type is unregistered
+         */
+        template<typename E>
+        bool Send(E&& event) const
+        {
+            auto* queue = event_bus ? event_bus->Find<std::remove_reference_t<E>>() : nullptr;
+
+            if (!queue)
+                return false;
+
+            queue->Send(GetThreadIndex(), std::forward<E>(event));
+            return true;
+        }
+
+        /**
+         * CN: 上一帧发送的E类事件，连续存放；未登记返回nullptr
+         * EN: Events of type E sent last frame, stored contiguously; nullptr if unregistered
+         */
+        template<typename E>
+        const EventQueue<E>* GetEvents() const
+        {
+            return event_bus ? event_bus->Find<E>() : nullptr;
+        }
+
+        /**
+         * CN: 并行处理[0, count)，func(begin, end)
+         * EN: Process [0, count) in parallel, func(begin, end)
+         * @param grain CN: 最小块大小，0为自动 / EN: Minimum chunk size, 0 chooses automatically
+         */
+        template<typename F>
+        void ParallelFor(size_t count, size_t grain, const F& func)
+        {
+            if (!executor)
+            {
+                func(size_t(0), count);
+                return;
+            }
+
+            task::ParallelFor(*executor, task::IndexRange(0, count), grain,
+                              [&func](const task::IndexRange& r) { func(r.begin, r.end); });
+        }
+
+        /**
+         * CN: 按驱动池下标拆分View，func(EntityID, Ts&...)
+         * EN: Split a View by driving pool index, func(EntityID, Ts&...)
+         */
+        template<typename... Ts, typename F>
+        void ParallelEach(View<Ts...>& view, size_t grain, const F& func)
+        {
+            ParallelFor(view.GetSize(), grain, [&view, &func](size_t begin, size_t end) { view.Each(begin, end, func); });
+        }
+
+        /**
+         * CN: 按块拆分ArchetypeView，grain以块为单位，func(EntityID, Ts&...)
+         * EN: Split an ArchetypeView by chunk, grain counts chunks, func(EntityID, Ts&...)
+         */
+        template<typename... Ts, typename F>
+        void ParallelEach(ArchetypeView<Ts...>& view, size_t grain, const F& func)
+        {
+            ParallelFor(view.GetChunkCount(), grain, [&view, &func](size_t begin, size_t end) { view.Each(begin, end, func); });
+        }
+    };
+
+    using SystemFunc = std::function<void(SystemContext&)>;
+
+    class SystemRegistry;
+
+    /**
+     * CN: 系统描述：名称、执行函数以及读写的组件类型
+     * EN: System description: name, function and the component types it reads and writes
+     */
+    class SystemDesc
+    {
+        std::string name;
+        SystemFunc func;
+
+        std::vector<ComponentTypeID> reads;                 ///< CN: 排序后的只读组件 / EN: Sorted read-only components
+        std::vector<ComponentTypeID> writes;                ///< CN: 排序后的读写组件 / EN: Sorted written components
+        bool exclusive = false;
+        bool enabled = true;
+        uint32 last_run_tick = 0;
+
+        bool* schedule_dirty;
+
+        friend class SystemRegistry;
+
+        static void Insert(std::vector<ComponentTypeID>& list, ComponentTypeID id)
+        {
+            auto it = std::lower_bound(list.begin(), list.end(), id);
+
+            if (it == list.end() || *it != id)
+                list.insert(it, id);
+        }
+
+        static bool Intersects(const std::vector<ComponentTypeID>& a, const std::vector<ComponentTypeID>& b)
+        {
+            auto ia = a.begin();
+            auto ib = b.begin();
+
+            while (ia != a.end() && ib != b.end())
+            {
+                if (*ia < *ib)      ++ia;
+                else if (*ib < *ia) ++ib;
+                else                return true;
+            }
+
+            return false;
+        }
+
+        SystemDesc(const std::string& n, SystemFunc f, bool* dirty) : name(n), func(std::move(f)), schedule_dirty(dirty) {}
+
+    public:
+
+        template<typename... Ts>
+        SystemDesc& Read()
+        {
+            (Insert(reads, GetComponentTypeID<Ts>()), ...);
+            *schedule_dirty = true;
+            return *this;
+        }
+
+        template<typename... Ts>
+        SystemDesc& Write()
+        {
+            (Insert(writes, GetComponentTypeID<Ts>()), ...);
+            *schedule_dirty = true;
+            return *this;
+        }
+
+        /**
+         * CN: 独占运行，与所有系统冲突，用于不经命令缓冲区、直接增删实体/组件的系统
+         * EN: Run alone, conflicts with every system, for systems adding/removing entities or components directly instead of through a command buffer
+         */
+        SystemDesc& Exclusive()
+        {
+            exclusive = true;
+            *schedule_dirty = true;
+            return *this;
+        }
+
+        const std::string& GetName() const { return name; }
+        bool IsEnabled() const { return enabled; }
+
+        /**
+         * CN: 任一方写了另一方读或写的组件即冲突
+         * EN: Two systems conflict when either writes a component the other reads or writes
+         */
+        bool Conflicts(const SystemDesc& other) const
+        {
+            if (exclusive || other.exclusive)
+                return true;
+
+            return Intersects(writes, other.writes)
+                || Intersects(writes, other.reads)
+                || Intersects(reads, other.writes);
+        }
+    };
+
+    /**
+     * CN: 系统注册表与并行调度
+     * EN: System registry and parallel scheduler
+     *
+     * CN: 每个系统声明读写的组件，注册表按注册顺序分层：一个系统排在所有与它冲突的、更早注册的系统之后，
+     *     同一层内的系统互不冲突，在计算线程上并发执行，层与层之间同步。冲突系统之间的先后关系与串行执行相同。
+     *     注册、启停或修改读写声明后，下一次Run时重建调度。
+     *     每层开始前、命令回放前与Run结束时各推进一次变更计数(AdvanceChangeTick)，系统经SystemContext::GetLastRunTick得到上次运行时的计数；
+     *     回放与两次Run之间的外部修改都晚于系统记录的计数，下次运行时可以看到。
+     *     设置了事件总线时，每次Run结束后交换所有事件队列：读事件的系统总是看到上一帧的完整事件，
+     *     与发送者的先后无关，所以事件不需要声明读写。
+     * EN: Every system declares the components it reads and writes. Systems are layered in registration order:
+     *     a system goes after every earlier registered system it conflicts with. Systems in one stage never
+     *     conflict and run concurrently on compute workers, stages are separated by a sync point.
+     *     Conflicting systems keep the same order as a serial run.
+     *     The schedule is rebuilt on the next Run after registering, enabling/disabling or changing declarations.
+     *     The change tick is advanced before every stage, before command playback and at the end of Run
+     *     (AdvanceChangeTick); systems get the tick of their previous run from SystemContext::GetLastRunTick.
+     *     Playback and edits made between two Runs are therefore newer than that tick and seen on the next run.
+     *     With an event bus set, every event queue is swapped after each Run: readers always see all events of the
+     *     previous frame regardless of sender order, so events need no read/write declarations.
+     */
+    class SystemRegistry
+    {
+        std::vector<SystemDesc*> system_list;
+        std::vector<std::vector<int>> stage_list;           ///< CN: 每层的系统下标 / EN: System indices of each stage
+        bool schedule_dirty = true;
+
+        CommandQueue* command_queue = nullptr;
+        EntityPool* command_entity_pool = nullptr;
+        const ComponentPoolSet* command_pools = nullptr;
+
+        EventBus* event_bus = nullptr;
+
+        void RunSystem(int index, task::TaskExecutor* te, float delta_time)
+        {
+            SystemDesc* desc = system_list[index];
+            SystemContext ctx(te, command_queue, delta_time, desc->last_run_tick, event_bus);
+
+            desc->func(ctx);
+            desc->last_run_tick = GetChangeTick();
+        }
+
+        void SyncPoint()
+        {
+            if (command_queue && !command_queue->IsEmpty())
+                command_queue->Playback(*command_entity_pool, *command_pools);
+        }
+
+    public:
+
+        SystemRegistry() = default;
+
+        ~SystemRegistry()
+        {
+            for (SystemDesc* desc : system_list)
+                delete desc;
+        }
+
+        SystemRegistry(const SystemRegistry&) = delete;
+        SystemRegistry& operator=(const SystemRegistry&) = delete;
+
+        /**
+         * CN: 注册系统，返回的描述用于声明读写组件
+         * EN: Register a system, the returned description declares the components it reads and writes
+         */
+        SystemDesc& Add(const std::string& name, SystemFunc func)
+        {
+            system_list.push_back(new SystemDesc(name, std::move(func), &schedule_dirty));
+            schedule_dirty = true;
+            return *system_list.back();
+        }
+
+        SystemDesc* Find(const std::string& name)
+        {
+            for (SystemDesc* desc : system_list)
+                if (desc->name == name)
+                    return desc;
+
+            return nullptr;
+        }
+
+        bool SetEnabled(const std::string& name, bool enabled)
+        {
+            SystemDesc* desc = Find(name);
+
+            if (!desc)
+                return false;
+
+            if (desc->enabled != enabled)
+            {
+                desc->enabled = enabled;
+                schedule_dirty = true;
+            }
+
+            return true;
+        }
+
+        /**
+         * CN: 设置延迟命令队列，每层结束时回放到entity_pool与pools
+         * EN: Set the deferred command queue, played back into entity_pool and pools at the end of every stage
+         */
+        void SetCommandQueue(CommandQueue* queue, EntityPool* entity_pool, const ComponentPoolSet* pools)
+        {
+            command_queue = queue;
+            command_entity_pool = entity_pool;
+            command_pools = pools;
+        }
+
+        /**
+         * CN: 设置事件总线，每次Run结束时交换
+         * EN: Set the event bus, swapped at the end of every Run
+         */
+        void SetEventBus(EventBus* bus)
+        {
+            event_bus = bus;
+        }
+
+        int GetSystemCount() const { return static_cast<int>(system_list.size()); }
+        const SystemDesc& GetSystem(int index) const { return *system_list[index]; }
+
+        /**
+         * CN: 按注册顺序分层，跳过未启用的系统
+         * EN: Layer systems in registration order, skipping disabled ones
+         */
+        void BuildSchedule()
+        {
+            std::vector<int> stage_of(system_list.size(), -1);
+
+            stage_list.clear();
+
+            for (size_t i = 0; i < system_list.size(); ++i)
+            {
+                if (!system_list[i]->enabled)
+                    continue;
+
+                int stage = 0;
+
+                for (size_t j = 0; j < i; ++j)
+                    if (stage_of[j] >= stage && system_list[i]->Conflicts(*system_list[j]))
+                        stage = stage_of[j] + 1;
+
+                stage_of[i] = stage;
+
+                if (stage >= static_cast<int>(stage_list.size()))
+                    stage_list.resize(stage + 1);
+
+                stage_list[stage].push_back(static_cast<int>(i));
+            }
+
+            schedule_dirty = false;
+        }
+
+        const std::vector<std::vector<int>>& GetStages()
+        {
+            if (schedule_dirty)
+                BuildSchedule();
+
+            return stage_list;
+        }
+
+        /**
+         * CN: 在当前线程按调度顺序串行执行
+         * EN: Run serially on the calling thread in schedule order
+         */
+        void Run(float delta_time)
+        {
+            for (const std::vector<int>& stage : GetStages())
+            {
+                AdvanceChangeTick();
+
+                for (int index : stage)
+                    RunSystem(index, nullptr, delta_time);
+
+                AdvanceChangeTick();            // CN: 回放写入的计数大于本层系统记录的计数 / EN: Playback writes at a tick above the one this stage recorded
+                SyncPoint();
+            }
+
+            AdvanceChangeTick();                // CN: 两次Run之间的外部修改使用新的计数 / EN: Edits made between two Runs get a fresh tick
+
+            if (event_bus)
+                event_bus->Swap();
+        }
+
+        /**
+         * CN: 每层内的系统并发执行，调用线程参与，返回时所有系统均已完成
+         * EN: Systems of a stage run concurrently, the calling thread takes part, all systems are done on return
+         */
+        void Run(task::TaskExecutor& te, float delta_time)
+        {
+            if (!te.IsRunning())
+            {
+                Run(delta_time);
+                return;
+            }
+
+            const uint32 thread_count = te.GetComputeWorkerCount() + te.GetBackgroundWorkerCount() + 1;
+
+            if (command_queue)
+                command_queue->Resize(thread_count);
+
+            if (event_bus)
+                event_bus->Resize(thread_count);
+
+            for (const std::vector<int>& stage : GetStages())
+            {
+                AdvanceChangeTick();
+
+                std::atomic<uint32> pending{static_cast<uint32>(stage.size() - 1)};
+
+                for (size_t i = 1; i < stage.size(); ++i)
+                {
+                    const int index = stage[i];
+
+                    te.AddComputeTask([this, index, &te, delta_time, &pending]()
+                    {
+                        RunSystem(index, &te, delta_time);
+                        pending.fetch_sub(1, std::memory_order_acq_rel);
+                    });
+                }
+
+                RunSystem(stage[0], &te, delta_time);
+
+                task::parallel_detail::WaitForZero(te, pending);
+
+                AdvanceChangeTick();
+                SyncPoint();
+            }
+
+            AdvanceChangeTick();
+
+            if (event_bus)
+                event_bus->Swap();
+        }
+    };
+
+} // namespace hgl::ecs
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ComponentPool.h"
+#include<hgl/math/Transform.h>
+
+/**
+ * CN: math::Transform作为组件时的存储方式
+ * EN: Storage backend of math::Transform used as a component
+ *
+ * CN: 场景中几乎每个节点都有局部变换，用稀疏集存储以便按实体下标直接访问。
+ *     math::Transform声明在CMMath中，存储特化无法与它的声明放在一起，所以单独放在本文件。
+ *     使用ComponentPool<math::Transform>的每个翻译单元都必须包含本文件（只包含hgl/math/Transform.h不够），
+ *     否则该单元会得到Map存储，与其它单元不一致(ODR)。同一单元内先用到ComponentPool<math::Transform>再包含本文件会编译报错。
+ * EN: Nearly every scene node has a local transform, a sparse set gives direct access by entity index.
+ *     math::Transform is declared in CMMath, so the storage specialization cannot sit next to its declaration and
+ *     lives in this file instead.
+ *     Every translation unit using ComponentPool<math::Transform> must include this file (including
+ *     hgl/math/Transform.h alone is not enough), otherwise that unit gets Map storage and disagrees with the others (ODR).
+ *     Using ComponentPool<math::Transform> before including this file in the same unit is a compile error.
+ */
+HGL_ECS_COMPONENT_STORAGE(hgl::math::Transform, SparseSet)
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "FlatEntityTreeManager.h"
+#include "TransformComponent.h"
+#include "SystemScheduler.h"
+#include<algorithm>
+#include<atomic>
+#include<vector>
+
+namespace hgl::ecs
+{
+    /**
+     * CN: 层级变换系统
+     * EN: Hierarchical transform system
+     *
+     * CN: 局部变换是普通组件(ComponentPool<math::Transform>)，层级来自FlatEntityTreeManager。
+     *     世界矩阵按树的线性顺序存放：world[i] = world[parent[i]] * local[i]，父节点总在子节点之前，一次顺序遍历即可。
+     *     - 只重算脏的子树：修改局部变换后调用MarkDirty（或用EditLocal取得可写指针），Update时从脏节点起向后传播，
+     *       子节点继承父节点的脏标记。没有任何脏标记的一帧只做一次判断。
+     *     - 各根子树在线性数组中各占一段、互不依赖，脏的根区间合并成大小相近的批次分给计算线程。
+     *     - 树结构变化（增删节点、SetParent）后线性位置改变，下一次Update全部重算。
+     *     没有Transform组件的节点按单位矩阵处理，即直接继承父节点的世界矩阵。
+     * EN: Local transforms are a plain component (ComponentPool<math::Transform>), the hierarchy comes from FlatEntityTreeManager.
+     *     World matrices are stored in the tree's linear order: world[i] = world[parent[i]] * local[i]; parents precede
+     *     children, so one forward pass is enough.
+     *     - Only dirty subtrees are recomputed: call MarkDirty after changing a local transform (or get a writable pointer
+     *       through EditLocal). Update propagates forward from the dirty nodes, children inherit the parent's dirty flag.
+     *       A frame without any dirty node costs a single check.
+     *     - Every root subtree is its own independent range of the linear arrays; dirty root ranges are merged into
+     *       batches of similar size and handed to compute workers.
+     *     - Structural changes (adding/removing nodes, SetParent) move linear positions, the next Update recomputes everything.
+     *     Nodes without a Transform component count as identity and inherit the parent's world matrix.
+     */
+    class TransformSystem
+    {
+    public:
+
+        using TransformPool = ComponentPool<math::Transform>;
+
+        static_assert(ComponentStorageOf<math::Transform>::value == ComponentStorageType::SparseSet,
+                      "math::Transform must use SparseSet storage, include TransformComponent.h first");
+
+    private:
+
+        struct Batch
+        {
+            uint32 first_range;                         ///< CN: dirty_ranges中的起始下标 / EN: First index into dirty_ranges
+            uint32 last_range;
+        };
+
+        FlatEntityTreeManager* tree;
+        TransformPool* transforms;
+
+        std::vector<math::Matrix4f> world;              ///< CN: 线性顺序的世界矩阵 / EN: World matrices in linear order
+        std::vector<uint8> dirty;                       ///< CN: 线性顺序的脏标记 / EN: Dirty flags in linear order
+        std::vector<uint32> range_first_dirty;          ///< CN: 每个根区间中第一个脏节点，干净为NONE / EN: First dirty node of each root range, NONE if clean
+
+        std::vector<EntityID> pending;                  ///< CN: 上次Update后标记的实体 / EN: Entities marked since the last Update
+        bool all_dirty = true;
+        uint32 order_version = 0;
+
+        std::vector<uint32> dirty_ranges;
+        std::vector<Batch> batches;
+
+        uint32 batch_size = 4096;
+        uint32 last_update_count = 0;
+
+        static constexpr uint32 NONE = FlatEntityTreeManager::NONE;
+
+        uint32 FindRange(uint32 linear_index) const
+        {
+            const auto& ranges = tree->GetRootRanges();
+
+            auto it = std::upper_bound(ranges.begin(), ranges.end(), linear_index,
+                                       [](uint32 index, const FlatEntityTreeManager::Range& r) { return index < r.begin; });
+
+            return static_cast<uint32>(it - ranges.begin()) - 1;
+        }
+
+        void MarkLinear(uint32 linear_index)
+        {
+            if (dirty[linear_index])
+                return;
+
+            dirty[linear_index] = 1;
+
+            const uint32 r = FindRange(linear_index);
+
+            if (linear_index < range_first_dirty[r])
+                range_first_dirty[r] = linear_index;
+        }
+
+        /**
+         * CN: 收集pending与结构变化，填好dirty/range_first_dirty
+         * EN: Gather pending marks and structural changes into dirty/range_first_dirty
+         */
+        void CollectDirty()
+        {
+            const uint32 version = tree->GetOrderVersion();
+
+            if (version != order_version)
+            {
+                order_version = version;
+                all_dirty = true;
+            }
+
+            if (all_dirty)
+            {
+                const auto& ranges = tree->GetRootRanges();
+                const uint32 count = tree->GetLinearCount();
+
+                world.resize(count);
+                dirty.assign(count, 1);
+                range_first_dirty.resize(ranges.size());
+
+                for (size_t r = 0; r < ranges.size(); ++r)
+                    range_first_dirty[r] = ranges[r].begin;
+
+                pending.clear();
+                all_dirty = false;
+                return;
+            }
+
+            for (const EntityID id : pending)
+            {
+                const uint32 index = tree->GetLinearIndex(id);
+
+                if (index != NONE)
+                    MarkLinear(index);
+            }
+
+            pending.clear();
+        }
+
+        /**
+         * CN: 把脏的根区间按节点数合并成批次
+         * EN: Merge dirty root ranges into batches by node count
+         */
+        void BuildBatches()
+        {
+            const auto& ranges = tree->GetRootRanges();
+
+            dirty_ranges.clear();
+            batches.clear();
+
+            uint32 batch_nodes = 0;
+
+            for (uint32 r = 0; r < static_cast<uint32>(ranges.size()); ++r)
+            {
+                if (range_first_dirty[r] == NONE)
+                    continue;
+
+                if (batch_nodes == 0)
+                    batches.push_back({static_cast<uint32>(dirty_ranges.size()), 0});
+
+                dirty_ranges.push_back(r);
+                batch_nodes += ranges[r].end - range_first_dirty[r];
+
+                batches.back().last_range = static_cast<uint32>(dirty_ranges.size());
+
+                if (batch_nodes >= batch_size)
+                    batch_nodes = 0;
+            }
+        }
+
+        /**
+         * CN: 传播一个根区间，从第一个脏节点开始，返回重算的节点数
+         * EN: Propagate one root range starting at its first dirty node, returns the number of recomputed nodes
+         */
+        uint32 UpdateRange(uint32 r, const EntityID* ids, const uint32* parents)
+        {
+            const uint32 begin = range_first_dirty[r];
+            const uint32 end = tree->GetRootRanges()[r].end;
+
+            uint32 count = 0;
+
+            for (uint32 i = begin; i < end; ++i)
+            {
+                const uint32 p = parents[i];
+
+                if (!dirty[i])
+                {
+                    if (p == NONE || !dirty[p])
+                        continue;
+
+                    dirty[i] = 1;
+                }
+
+                math::Transform* local = transforms->Get(ids[i]);
+
+                if (p == NONE)
+                    world[i] = local ? local->GetMatrix() : math::Matrix4f(1.0f);
+                else
+                    world[i] = local ? world[p] * local->GetMatrix() : world[p];
+
+                ++count;
+            }
+
+            // 子节点都在父节点之后，整段处理完才能清除标记
+            std::fill(dirty.begin() + begin, dirty.begin() + end, uint8(0));
+            range_first_dirty[r] = NONE;
+
+            return count;
+        }
+
+        uint32 UpdateBatch(const Batch& batch, const EntityID* ids, const uint32* parents)
+        {
+            uint32 count = 0;
+
+            for (uint32 i = batch.first_range; i < batch.last_range; ++i)
+                count += UpdateRange(dirty_ranges[i], ids, parents);
+
+            return count;
+        }
+
+    public:
+
+        TransformSystem(FlatEntityTreeManager* t, TransformPool* pool) : tree(t), transforms(pool) {}
+
+        TransformSystem(const TransformSystem&) = delete;
+        TransformSystem& operator=(const TransformSystem&) = delete;
+
+        /**
+         * CN: 合并为一个并行批次的最少节点数
+         * EN: Minimum node count merged into one parallel batch
+         */
+        void SetBatchSize(uint32 size) { batch_size = size ? size : 1; }
+
+        /**
+         * CN: 标记实体的局部变换已修改，其子树在下次Update时重算
+         * EN: Mark the entity's local transform as changed, its subtree is recomputed on the next Update
+         */
+        void MarkDirty(const EntityID entity_id)
+        {
+            if (!all_dirty)
+                pending.push_back(entity_id);
+        }
+
+        void MarkAllDirty() { all_dirty = true; }
+
+        /**
+         * CN: 取得可写的局部变换并标记为脏，实体没有Transform组件时返回nullptr
+         * EN: Get a writable local transform and mark it dirty, nullptr if the entity has no Transform component
+         */
+        math::Transform* EditLocal(const EntityID entity_id)
+        {
+            math::Transform* local = transforms->Get(entity_id);
+
+            if (local)
+                MarkDirty(entity_id);
+
+            return local;
+        }
+
+        /**
+         * CN: 重算所有脏子树，te不为空且有多个批次时并行
+         * EN: Recompute all dirty subtrees, in parallel when te is given and there is more than one batch
+         * @return CN: 重算的节点数 / EN: Number of recomputed nodes
+         */
+        uint32 Update(task::TaskExecutor* te = nullptr)
+        {
+            if (!all_dirty && pending.empty() && tree->GetOrderVersion() == order_version)
+            {
+                last_update_count = 0;
+                return 0;
+            }
+
+            CollectDirty();
+            BuildBatches();
+
+            const EntityID* ids = tree->GetLinearEntities();
+            const uint32* parents = tree->GetLinearParents();
+
+            uint32 count = 0;
+
+            if (!te || !te->IsRunning() || batches.size() < 2)
+            {
+                for (const Batch& batch : batches)
+                    count += UpdateBatch(batch, ids, parents);
+            }
+            else
+            {
+                std::atomic<uint32> total{0};
+
+                task::ParallelFor(*te, task::IndexRange(0, batches.size()), 1, [&](const task::IndexRange& r)
+                {
+                    uint32 n = 0;
+
+                    for (size_t i = r.begin; i < r.end; ++i)
+                        n += UpdateBatch(batches[i], ids, parents);
+
+                    total.fetch_add(n, std::memory_order_relaxed);
+                });
+
+                count = total.load(std::memory_order_relaxed);
+            }
+
+            last_update_count = count;
+            return count;
+        }
+
+        /**
+         * CN: 作为SystemRegistry中的系统运行时使用上下文中的执行器
+         * EN: Uses the context's executor when run as a system of a SystemRegistry
+         */
+        uint32 Update(SystemContext& ctx)
+        {
+            return Update(ctx.GetExecutor());
+        }
+
+        uint32 GetLastUpdateCount() const { return last_update_count; }
+
+        /**
+         * CN: 实体的世界矩阵，不在树中返回nullptr；结果为上一次Update的值
+         * EN: World matrix of an entity, nullptr if not in the tree; reflects the last Update
+         */
+        const math::Matrix4f* GetWorldMatrix(const EntityID entity_id)
+        {
+            const uint32 index = tree->GetLinearIndex(entity_id);
+
+            if (index == NONE || index >= world.size())
+                return nullptr;
+
+            return &world[index];
+        }
+
+        /**
+         * CN: 线性顺序的世界矩阵，与tree->GetLinearEntities()一一对应，在下一次结构变化前有效
+         * EN: World matrices in linear order, matching tree->GetLinearEntities(), valid until the next structural change
+         */
+        const math::Matrix4f* GetWorldMatrices() const { return world.data(); }
+    };
+
+} // namespace hgl::ecs
@@ -0,0 +1,475 @@
+#pragma once
+
+#include "ComponentPool.h"
+#include "ArchetypeStorage.h"
+#include<algorithm>
+#include<array>
+#include<limits>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+#include<vector>
+
+namespace hgl::ecs
+{
+    namespace view_detail
+    {
+        template<typename P> struct IsTracked : std::false_type {};
+        template<typename T> struct IsTracked<ComponentPool<T, ComponentStorageType::SparseSet>> : std::true_type {};
+
+        template<typename F> struct FilterTraits;
+
+        template<typename T> struct FilterTraits<Added<T>>
+        {
+            using Component = std::remove_const_t<T>;
+            static constexpr bool ADDED = true;
+        };
+
+        template<typename T> struct FilterTraits<Changed<T>>
+        {
+            using Component = std::remove_const_t<T>;
+            static constexpr bool ADDED = false;
+        };
+    }
+
+    /**
+     * CN: 多组件视图（基于ComponentPool）
+     * EN: Multi-component view over ComponentPools
+     *
+     * CN: 选取实体最少的池作为驱动，按下标遍历它，再到其余的池中查找，实体缺少任一组件即跳过。
+     *     func(EntityID, Ts&...)以模板参数传入，可被内联。组件类型写成const T表示只读。
+     *     Each(begin, end, func)只处理驱动池的[begin, end)区间，不同区间可交给不同线程：
+     *
+     *         ParallelFor(te, IndexRange(0, view.GetSize()), 1024, [&](const IndexRange& r)
+     *         {
+     *             view.Each(r.begin, r.end, func);
+     *         });
+     *
+     *     遍历期间不可对这些池做Add/Remove。
+     *
+     *     Filter<Added<T>>(tick)/Filter<Changed<T>>(tick)只保留组件在tick之后被添加/修改的实体，T须是Ts之一且为SparseSet存储。
+     *     有过滤器时由被过滤的池驱动，变更计数未超过tick的块整块跳过。
+     *     以非const类型访问的SparseSet组件在func返回后记为已修改。
+     * EN: The pool with the fewest entities drives the iteration by index, the other pools are probed,
+     *     entities missing any component are skipped. func(EntityID, Ts&...) is a template parameter
+     *     and can be inlined. Writing a component type as const T marks it read-only.
+     *     Each(begin, end, func) only covers [begin, end) of the driving pool, so disjoint ranges can run
+     *     on different threads (see above). Pools must not be added to or removed from while iterating.
+     *
+     *     Filter<Added<T>>(tick)/Filter<Changed<T>>(tick) keep only entities whose T was added/changed after tick;
+     *     T must be one of Ts and use SparseSet storage. A filtered pool drives the iteration and chunks whose change
+     *     ticks are not past tick are skipped whole.
+     *     SparseSet components accessed as non-const are marked changed after func returns.
+     */
+    template<typename... Ts>
+    class View
+    {
+        static_assert(sizeof...(Ts) > 0, "View needs at least one component type");
+
+        template<typename T> using PoolOf = ComponentPool<std::remove_const_t<T>>;
+        template<size_t J> using TypeAt = std::tuple_element_t<J, std::tuple<Ts...>>;
+        template<size_t J> static constexpr bool IS_TRACKED = view_detail::IsTracked<PoolOf<TypeAt<J>>>::value;
+
+        static constexpr uint32 CHUNK_BITS = ChangeTickTable::CHUNK_BITS;
+
+        struct FilterEntry
+        {
+            size_t pool;                                ///< CN: 在Ts中的位置 / EN: Position in Ts
+            bool added;                                 ///< CN: true为Added，false为Changed / EN: true for Added, false for Changed
+            uint32 since;
+        };
+
+        struct ExcludeEntry
+        {
+            const void* pool;
+            bool (*has)(const void* pool, EntityID entity_id);
+        };
+
+        std::tuple<PoolOf<Ts>*...> pools;
+        std::vector<ExcludeEntry> exclude_list;
+        std::vector<FilterEntry> filter_list;
+        size_t driver = 0;                              ///< CN: 驱动池在Ts中的位置 / EN: Position of the driving pool in Ts
+
+        template<typename P>
+        static bool PoolHas(const void* pool, EntityID entity_id)
+        {
+            return static_cast<const P*>(pool)->Has(entity_id);
+        }
+
+        bool IsExcluded(EntityID entity_id) const
+        {
+            for (const ExcludeEntry& e : exclude_list)
+                if (e.has(e.pool, entity_id))
+                    return true;
+
+            return false;
+        }
+
+        template<typename T>
+        static constexpr size_t IndexOf()
+        {
+            constexpr bool match[] = {std::is_same_v<std::remove_const_t<Ts>, T>...};
+
+            for (size_t i = 0; i < sizeof...(Ts); ++i)
+                if (match[i])
+                    return i;
+
+            return sizeof...(Ts);
+        }
+
+        /**
+         * CN: 组件在池中的紧密下标，驱动池即为i，其余池由指针求得
+         * EN: Dense index of a component, i for the driving pool, derived from the pointer for the others
+         */
+        template<size_t D, size_t J>
+        int IndexIn(size_t i, const TypeAt<J>* component) const
+        {
+            if constexpr (J == D)
+                return static_cast<int>(i);
+            else
+                return static_cast<int>(component - std::get<J>(pools)->GetData());
+        }
+
+        template<size_t D>
+        bool ChunkPasses(uint32 chunk) const
+        {
+            if constexpr (IS_TRACKED<D>)
+            {
+                const ChangeTickTable& ticks = std::get<D>(pools)->GetChangeTicks();
+
+                for (const FilterEntry& f : filter_list)
+                    if (f.pool == D && !(f.added ? ticks.IsChunkAddedSince(chunk, f.since) : ticks.IsChunkChangedSince(chunk, f.since)))
+                        return false;
+            }
+
+            return true;
+        }
+
+        template<size_t D, size_t J>
+        bool ElementPasses(const FilterEntry& f, size_t i, const TypeAt<J>* component) const
+        {
+            if constexpr (IS_TRACKED<J>)
+            {
+                const ChangeTickTable& ticks = std::get<J>(pools)->GetChangeTicks();
+                const uint32 index = static_cast<uint32>(IndexIn<D, J>(i, component));
+
+                return f.added ? ticks.IsAddedSince(index, f.since) : ticks.IsChangedSince(index, f.since);
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        template<size_t D, size_t... J>
+        bool PassFilters(size_t i, const std::tuple<Ts*...>& components, std::index_sequence<J...>) const
+        {
+            for (const FilterEntry& f : filter_list)
+            {
+                bool pass = true;
+
+                ((f.pool == J ? (pass = ElementPasses<D, J>(f, i, std::get<J>(components)), true) : false) || ...);
+
+                if (!pass)
+                    return false;
+            }
+
+            return true;
+        }
+
+        template<size_t D, size_t J>
+        void MarkWrite(size_t i, TypeAt<J>* component)
+        {
+            if constexpr (!std::is_const_v<TypeAt<J>> && IS_TRACKED<J>)
+                std::get<J>(pools)->MarkChangedAt(IndexIn<D, J>(i, component));
+        }
+
+        template<size_t D, size_t J>
+        auto* Fetch(EntityID entity_id, int index)
+        {
+            if constexpr (J == D)
+                return std::get<J>(pools)->GetAt(index);
+            else
+                return std::get<J>(pools)->Get(entity_id);
+        }
+
+        template<size_t D, typename F, size_t... J>
+        void RunDriven(size_t begin, size_t end, F& func, std::index_sequence<J...> seq)
+        {
+            auto* driver_pool = std::get<D>(pools);
+
+            end = std::min(end, static_cast<size_t>(driver_pool->GetCount()));
+
+            const bool filtered = !filter_list.empty();
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                // 块的第一个元素处检查块计数，未变化则跳到下一块
+                if (filtered && (i == begin || (i & ((size_t(1) << CHUNK_BITS) - 1)) == 0) && !ChunkPasses<D>(static_cast<uint32>(i >> CHUNK_BITS)))
+                {
+                    i = (((i >> CHUNK_BITS) + 1) << CHUNK_BITS) - 1;
+                    continue;
+                }
+
+                const EntityID entity_id = driver_pool->GetEntity(static_cast<int>(i));
+                const std::tuple<Ts*...> components(Fetch<D, J>(entity_id, static_cast<int>(i))...);
+
+                if ((... || !std::get<J>(components)))
+                    continue;
+
+                if (!exclude_list.empty() && IsExcluded(entity_id))
+                    continue;
+
+                if (filtered && !PassFilters<D>(i, components, seq))
+                    continue;
+
+                func(entity_id, *std::get<J>(components)...);
+
+                (MarkWrite<D, J>(i, std::get<J>(components)), ...);
+            }
+        }
+
+        template<typename F, size_t... D>
+        void Dispatch(size_t begin, size_t end, F& func, std::index_sequence<D...> seq)
+        {
+            (void)((driver == D ? (RunDriven<D>(begin, end, func, seq), true) : false) || ...);
+        }
+
+    public:
+
+        View(PoolOf<Ts>&... component_pools) : pools(&component_pools...)
+        {
+            SelectDriver();
+        }
+
+        /**
+         * CN: 排除拥有该组件的实体
+         * EN: Skip entities owning this component
+         */
+        template<typename T, ComponentStorageType S>
+        View& Exclude(const ComponentPool<T, S>& pool)
+        {
+            exclude_list.push_back({&pool, &PoolHas<ComponentPool<T, S>>});
+            return *this;
+        }
+
+        /**
+         * CN: 只保留组件在since_tick之后被添加(Added<T>)或修改(Changed<T>)的实体
+         * EN: Keep only entities whose component was added (Added<T>) or changed (Changed<T>) after since_tick
+         */
+        template<typename F>
+        View& Filter(uint32 since_tick)
+        {
+            constexpr size_t J = IndexOf<typename view_detail::FilterTraits<F>::Component>();
+
+            static_assert(J < sizeof...(Ts), "Filter component must be one of the View's components");
+
+            if constexpr (J < sizeof...(Ts))
+            {
+                static_assert(IS_TRACKED<J>, "Filters need a SparseSet pool, only it keeps change ticks");
+
+                filter_list.push_back({J, view_detail::FilterTraits<F>::ADDED, since_tick});
+                SelectDriver();
+            }
+
+            return *this;
+        }
+
+        /**
+         * CN: 重新选择实体最少的池作为驱动，有过滤器时只在被过滤的池中选，池的大小变化较大后调用
+         * EN: Pick the smallest pool as driver again, only among filtered pools when filters exist; call after pool sizes changed noticeably
+         */
+        void SelectDriver()
+        {
+            std::apply([this](auto*... p)
+            {
+                int counts[] = {p->GetCount()...};
+
+                if (!filter_list.empty())
+                {
+                    bool is_filtered[sizeof...(Ts)] = {};
+
+                    for (const FilterEntry& f : filter_list)
+                        is_filtered[f.pool] = true;
+
+                    for (size_t i = 0; i < sizeof...(Ts); ++i)
+                        if (!is_filtered[i])
+                            counts[i] = std::numeric_limits<int>::max();
+                }
+
+                driver = std::min_element(counts, counts + sizeof...(Ts)) - counts;
+            }, pools);
+        }
+
+        size_t GetDriver() const { return driver; }
+
+        /**
+         * CN: 驱动池的大小，即Each(begin, end, func)的下标范围
+         * EN: Size of the driving pool, the index range of Each(begin, end, func)
+         */
+        size_t GetSize() const
+        {
+            size_t size = 0;
+            size_t index = 0;
+
+            std::apply([&](auto*... p)
+            {
+                ((index++ == driver ? (size = static_cast<size_t>(p->GetCount())) : 0), ...);
+            }, pools);
+
+            return size;
+        }
+
+        template<typename F>
+        void Each(F&& func)
+        {
+            Dispatch(0, GetSize(), func, std::index_sequence_for<Ts...>{});
+        }
+
+        template<typename F>
+        void Each(size_t begin, size_t end, F&& func)
+        {
+            Dispatch(begin, end, func, std::index_sequence_for<Ts...>{});
+        }
+    };
+
+    /**
+     * CN: 多组件视图（基于ArchetypeStorage）
+     * EN: Multi-component view over an ArchetypeStorage
+     *
+     * CN: 构造时收集拥有全部Ts且不含排除组件的原型的所有非空块，遍历时直接按列读取，不需要查表。
+     *     块列表是可拆分的区间：EachChunk(begin, end, func)/Each(begin, end, func)只处理第[begin, end)个块。
+     *     存储结构变化（增删实体或组件）后需调用Refresh。
+     * EN: Construction collects every non-empty chunk of archetypes owning all Ts and none of the excluded
+     *     components, iteration reads columns directly with no lookups. The chunk list is a splittable range:
+     *     EachChunk(begin, end, func)/Each(begin, end, func) only cover chunks [begin, end).
+     *     Call Refresh after structural changes (adding/removing entities or components).
+     */
+    template<typename... Ts>
+    class ArchetypeView
+    {
+        static_assert(sizeof...(Ts) > 0, "ArchetypeView needs at least one component type");
+
+    public:
+
+        struct ChunkRef
+        {
+            Archetype* archetype;
+            uint32 chunk;
+            std::array<int, sizeof...(Ts)> columns;
+        };
+
+    private:
+
+        ArchetypeStorage* storage;
+        std::vector<ComponentTypeID> exclude_types;
+        std::vector<ChunkRef> chunk_list;
+        uint32 entity_count = 0;
+
+        bool IsExcluded(const Archetype* archetype) const
+        {
+            for (ComponentTypeID type : exclude_types)
+                if (archetype->FindColumn(type) >= 0)
+                    return true;
+
+            return false;
+        }
+
+        template<typename F, size_t... I>
+        static void CallChunk(const ChunkRef& ref, F& func, std::index_sequence<I...>)
+        {
+            const Archetype* archetype = ref.archetype;
+
+            func(archetype->GetChunk(ref.chunk).count,
+                 static_cast<const EntityID*>(archetype->GetEntities(ref.chunk)),
+                 static_cast<Ts*>(archetype->GetColumn(ref.chunk, ref.columns[I]))...);
+        }
+
+    public:
+
+        ArchetypeView(ArchetypeStorage& archetype_storage) : storage(&archetype_storage)
+        {
+            Refresh();
+        }
+
+        /**
+         * CN: 排除拥有这些组件的原型
+         * EN: Skip archetypes owning any of these components
+         */
+        template<typename... Ex>
+        ArchetypeView& Exclude()
+        {
+            (exclude_types.push_back(GetComponentTypeID<Ex>()), ...);
+            Refresh();
+            return *this;
+        }
+
+        void Refresh()
+        {
+            const ComponentTypeID ids[] = {GetComponentTypeID<Ts>()...};
+
+            chunk_list.clear();
+            entity_count = 0;
+
+            for (Archetype* archetype : storage->GetArchetypes())
+            {
+                if (archetype->GetEntityCount() == 0
+                    || !archetype->HasAll(ids, sizeof...(Ts))
+                    || IsExcluded(archetype))
+                    continue;
+
+                const std::array<int, sizeof...(Ts)> columns{archetype->FindColumn(GetComponentTypeID<Ts>())...};
+
+                for (uint32 c = 0; c < archetype->GetChunkCount(); ++c)
+                    if (archetype->GetChunk(c).count > 0)
+                        chunk_list.push_back({archetype, c, columns});
+
+                entity_count += archetype->GetEntityCount();
+            }
+        }
+
+        size_t GetChunkCount() const { return chunk_list.size(); }
+        uint32 GetEntityCount() const { return entity_count; }
+        const std::vector<ChunkRef>& GetChunks() const { return chunk_list; }
+
+        /**
+         * CN: 按块遍历，func(uint32 count, const EntityID*, Ts*...)
+         * EN: Iterate by chunk, func(uint32 count, const EntityID*, Ts*...)
+         */
+        template<typename F>
+        void EachChunk(size_t begin, size_t end, F&& func)
+        {
+            end = std::min(end, chunk_list.size());
+
+            for (size_t i = begin; i < end; ++i)
+                CallChunk(chunk_list[i], func, std::index_sequence_for<Ts...>{});
+        }
+
+        template<typename F>
+        void EachChunk(F&& func)
+        {
+            EachChunk(0, chunk_list.size(), func);
+        }
+
+        /**
+         * CN: 逐个实体遍历第[begin, end)个块，func(EntityID, Ts&...)
+         * EN: Iterate entities of chunks [begin, end), func(EntityID, Ts&...)
+         */
+        template<typename F>
+        void Each(size_t begin, size_t end, F&& func)
+        {
+            EachChunk(begin, end, [&func](uint32 count, const EntityID* entities, Ts*... columns)
+            {
+                for (uint32 r = 0; r < count; ++r)
+                    func(entities[r], columns[r]...);
+            });
+        }
+
+        template<typename F>
+        void Each(F&& func)
+        {
+            Each(0, chunk_list.size(), func);
+        }
+    };
+
+} // namespace hgl::ecs
@@ -1,5 +1,6 @@
 #include<hgl/time/Time.h>
 #include<hgl/math/Transform.h>
+#include"../task/ParallelFor.h"
 #include<iostream>
 #include <random>
 
@@ -49,17 +50,50 @@ int main(int,char **)
     }
 
     tp=t;
+    mp=m;
 
     st=GetPreciseTime();
     for(int i=0;i<TEST_COUNT;i++)
     {
-        *m=tp->GetMatrix();
+        *mp=tp->GetMatrix();
 
         ++tp;
-        ++m;
+        ++mp;
     }
     et=GetPreciseTime();
 
-    std::cout<<"Transform::GetMatrix() "<<TEST_COUNT<<" time: "<<et-st<<"sec."<<std::endl;
+    const double serial_time=et-st;
+
+    std::cout<<"Transform::GetMatrix() "<<TEST_COUNT<<" time: "<<serial_time<<"sec."<<std::endl;
+
+    //按计算线程数逐个测试ParallelFor的加速比
+    {
+        uint32 max_workers;
+
+        {
+            task::TaskExecutor te;
+            max_workers=te.GetTopology().GetCpuCount();
+        }
+
+        for(uint32 n=1;n<=max_workers;n++)
+        {
+            task::TaskExecutor te;
+
+            te.Start(n,0);
+
+            st=GetPreciseTime();
+            task::ParallelFor(te,task::IndexRange(0,TEST_COUNT),4096,[t,m](const task::IndexRange &r)
+            {
+                for(size_t i=r.begin;i<r.end;i++)
+                    m[i]=t[i].GetMatrix();
+            });
+            et=GetPreciseTime();
+
+            std::cout<<"ParallelFor "<<n<<" workers time: "<<et-st<<"sec, speedup: "<<serial_time/(et-st)<<std::endl;
+        }
+    }
+
+    delete[] m;
+    delete[] t;
     return 0;
-}
\ No newline at end of file
+}
@@ -6,14 +6,18 @@
 #include<hgl/2d/BitmapSave.h>
 #include<hgl/2d/DrawGeometry.h>
 #include<hgl/time/Time.h>
+#include"../task/ParallelFor.h"
 #include<iostream>
 #include<random>
+#include<vector>
 
 std::random_device rd;
 std::mt19937 gen(rd());
 std::uniform_real_distribution<> dis_01(0, 1);
 std::uniform_int_distribution<> dis_int(0, 1023);
 
+constexpr const int TEST_POINT_COUNT=10000;
+
 using namespace hgl;
 using namespace std;
 
@@ -33,7 +37,6 @@ void Pick2DTriangle()
 
     Vector2i v[3];
     Vector3i edge_length;
-    Vector2i t;
     
     for(int i=0;i<3;i++)
     {
@@ -66,25 +69,56 @@ void Pick2DTriangle()
     draw.DrawLine(v[1],v[2]);
     draw.DrawLine(v[2],v[0]);
 
+    //随机数生成器不是线程安全的，所以先统一生成测试点
+    std::vector<Vector2i> points(TEST_POINT_COUNT);
+    std::vector<uint8> inside(TEST_POINT_COUNT);
+
+    for(Vector2i &p:points)
+    {
+        p.x=dis_int(gen);
+        p.y=dis_int(gen);
+    }
+
     double st=GetPreciseTime();
 
-    for(int i=0;i<10000;i++)
+    for(int i=0;i<TEST_POINT_COUNT;i++)
+        inside[i]=tri.PointIn(points[i]);
+
+    double et=GetPreciseTime();
+
+    const double serial_time=et-st;
+
+    std::cout<<"test "<<TEST_POINT_COUNT<<" points in a triangle cost "<<serial_time<<" seconds."<<std::endl;
+
     {
-        t.x=dis_int(gen);
-        t.y=dis_int(gen);
+        task::TaskExecutor te;
 
-        if(tri.PointIn(t))
+        te.Start(te.GetTopology().GetCpuCount(),0);
+
+        st=GetPreciseTime();
+
+        task::ParallelFor(te,task::IndexRange(0,TEST_POINT_COUNT),256,[&](const task::IndexRange &r)
+        {
+            for(size_t i=r.begin;i<r.end;i++)
+                inside[i]=tri.PointIn(points[i]);
+        });
+
+        et=GetPreciseTime();
+
+        std::cout<<"ParallelFor "<<te.GetComputeWorkerCount()<<" workers cost "<<(et-st)<<" seconds, speedup: "<<serial_time/(et-st)<<std::endl;
+    }
+
+    //绘制只在主线程进行
+    for(int i=0;i<TEST_POINT_COUNT;i++)
+    {
+        if(inside[i])
             draw.SetDrawColor(Vector3u8(0,255,0));
         else
             draw.SetDrawColor(Vector3u8(0,0,255));
 
-        draw.PutPixel(t);
+        draw.PutPixel(points[i]);
     }
 
-    double et=GetPreciseTime();
-
-    std::cout<<"test 10000 points in a triangle cost "<<(et-st)<<" seconds."<<std::endl;
-
     bitmap::SaveBitmapToTGA(OS_TEXT("Triangle.tga"),&bmp);
 }
 
@@ -0,0 +1,520 @@
+#pragma once
+
+#include"TaskExecutor.h"
+#include<coroutine>
+#include<exception>
+#include<fstream>
+#include<optional>
+#include<queue>
+#include<string>
+#include<utility>
+
+namespace hgl::task
+{
+    template<typename T = void> class Task;
+
+    namespace coroutine_detail
+    {
+        /**
+         * CN: 结束时恢复等待者（对称转移），没有等待者时直接挂起
+         * EN: Resumes the awaiter on completion (symmetric transfer), suspends if there is none
+         */
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template<typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) const noexcept
+            {
+                if (h.promise().continuation)
+                    return h.promise().continuation;
+
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        template<typename T>
+        struct Promise : PromiseBase
+        {
+            std::optional<T> value;
+
+            Task<T> get_return_object();
+
+            template<typename V>
+            void return_value(V &&v) { value.emplace(std::forward<V>(v)); }
+
+            T Take()
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct Promise<void> : PromiseBase
+        {
+            Task<void> get_return_object();
+
+            void return_void() {}
+
+            void Take()
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+    }//namespace coroutine_detail
+
+    /**
+     * CN: 协程任务
+     * EN: Coroutine task
+     *
+     * CN: 惰性启动，被co_await时才在等待者所在线程上开始执行，完成后直接恢复等待者。
+     *     协程内co_await AsyncRuntime提供的等待体时会让出当前工作线程，之后由执行器的队列恢复，
+     *     不会阻塞工作线程。顶层任务用AsyncRuntime::Spawn或SyncWait启动。
+     * EN: Lazily started: runs on the awaiting thread once co_awaited and resumes the awaiter directly on completion.
+     *     Awaiting one of the AsyncRuntime awaitables gives the worker back, the coroutine is later resumed
+     *     from the executor queues so no worker is ever blocked. Top level tasks are started with
+     *     AsyncRuntime::Spawn or SyncWait.
+     */
+    template<typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+
+        using promise_type = coroutine_detail::Promise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+    private:
+
+        Handle handle;
+
+    public:
+
+        explicit Task(Handle h) : handle(h) {}
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle)
+                    handle.destroy();
+
+                handle = std::exchange(other.handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task()
+        {
+            if (handle)
+                handle.destroy();
+        }
+
+        bool IsDone() const { return !handle || handle.done(); }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                Handle handle;
+
+                bool await_ready() const noexcept { return !handle || handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().Take(); }
+            };
+
+            return Awaiter{handle};
+        }
+    };
+
+    namespace coroutine_detail
+    {
+        template<typename T>
+        Task<T> Promise<T>::get_return_object() { return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this)); }
+
+        inline Task<void> Promise<void>::get_return_object() { return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this)); }
+
+        /**
+         * CN: 不被等待的顶层协程，结束时自行销毁
+         * EN: Fire-and-forget top level coroutine, destroys itself on completion
+         */
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
+    }//namespace coroutine_detail
+
+    /**
+     * CN: 文件读取结果
+     * EN: File read result
+     */
+    struct FileReadResult
+    {
+        bool ok = false;
+        std::string data;
+    };
+
+    /**
+     * CN: 协程运行时
+     * EN: Coroutine runtime
+     *
+     * CN: 在TaskExecutor之上提供协程等待体：切换到大核、切换到小核、定时器与文件读取完成。
+     *     定时器与文件读取由运行时自带的专用线程处理，完成后把协程投递回挂起前所在的工作组。
+     *     销毁运行时前必须保证所有协程都已结束。
+     * EN: Provides coroutine awaitables on top of TaskExecutor: switch to big cores, switch to little cores,
+     *     timers and file-read completion. Timers and file reads are handled by the runtime's own threads,
+     *     on completion the coroutine is posted back to the worker group it was suspended on.
+     *     All coroutines must have finished before the runtime is destroyed.
+     */
+    class AsyncRuntime
+    {
+        struct TimerEntry
+        {
+            double due;
+            std::coroutine_handle<> handle;
+            bool background;
+
+            bool operator>(const TimerEntry &other) const { return due > other.due; }
+        };
+
+        struct ReadRequest
+        {
+            std::string filename;
+            FileReadResult *result;
+            std::coroutine_handle<> handle;
+            bool background;
+        };
+
+        TaskExecutor *executor;
+
+        std::mutex timer_lock;
+        std::condition_variable timer_cv;
+        std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> timers;
+        std::thread timer_thread;
+
+        std::mutex io_lock;
+        std::condition_variable io_cv;
+        std::queue<ReadRequest> io_requests;
+        std::vector<std::thread> io_threads;
+
+        std::atomic<bool> running{true};
+
+    public:
+
+        /**
+         * @param io_thread_count CN: 文件读取线程数 / EN: Number of file reading threads
+         */
+        AsyncRuntime(TaskExecutor *te, uint32 io_thread_count = 2) : executor(te)
+        {
+            timer_thread = std::thread([this]() { TimerLoop(); });
+
+            for (uint32 i = 0; i < (io_thread_count > 0 ? io_thread_count : 1); ++i)
+                io_threads.emplace_back([this]() { IOLoop(); });
+        }
+
+        ~AsyncRuntime()
+        {
+            running = false;
+
+            {
+                std::lock_guard<std::mutex> lock(timer_lock);      // 保证等待中的线程能看到running的变化
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(io_lock);
+            }
+
+            timer_cv.notify_all();
+            io_cv.notify_all();
+
+            timer_thread.join();
+
+            for (std::thread &t : io_threads)
+                t.join();
+        }
+
+        AsyncRuntime(const AsyncRuntime &) = delete;
+        AsyncRuntime &operator=(const AsyncRuntime &) = delete;
+
+        TaskExecutor *GetExecutor() const { return executor; }
+
+        /**
+         * CN: 把协程投递到计算组或后台组的队列中恢复
+         * EN: Post a coroutine to the compute or background queues for resumption
+         */
+        void Resume(std::coroutine_handle<> h, bool background)
+        {
+            if (background)
+                executor->AddBackgroundTask([h]() { h.resume(); });
+            else
+                executor->AddComputeTask([h]() { h.resume(); });
+        }
+
+        /**
+         * CN: co_await后在大核(计算组)上继续执行
+         * EN: co_await to continue on big cores (compute group)
+         */
+        auto SwitchToBig()
+        {
+            struct Awaiter
+            {
+                AsyncRuntime *rt;
+
+                bool await_ready() const { return rt->executor->IsComputeWorker(); }
+                void await_suspend(std::coroutine_handle<> h) { rt->Resume(h, false); }
+                void await_resume() const {}
+            };
+
+            return Awaiter{this};
+        }
+
+        /**
+         * CN: co_await后在小核(后台组)上继续执行，统一架构下作为低优先级任务恢复
+         * EN: co_await to continue on little cores (background group), resumed as a low priority task on unified architectures
+         */
+        auto SwitchToLittle()
+        {
+            struct Awaiter
+            {
+                AsyncRuntime *rt;
+
+                bool await_ready() const { return rt->executor->IsBackgroundWorker(); }
+                void await_suspend(std::coroutine_handle<> h) { rt->Resume(h, true); }
+                void await_resume() const {}
+            };
+
+            return Awaiter{this};
+        }
+
+        /**
+         * CN: co_await挂起指定秒数，期间不占用工作线程
+         * EN: co_await to suspend for the given seconds without holding a worker
+         */
+        auto Delay(double seconds)
+        {
+            struct Awaiter
+            {
+                AsyncRuntime *rt;
+                double seconds;
+
+                bool await_ready() const { return seconds <= 0; }
+
+                void await_suspend(std::coroutine_handle<> h)
+                {
+                    AsyncRuntime *runtime = rt;                 // 入队后协程可能立即被恢复并销毁本等待体
+
+                    {
+                        std::lock_guard<std::mutex> lock(runtime->timer_lock);
+                        runtime->timers.push({GetPreciseTime() + seconds, h, runtime->executor->IsBackgroundWorker()});
+                    }
+
+                    runtime->timer_cv.notify_one();
+                }
+
+                void await_resume() const {}
+            };
+
+            return Awaiter{this, seconds};
+        }
+
+        /**
+         * CN: co_await读取整个文件，读取在IO线程上进行，完成后回到原工作组
+         * EN: co_await to read a whole file, reading happens on an IO thread and the coroutine returns to its group afterwards
+         */
+        auto ReadFile(const std::string &filename)
+        {
+            struct Awaiter
+            {
+                AsyncRuntime *rt;
+                std::string filename;
+                FileReadResult result;
+
+                bool await_ready() const { return false; }
+
+                void await_suspend(std::coroutine_handle<> h)
+                {
+                    AsyncRuntime *runtime = rt;                 // 入队后协程可能立即被恢复并销毁本等待体
+
+                    {
+                        std::lock_guard<std::mutex> lock(runtime->io_lock);
+                        runtime->io_requests.push({filename, &result, h, runtime->executor->IsBackgroundWorker()});
+                    }
+
+                    runtime->io_cv.notify_one();
+                }
+
+                FileReadResult await_resume() { return std::move(result); }
+            };
+
+            return Awaiter{this, filename, {}};
+        }
+
+        /**
+         * CN: 启动一个顶层协程，不等待其完成
+         * EN: Start a top level coroutine without waiting for it
+         */
+        template<typename T>
+        void Spawn(Task<T> &&task)
+        {
+            auto wrapper = [](AsyncRuntime *rt, Task<T> t) -> coroutine_detail::DetachedTask
+            {
+                co_await rt->SwitchToBig();
+                co_await std::move(t);
+            };
+
+            wrapper(this, std::move(task));
+        }
+
+        /**
+         * CN: 在执行器上运行协程并阻塞等待结果，只能在非工作线程中调用
+         * EN: Run a coroutine on the executor and block for its result, must not be called on a worker
+         */
+        template<typename T>
+        T SyncWait(Task<T> &&task)
+        {
+            std::mutex lock;
+            std::condition_variable cv;
+            bool finished = false;
+            std::exception_ptr exception;
+            std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+
+            auto wrapper = [&](Task<T> t) -> coroutine_detail::DetachedTask
+            {
+                co_await SwitchToBig();
+
+                try
+                {
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        co_await std::move(t);
+                        value.emplace(true);
+                    }
+                    else
+                    {
+                        value.emplace(co_await std::move(t));
+                    }
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lg(lock);
+                finished = true;
+                cv.notify_all();
+            };
+
+            wrapper(std::move(task));
+
+            {
+                std::unique_lock<std::mutex> ul(lock);
+                cv.wait(ul, [&finished]() { return finished; });
+            }
+
+            if (exception)
+                std::rethrow_exception(exception);
+
+            if constexpr (!std::is_void_v<T>)
+                return std::move(*value);
+        }
+
+    private:
+
+        void TimerLoop()
+        {
+            std::unique_lock<std::mutex> lock(timer_lock);
+
+            while (running)
+            {
+                if (timers.empty())
+                {
+                    timer_cv.wait(lock);
+                    continue;
+                }
+
+                const double now = GetPreciseTime();
+                const TimerEntry top = timers.top();
+
+                if (top.due > now)
+                {
+                    timer_cv.wait_for(lock, std::chrono::duration<double>(top.due - now));
+                    continue;
+                }
+
+                timers.pop();
+
+                lock.unlock();
+                Resume(top.handle, top.background);
+                lock.lock();
+            }
+        }
+
+        void IOLoop()
+        {
+            while (true)
+            {
+                ReadRequest req;
+
+                {
+                    std::unique_lock<std::mutex> lock(io_lock);
+
+                    io_cv.wait(lock, [this]() { return !io_requests.empty() || !running; });
+
+                    if (io_requests.empty())
+                        return;
+
+                    req = std::move(io_requests.front());
+                    io_requests.pop();
+                }
+
+                std::ifstream file(req.filename, std::ios::binary | std::ios::ate);
+
+                if (file)
+                {
+                    const std::streamsize size = file.tellg();
+
+                    req.result->data.resize(static_cast<size_t>(size));
+                    file.seekg(0);
+                    req.result->ok = static_cast<bool>(file.read(req.result->data.data(), size));
+                }
+
+                Resume(req.handle, req.background);
+            }
+        }
+    };
+
+} // namespace hgl::task
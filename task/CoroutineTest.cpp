@@ -0,0 +1,157 @@
+#include "Coroutine.h"
+#include <hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace hgl;
+using namespace std;
+
+constexpr const uint32 FILE_COUNT       = 8;        // 模拟的CSV文件数量
+constexpr const uint32 LINES_PER_FILE   = 200000;   // 每个文件的行数
+constexpr const uint32 GRID_SIZE        = 64;       // 统计网格大小
+constexpr const double STORAGE_LATENCY  = 0.05;     // 模拟慢速存储的额外延迟(秒)
+
+struct JobResult
+{
+    string filename;
+    uint32 points = 0;
+    uint32 top_count = 0;
+
+    int32 parse_worker = -1;                        // 解析所在工作线程
+    int32 report_worker = -1;                       // 汇总所在工作线程
+};
+
+void CreateSampleFiles()
+{
+    mt19937 gen(1234);
+    normal_distribution<> dis(512, 160);
+
+    for (uint32 f = 0; f < FILE_COUNT; ++f) {
+        ofstream out("coroutine_sample_" + to_string(f) + ".csv");
+
+        for (uint32 i = 0; i < LINES_PER_FILE; ++i)
+            out << int(dis(gen)) << ',' << int(dis(gen)) << '\n';
+    }
+}
+
+/**
+ * 一个CSV到统计图的任务：IO线程读文件，大核解析统计，小核生成汇总
+ */
+task::Task<JobResult> ChartJob(task::AsyncRuntime &rt, string filename)
+{
+    JobResult result;
+
+    result.filename = filename;
+
+    co_await rt.Delay(STORAGE_LATENCY);
+
+    task::FileReadResult file = co_await rt.ReadFile(filename);
+
+    if (!file.ok)
+        co_return result;
+
+    co_await rt.SwitchToBig();
+
+    result.parse_worker = task::TaskExecutor::GetCurrentWorkerID();
+
+    vector<uint32> grid(GRID_SIZE * GRID_SIZE, 0);
+
+    {
+        const char *p = file.data.data();
+        const char *end = p + file.data.size();
+
+        while (p < end) {
+            char *next;
+            const long x = strtol(p, &next, 10);
+
+            if (*next != ',')
+                break;
+
+            const long y = strtol(next + 1, &next, 10);
+
+            p = next + 1;
+
+            if (x < 0 || y < 0 || x >= 1024 || y >= 1024)
+                continue;
+
+            ++grid[(y * GRID_SIZE / 1024) * GRID_SIZE + x * GRID_SIZE / 1024];
+            ++result.points;
+        }
+    }
+
+    co_await rt.SwitchToLittle();
+
+    result.report_worker = task::TaskExecutor::GetCurrentWorkerID();
+
+    for (uint32 c : grid)
+        if (c > result.top_count)
+            result.top_count = c;
+
+    co_return result;
+}
+
+void PrintResult(const JobResult &r)
+{
+    cout << "  " << setw(26) << left << r.filename << right
+         << " points " << setw(8) << r.points
+         << "  top " << setw(6) << r.top_count
+         << "  parse on worker " << setw(2) << r.parse_worker
+         << ", report on worker " << setw(2) << r.report_worker << endl;
+}
+
+int main(int, char **)
+{
+    cout << "=== Coroutine CSV-to-chart jobs ===" << endl;
+
+    CreateSampleFiles();
+
+    task::TaskExecutor executor;
+    executor.Start();
+
+    cout << "Workers: " << executor.GetComputeWorkerCount() << " compute, "
+         << executor.GetBackgroundWorkerCount() << " background" << endl;
+
+    task::AsyncRuntime rt(&executor);
+
+    //逐个等待，读取与计算不重叠
+    {
+        const double st = GetPreciseTime();
+
+        for (uint32 f = 0; f < FILE_COUNT; ++f)
+            rt.SyncWait(ChartJob(rt, "coroutine_sample_" + to_string(f) + ".csv"));
+
+        cout << "\nSequential: " << GetPreciseTime() - st << " sec" << endl;
+    }
+
+    //全部同时启动，读取、等待与计算互相重叠
+    {
+        vector<JobResult> results(FILE_COUNT);
+        atomic<uint32> remaining{FILE_COUNT};
+
+        auto run = [&rt, &results, &remaining](uint32 index) -> task::Task<void> {
+            results[index] = co_await ChartJob(rt, "coroutine_sample_" + to_string(index) + ".csv");
+            remaining.fetch_sub(1, memory_order_release);
+        };
+
+        const double st = GetPreciseTime();
+
+        for (uint32 f = 0; f < FILE_COUNT; ++f)
+            rt.Spawn(run(f));
+
+        while (remaining.load(memory_order_acquire) > 0)
+            this_thread::yield();
+
+        cout << "Overlapped: " << GetPreciseTime() - st << " sec" << endl << endl;
+
+        for (const JobResult &r : results)
+            PrintResult(r);
+    }
+
+    for (uint32 f = 0; f < FILE_COUNT; ++f)
+        remove(("coroutine_sample_" + to_string(f) + ".csv").c_str());
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include"CpuTopology.h"
+#include<cstdio>
+#include<cstring>
+#include<string>
+#include<vector>
+
+namespace hgl::task
+{
+    /**
+     * CN: 单个逻辑CPU的运行时采样
+     * EN: Runtime sample of one logical CPU
+     */
+    struct CpuLoadSample
+    {
+        uint32 cpu_id = 0;
+        uint32 cur_freq = 0;                            ///< CN: 当前频率(MHz)，未知为0 / EN: Current frequency (MHz), 0 if unknown
+        uint32 max_freq = 0;                            ///< CN: 最大频率(MHz)，未知为0 / EN: Max frequency (MHz), 0 if unknown
+        double freq_ratio = 1.0;                        ///< CN: 当前频率/最大频率，未知为1 / EN: Current / max frequency, 1 if unknown
+        double load = 0;                                ///< CN: 两次采样之间的繁忙比例(0-1) / EN: Busy fraction between the last two samples (0-1)
+        bool has_load = false;                          ///< CN: 至少采样过两次才有负载数据 / EN: Load is only known after two samples
+    };
+
+    /**
+     * CN: CPU频率与负载采样器
+     * EN: CPU frequency and load sampler
+     *
+     * CN: 读取sysfs中每个CPU的cpufreq/scaling_cur_freq与/proc/stat中的每核计数，
+     *     负载为两次Sample之间非空闲时间的比例。sysfs目录与stat文件均可替换为测试用的假文件。
+     *     每次采样只读取每个CPU一个小文件和一次/proc/stat，开销很低。
+     * EN: Reads cpufreq/scaling_cur_freq of every CPU from sysfs and the per-core counters in /proc/stat,
+     *     load is the non-idle fraction between two Sample calls. Both the sysfs directory and the stat file
+     *     can be replaced with fake files for tests. Each sample reads one small file per CPU plus /proc/stat once.
+     */
+    class CpuLoadMonitor
+    {
+    public:
+
+        struct StatCounter
+        {
+            uint64 busy = 0;                            ///< CN: 非空闲计数 / EN: Non-idle ticks
+            uint64 total = 0;
+            bool valid = false;
+        };
+
+    private:
+
+        std::string sysfs_root;
+        std::string proc_stat;
+
+        std::vector<CpuLoadSample> samples;
+        std::vector<StatCounter> last_stat;             ///< CN: 按cpu_id索引的上一次计数 / EN: Last counters indexed by cpu_id
+        uint32 sample_count = 0;
+
+    public:
+
+        CpuLoadMonitor(const std::string &sysfs = "/sys/devices/system/cpu", const std::string &stat = "/proc/stat")
+            : sysfs_root(sysfs), proc_stat(stat) {}
+
+        const std::string &GetSysfsRoot() const { return sysfs_root; }
+        const std::string &GetProcStat() const { return proc_stat; }
+
+        uint32 GetSampleCount() const { return sample_count; }
+        const std::vector<CpuLoadSample> &GetSamples() const { return samples; }
+
+        const CpuLoadSample *Get(uint32 cpu_id) const
+        {
+            for (const CpuLoadSample &s : samples)
+                if (s.cpu_id == cpu_id)
+                    return &s;
+
+            return nullptr;
+        }
+
+        /**
+         * CN: 直接替换某个CPU的采样，不存在时添加，用于测试
+         * EN: Replace the sample of one CPU, adding it if absent, for tests
+         */
+        void SetSample(const CpuLoadSample &sample)
+        {
+            for (CpuLoadSample &s : samples)
+            {
+                if (s.cpu_id == sample.cpu_id)
+                {
+                    s = sample;
+                    return;
+                }
+            }
+
+            samples.push_back(sample);
+        }
+
+        /**
+         * CN: 按拓扑中的CPU列表初始化
+         * EN: Initialize with the CPU list of a topology
+         */
+        void Init(const CpuTopology &topology)
+        {
+            samples.clear();
+            last_stat.clear();
+            sample_count = 0;
+
+            for (const LogicalCpu &lc : topology.GetCpus())
+            {
+                CpuLoadSample s;
+
+                s.cpu_id = lc.cpu_id;
+
+                if (CpuTopology::ReadUInt(CpuPath(lc.cpu_id) + "/cpufreq/cpuinfo_max_freq", s.max_freq))
+                    s.max_freq /= 1000;
+                else
+                    s.max_freq = lc.max_freq;
+
+                samples.push_back(s);
+            }
+        }
+
+        /**
+         * CN: 采样一次
+         * EN: Take one sample
+         * @return CN: 频率与负载都读取失败时返回false / EN: Returns false if neither frequency nor load could be read
+         */
+        bool Sample()
+        {
+            bool any = false;
+
+            for (CpuLoadSample &s : samples)
+            {
+                uint32 khz;
+
+                if (CpuTopology::ReadUInt(CpuPath(s.cpu_id) + "/cpufreq/scaling_cur_freq", khz))
+                {
+                    s.cur_freq = khz / 1000;
+                    s.freq_ratio = s.max_freq > 0 ? double(s.cur_freq) / double(s.max_freq) : 1.0;
+                    any = true;
+                }
+            }
+
+            std::vector<StatCounter> stat;
+
+            if (ReadProcStat(proc_stat, stat))
+            {
+                any = true;
+
+                for (CpuLoadSample &s : samples)
+                {
+                    if (s.cpu_id >= stat.size() || !stat[s.cpu_id].valid)
+                        continue;
+
+                    if (s.cpu_id < last_stat.size() && last_stat[s.cpu_id].valid)
+                    {
+                        const StatCounter &a = last_stat[s.cpu_id];
+                        const StatCounter &b = stat[s.cpu_id];
+
+                        if (b.total > a.total)
+                        {
+                            s.load = double(b.busy - a.busy) / double(b.total - a.total);
+                            s.has_load = true;
+                        }
+                    }
+                }
+
+                last_stat.swap(stat);
+            }
+
+            ++sample_count;
+            return any;
+        }
+
+        /**
+         * CN: 解析/proc/stat中的"cpuN"行，按cpu_id存放非空闲与总计数
+         * EN: Parse the "cpuN" lines of /proc/stat, storing busy and total ticks by cpu_id
+         */
+        static bool ReadProcStat(const std::string &filename, std::vector<StatCounter> &result)
+        {
+            FILE *fp = fopen(filename.c_str(), "rb");
+
+            if (!fp)
+                return false;
+
+            char line[512];
+
+            while (fgets(line, sizeof(line), fp))
+            {
+                if (strncmp(line, "cpu", 3) != 0 || line[3] < '0' || line[3] > '9')
+                    continue;
+
+                unsigned cpu;
+                unsigned long long v[8] = {};
+
+                // user nice system idle iowait irq softirq steal
+                if (sscanf(line + 3, "%u %llu %llu %llu %llu %llu %llu %llu %llu",
+                           &cpu, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) < 5)
+                    continue;
+
+                if (cpu >= result.size())
+                    result.resize(cpu + 1);
+
+                StatCounter &c = result[cpu];
+
+                c.total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+                c.busy = c.total - v[3] - v[4];
+                c.valid = true;
+            }
+
+            fclose(fp);
+            return !result.empty();
+        }
+
+    private:
+
+        std::string CpuPath(uint32 cpu_id) const
+        {
+            return sysfs_root + "/cpu" + std::to_string(cpu_id);
+        }
+    };
+
+} // namespace hgl::task
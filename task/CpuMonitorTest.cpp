@@ -0,0 +1,291 @@
+#include "TaskExecutor.h"
+#include "CpuLoadMonitor.h"
+#include <hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+using namespace hgl;
+using namespace std;
+
+namespace fs = std::filesystem;
+
+constexpr const uint32 CPU_COUNT        = 8;        // 假拓扑：cpu0-3为1.8GHz小核，cpu4-7为2.8GHz大核
+constexpr const uint32 LITTLE_FREQ      = 1800000;  // kHz
+constexpr const uint32 BIG_FREQ         = 2800000;  // kHz
+
+constexpr const uint32 BUSY_CPU         = 5;        // 被其它进程占满的大核
+constexpr const uint32 THROTTLED_CPU    = 6;        // 有负载且被降频的大核
+
+void WriteFile(const fs::path &path, const string &text)
+{
+    fs::create_directories(path.parent_path());
+
+    ofstream out(path);
+    out << text << '\n';
+}
+
+/**
+ * 生成一个假的/sys/devices/system/cpu目录
+ */
+void CreateFakeSysfs(const fs::path &root)
+{
+    WriteFile(root / "online", "0-" + to_string(CPU_COUNT - 1));
+
+    for (uint32 i = 0; i < CPU_COUNT; ++i) {
+        const fs::path cpu = root / ("cpu" + to_string(i));
+        const bool big = i >= CPU_COUNT / 2;
+
+        WriteFile(cpu / "topology" / "core_id", to_string(i));
+        WriteFile(cpu / "topology" / "cluster_id", big ? "1" : "0");
+        WriteFile(cpu / "cache" / "index3" / "shared_cpu_list", "0-" + to_string(CPU_COUNT - 1));
+        WriteFile(cpu / "cpufreq" / "cpuinfo_max_freq", to_string(big ? BIG_FREQ : LITTLE_FREQ));
+        WriteFile(cpu / "cpufreq" / "scaling_cur_freq", to_string(big ? BIG_FREQ : LITTLE_FREQ));
+    }
+}
+
+/**
+ * 写一份假的/proc/stat，每个CPU经过ticks个时钟，其中busy[i]个为非空闲
+ */
+void WriteFakeStat(const fs::path &filename, uint64 ticks, const uint64 *busy)
+{
+    ofstream out(filename);
+
+    out << "cpu  0 0 0 0 0 0 0 0 0 0\n";
+
+    for (uint32 i = 0; i < CPU_COUNT; ++i)          // user nice system idle iowait irq softirq steal
+        out << "cpu" << i << ' ' << busy[i] << " 0 0 " << ticks - busy[i] << " 0 0 0 0 0 0\n";
+
+    out << "intr 0\nctxt 0\n";
+}
+
+void PrintSamples(const task::CpuLoadMonitor &monitor)
+{
+    cout << "  CPU   cur MHz   max MHz   freq    load" << endl;
+
+    for (const task::CpuLoadSample &s : monitor.GetSamples())
+        cout << "  " << setw(3) << s.cpu_id
+             << setw(10) << s.cur_freq
+             << setw(10) << s.max_freq
+             << setw(7) << fixed << setprecision(2) << s.freq_ratio
+             << setw(8) << (s.has_load ? s.load : 0.0) << endl;
+}
+
+void PrintWorkers(const task::TaskExecutor &executor)
+{
+    cout << "  Worker  Group       CPU   freq  foreign  avoided  executed" << endl;
+
+    for (const task::WorkerStats &ws : executor.GetWorkerStats())
+        cout << "  " << setw(6) << ws.id
+             << "  " << setw(10) << left << (ws.background ? "background" : "compute") << right
+             << setw(5) << ws.cpu_id
+             << setw(7) << fixed << setprecision(2) << ws.freq_ratio
+             << setw(9) << ws.foreign_load
+             << setw(9) << (ws.avoided ? "yes" : "no")
+             << setw(10) << ws.executed << endl;
+
+    cout << "  Capacity: compute " << executor.GetComputeCapacity()
+         << " / " << executor.GetComputeWorkerCount()
+         << ", background " << executor.GetBackgroundCapacity()
+         << " / " << executor.GetBackgroundWorkerCount()
+         << ", big/little ratio " << executor.GetCostModel().GetPerformanceRatio() << endl;
+}
+
+void RunBatch(task::TaskExecutor &executor, uint32 count)
+{
+    atomic<uint32> remaining{count};
+
+    for (uint32 i = 0; i < count; ++i)
+        executor.AddComputeTask([&remaining]() {
+            volatile double x = 0;
+
+            for (int k = 0; k < 20000; ++k)
+                x = x + k * 0.5;
+
+            remaining.fetch_sub(1, memory_order_release);
+        });
+
+    while (remaining.load(memory_order_acquire) > 0)
+        this_thread::yield();
+}
+
+/**
+ * 用假sysfs与假/proc/stat驱动调度器，不依赖运行机器，可在CI中运行
+ */
+int FakeTest()
+{
+    const fs::path root = fs::temp_directory_path() / "cpu_monitor_test";
+    const fs::path sysfs = root / "cpu";
+    const fs::path stat = root / "stat";
+
+    fs::remove_all(root);
+    CreateFakeSysfs(sysfs);
+
+    uint64 busy[CPU_COUNT] = {};
+
+    WriteFakeStat(stat, 0, busy);
+
+    task::TaskExecutor executor(sysfs.string());
+    task::CpuLoadMonitor monitor(sysfs.string(), stat.string());
+
+    executor.SetPinThreads(false);              // 假拓扑中的CPU编号不一定存在
+    executor.Start();
+    monitor.Init(executor.GetTopology());
+    monitor.Sample();
+
+    cout << "Fake topology: " << executor.GetTopology().GetBigCount() << " big, "
+         << executor.GetTopology().GetLittleCount() << " little" << endl;
+
+    //100个时钟内：大多数核心10%负载，一个大核被其它进程占用90%，一个大核80%负载时降到1.4GHz
+    for (uint32 i = 0; i < CPU_COUNT; ++i)
+        busy[i] = 10;
+
+    busy[BUSY_CPU] = 90;
+    busy[THROTTLED_CPU] = 80;
+
+    WriteFakeStat(stat, 100, busy);
+    WriteFile(sysfs / ("cpu" + to_string(THROTTLED_CPU)) / "cpufreq" / "scaling_cur_freq", to_string(BIG_FREQ / 2));
+
+    monitor.Sample();
+
+    cout << "\nSamples:" << endl;
+    PrintSamples(monitor);
+
+    executor.ApplyCpuLoad(monitor);
+    RunBatch(executor, 20000);
+
+    cout << "\nScheduler after ApplyCpuLoad:" << endl;
+    PrintWorkers(executor);
+
+    uint32 avoided = 0;
+
+    for (const task::WorkerStats &ws : executor.GetWorkerStats())
+        if (ws.avoided)
+            ++avoided;
+
+    const uint32 big_count = executor.GetTopology().GetBigCount();
+
+    executor.Stop();
+    fs::remove_all(root);
+
+    //假拓扑按频率应分出一半大核
+    const bool topology_ok = (big_count == CPU_COUNT / 2);
+
+    //两个大核应被回避
+    const bool avoid_ok = (avoided == 2);
+
+    cout << "\nBig cores: " << big_count << " / " << CPU_COUNT / 2 << ": " << (topology_ok ? "OK" : "FAILED") << endl;
+    cout << "Avoided workers: " << avoided << " / 2: " << (avoid_ok ? "OK" : "FAILED") << endl;
+
+    return (topology_ok && avoid_ok) ? 0 : 1;
+}
+
+/**
+ * 直接注入采样，不依赖大小核识别：回避一个计算线程所在的CPU，检查任务是否转移到其它线程
+ */
+int InjectTest()
+{
+    const fs::path root = fs::temp_directory_path() / "cpu_monitor_inject";
+    const fs::path sysfs = root / "cpu";
+
+    fs::remove_all(root);
+    CreateFakeSysfs(sysfs);
+
+    task::TaskExecutor executor(sysfs.string());
+    task::CpuLoadMonitor monitor(sysfs.string(), (root / "missing_stat").string());
+
+    executor.SetPinThreads(false);
+    executor.Start(4, 0);
+    monitor.Init(executor.GetTopology());
+
+    const vector<task::WorkerStats> workers = executor.GetWorkerStats();
+    const uint32 avoided_cpu = workers[0].cpu_id;
+
+    for (const task::WorkerStats &ws : workers) {
+        task::CpuLoadSample s;
+
+        s.cpu_id = ws.cpu_id;
+        s.load = (ws.cpu_id == avoided_cpu) ? 0.95 : 0.1;       // 其它进程占满该核心
+        s.has_load = true;
+
+        monitor.SetSample(s);
+    }
+
+    executor.ApplyCpuLoad(monitor);
+    executor.ResetStats();
+    RunBatch(executor, 20000);
+
+    cout << "\nInjected load on cpu " << avoided_cpu << ":" << endl;
+    PrintWorkers(executor);
+
+    uint64 avoided_executed = 0;
+    uint64 healthy_executed = 0;
+    uint32 healthy_count = 0;
+    bool flagged = false;
+
+    for (const task::WorkerStats &ws : executor.GetWorkerStats()) {
+        if (ws.cpu_id == avoided_cpu) {
+            avoided_executed += ws.executed;
+            flagged = flagged || ws.avoided;
+        }
+        else {
+            healthy_executed += ws.executed;
+            ++healthy_count;
+        }
+    }
+
+    executor.Stop();
+    fs::remove_all(root);
+
+    //被回避的线程执行的任务应明显少于健康线程的平均数
+    const bool ok = flagged && healthy_count > 0 && avoided_executed * 2 * healthy_count < healthy_executed;
+
+    cout << "\n" << (ok ? "OK" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
+
+/**
+ * 采样真实的sysfs与/proc/stat，后台监控线程每100ms更新一次调度器
+ */
+int LiveTest()
+{
+    task::TaskExecutor executor;
+    task::CpuLoadMonitor monitor;
+
+    executor.Start();
+    executor.StartCpuMonitor(0.1);
+
+    monitor.Init(executor.GetTopology());
+    monitor.Sample();
+
+    const double st = GetPreciseTime();
+
+    while (GetPreciseTime() - st < 1.0)
+        RunBatch(executor, 1000);
+
+    monitor.Sample();
+
+    cout << "Samples (last second):" << endl;
+    PrintSamples(monitor);
+
+    cout << "\nScheduler:" << endl;
+    PrintWorkers(executor);
+
+    executor.Stop();
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    cout << "=== CPU frequency / load monitor ===" << endl << endl;
+
+    if (argc > 1 && strcmp(argv[1], "--live") == 0)
+        return LiveTest();
+
+    const int fake = FakeTest();
+    const int inject = InjectTest();
+
+    return fake ? fake : inject;
+}
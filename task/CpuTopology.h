@@ -0,0 +1,297 @@
+#pragma once
+
+#include"ThreadAffinity.h"
+#include<hgl/platform/BigLittleDetector.h>
+#include<algorithm>
+#include<fstream>
+#include<string>
+#include<vector>
+
+namespace hgl::task
+{
+    /**
+     * CN: 逻辑CPU的拓扑信息
+     * EN: Topology of one logical CPU
+     */
+    struct LogicalCpu
+    {
+        uint32 cpu_id;          ///< CN: 系统逻辑CPU编号 / EN: OS logical CPU number
+        uint32 core_id;         ///< CN: 物理核编号 / EN: Physical core ID
+        uint32 cluster_id;      ///< CN: 簇编号 / EN: Cluster ID
+        uint32 l3_domain;       ///< CN: 共享同一L3的第一个CPU编号 / EN: First CPU sharing the same L3
+        uint32 max_freq;        ///< CN: 最大频率(MHz)，未知为0 / EN: Max frequency (MHz), 0 if unknown
+        bool   is_big;          ///< CN: 是否为大核 / EN: Whether this is a big core
+        uint32 domain;          ///< CN: 所属调度域(簇或L3域)序号 / EN: Index of scheduling domain (cluster or L3 domain)
+    };
+
+    /**
+     * CN: 调度域：同一L3且同一大小核类型的CPU集合，每个调度域对应一个运行队列
+     * EN: Scheduling domain: CPUs sharing one L3 and core type, each domain gets one run queue
+     */
+    struct CpuDomain
+    {
+        uint32 l3_domain;
+        bool   is_big;
+        std::vector<uint32> cpu_list;   ///< CN: 逻辑CPU编号列表 / EN: Logical CPU numbers
+    };
+
+    /**
+     * CN: CPU拓扑
+     * EN: CPU topology
+     *
+     * CN: Linux下从sysfs读取每个逻辑CPU的簇、L3共享关系与最大频率，
+     *     大小核划分以GetCpuInfo/BigLittleDetector给出的数量为准。
+     *     其它平台或sysfs不可用时退化为单一调度域。
+     * EN: On Linux reads cluster, L3 sharing and max frequency of each logical CPU from sysfs,
+     *     the big/little split follows the counts from GetCpuInfo/BigLittleDetector.
+     *     Falls back to a single domain on other platforms or when sysfs is unavailable.
+     */
+    class CpuTopology
+    {
+        std::vector<LogicalCpu> cpus;
+        std::vector<CpuDomain> domains;
+
+    public:
+
+        static bool ReadUInt(const std::string &filename, uint32 &value)
+        {
+            std::ifstream fs(filename);
+
+            if (!fs)
+                return false;
+
+            unsigned long v;
+
+            if (!(fs >> v))
+                return false;
+
+            value = static_cast<uint32>(v);
+            return true;
+        }
+
+        /**
+         * CN: 解析"0-3,8,10-11"格式的CPU列表
+         * EN: Parse a CPU list such as "0-3,8,10-11"
+         */
+        static bool ParseCpuList(const std::string &str, std::vector<uint32> &result)
+        {
+            size_t pos = 0;
+
+            while (pos < str.size())
+            {
+                size_t comma = str.find(',', pos);
+                if (comma == std::string::npos)
+                    comma = str.size();
+
+                const std::string part = str.substr(pos, comma - pos);
+                const size_t dash = part.find('-');
+
+                try
+                {
+                    if (dash == std::string::npos)
+                    {
+                        result.push_back(static_cast<uint32>(std::stoul(part)));
+                    }
+                    else
+                    {
+                        const uint32 first = static_cast<uint32>(std::stoul(part.substr(0, dash)));
+                        const uint32 last = static_cast<uint32>(std::stoul(part.substr(dash + 1)));
+
+                        for (uint32 i = first; i <= last; ++i)
+                            result.push_back(i);
+                    }
+                }
+                catch (...)
+                {
+                    return false;
+                }
+
+                pos = comma + 1;
+            }
+
+            return !result.empty();
+        }
+
+        static bool ReadCpuList(const std::string &filename, std::vector<uint32> &result)
+        {
+            std::ifstream fs(filename);
+
+            if (!fs)
+                return false;
+
+            std::string line;
+            std::getline(fs, line);
+
+            return ParseCpuList(line, result);
+        }
+
+    public:
+
+        /**
+         * CN: 加载拓扑
+         * EN: Load topology
+         * @param ci CN: CPU信息 / EN: CPU information
+         * @param sysfs_root CN: sysfs中cpu目录，可替换为测试用的假目录 / EN: sysfs cpu directory, can point to a fake tree for tests
+         */
+        bool Load(const CpuInfo &ci, const std::string &sysfs_root = "/sys/devices/system/cpu")
+        {
+            cpus.clear();
+            domains.clear();
+
+            std::vector<uint32> online;
+
+            if (!ReadCpuList(sysfs_root + "/online", online))
+            {
+                for (uint32 i = 0; i < ci.logical_core_count; ++i)
+                    online.push_back(i);
+            }
+
+            for (uint32 id : online)
+            {
+                const std::string path = sysfs_root + "/cpu" + std::to_string(id);
+
+                LogicalCpu lc;
+
+                lc.cpu_id = id;
+                lc.is_big = true;
+                lc.domain = 0;
+
+                if (!ReadUInt(path + "/topology/core_id", lc.core_id))
+                    lc.core_id = id;
+
+                if (!ReadUInt(path + "/topology/cluster_id", lc.cluster_id)
+                 && !ReadUInt(path + "/topology/physical_package_id", lc.cluster_id))
+                    lc.cluster_id = 0;
+
+                std::vector<uint32> l3_share;
+
+                if (ReadCpuList(path + "/cache/index3/shared_cpu_list", l3_share))
+                    lc.l3_domain = *std::min_element(l3_share.begin(), l3_share.end());
+                else
+                    lc.l3_domain = 0;
+
+                if (ReadUInt(path + "/cpufreq/cpuinfo_max_freq", lc.max_freq))
+                    lc.max_freq /= 1000;        // kHz -> MHz
+                else
+                    lc.max_freq = 0;
+
+                cpus.push_back(lc);
+            }
+
+            // 容器中sysfs缺失且CpuInfo报告0个逻辑核时列表为空
+            if (cpus.empty())
+                return false;
+
+            ClassifyBigLittle(ci);
+            BuildDomains();
+
+            return true;
+        }
+
+        const std::vector<LogicalCpu> &GetCpus() const { return cpus; }
+        const std::vector<CpuDomain> &GetDomains() const { return domains; }
+
+        uint32 GetCpuCount() const { return static_cast<uint32>(cpus.size()); }
+
+        const LogicalCpu *GetCpu(uint32 cpu_id) const
+        {
+            for (const LogicalCpu &lc : cpus)
+                if (lc.cpu_id == cpu_id)
+                    return &lc;
+
+            return nullptr;
+        }
+
+        uint32 GetBigCount() const
+        {
+            return static_cast<uint32>(std::count_if(cpus.begin(), cpus.end(), [](const LogicalCpu &lc) { return lc.is_big; }));
+        }
+
+        uint32 GetLittleCount() const
+        {
+            return GetCpuCount() - GetBigCount();
+        }
+
+        /**
+         * CN: 按调度域顺序列出大核或小核，同一域的CPU相邻
+         * EN: List big or little CPUs in domain order, CPUs of one domain are adjacent
+         */
+        std::vector<uint32> GetCpuList(bool big) const
+        {
+            std::vector<uint32> result;
+
+            for (const CpuDomain &d : domains)
+                if (d.is_big == big)
+                    result.insert(result.end(), d.cpu_list.begin(), d.cpu_list.end());
+
+            return result;
+        }
+
+        /**
+         * CN: 按调度域顺序列出所有CPU（大核域在前）
+         * EN: List all CPUs in domain order (big domains first)
+         */
+        std::vector<uint32> GetCpuList() const
+        {
+            std::vector<uint32> result = GetCpuList(true);
+            const std::vector<uint32> little = GetCpuList(false);
+
+            result.insert(result.end(), little.begin(), little.end());
+            return result;
+        }
+
+    private:
+
+        void ClassifyBigLittle(const CpuInfo &ci)
+        {
+            const BigLittleDetector::DetectionResult result = BigLittleDetector::Detect(ci);
+
+            std::vector<LogicalCpu *> by_freq;
+
+            for (LogicalCpu &lc : cpus)
+                by_freq.push_back(&lc);
+
+            std::stable_sort(by_freq.begin(), by_freq.end(), [](const LogicalCpu *a, const LogicalCpu *b) { return a->max_freq > b->max_freq; });
+
+            if (result.has_big_little && result.big_cores > 0 && result.big_cores < cpus.size())
+            {
+                // 以检测器给出的大核数量为准，频率最高的若干个为大核。
+                // 没有频率信息时，Linux/Android上小核通常编号在前，所以取编号最大的若干个。
+                const bool has_freq = by_freq.front()->max_freq > 0;
+
+                if (!has_freq)
+                    std::reverse(by_freq.begin(), by_freq.end());
+
+                for (size_t i = 0; i < by_freq.size(); ++i)
+                    by_freq[i]->is_big = (i < result.big_cores);
+
+                return;
+            }
+
+            // 检测器未报告大小核（例如x86混合架构），再看sysfs中的频率是否明显分为两档
+            const uint32 top = by_freq.front()->max_freq;
+
+            for (LogicalCpu &lc : cpus)
+                lc.is_big = (top == 0 || lc.max_freq * 5 >= top * 4);
+        }
+
+        void BuildDomains()
+        {
+            for (LogicalCpu &lc : cpus)
+            {
+                uint32 index = 0;
+
+                while (index < domains.size()
+                    && (domains[index].l3_domain != lc.l3_domain || domains[index].is_big != lc.is_big))
+                    ++index;
+
+                if (index == domains.size())
+                    domains.push_back(CpuDomain{lc.l3_domain, lc.is_big, {}});
+
+                domains[index].cpu_list.push_back(lc.cpu_id);
+                lc.domain = index;
+            }
+        }
+    };
+
+} // namespace hgl::task
@@ -0,0 +1,142 @@
+#pragma once
+
+#include<cstddef>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+namespace hgl::task
+{
+    /**
+     * CN: 内联存储的任务可调用对象
+     * EN: Task callable with inline storage
+     *
+     * CN: 只可移动，不可复制。捕获不超过INLINE_SIZE字节且可无异常移动的可调用对象直接存放在对象内部，
+     *     不进行堆分配；更大的可调用对象才退回到堆上。
+     * EN: Move-only. Callables whose captures fit in INLINE_SIZE bytes and are nothrow movable are
+     *     stored inside the object without any heap allocation; only larger ones fall back to the heap.
+     */
+    class InlineTask
+    {
+    public:
+
+        static constexpr const size_t INLINE_SIZE = 64;
+
+        template<typename F>
+        static constexpr bool FitsInline = sizeof(F) <= INLINE_SIZE
+                                        && alignof(F) <= alignof(std::max_align_t)
+                                        && std::is_nothrow_move_constructible_v<F>;
+
+    private:
+
+        struct Ops
+        {
+            void (*invoke)(void *);
+            void (*move)(void *dst, void *src);             ///< CN: 移动到dst并析构src / EN: Move into dst and destroy src
+            void (*destroy)(void *);
+            bool is_inline;
+        };
+
+        template<typename F>
+        struct InlineOps
+        {
+            static void Invoke(void *p) { (*static_cast<F *>(p))(); }
+
+            static void Move(void *dst, void *src)
+            {
+                new (dst) F(std::move(*static_cast<F *>(src)));
+                static_cast<F *>(src)->~F();
+            }
+
+            static void Destroy(void *p) { static_cast<F *>(p)->~F(); }
+
+            static constexpr Ops table = {&Invoke, &Move, &Destroy, true};
+        };
+
+        template<typename F>
+        struct HeapOps
+        {
+            static void Invoke(void *p) { (**static_cast<F **>(p))(); }
+            static void Move(void *dst, void *src) { *static_cast<F **>(dst) = *static_cast<F **>(src); }
+            static void Destroy(void *p) { delete *static_cast<F **>(p); }
+
+            static constexpr Ops table = {&Invoke, &Move, &Destroy, false};
+        };
+
+        alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+        const Ops *ops = nullptr;
+
+        void Reset()
+        {
+            if (ops)
+            {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+    public:
+
+        InlineTask() = default;
+        InlineTask(std::nullptr_t) {}
+
+        template<typename F, typename D = std::decay_t<F>,
+                 typename = std::enable_if_t<!std::is_same_v<D, InlineTask> && std::is_invocable_v<D &>>>
+        InlineTask(F &&func)
+        {
+            if constexpr (FitsInline<D>)
+            {
+                new (storage) D(std::forward<F>(func));
+                ops = &InlineOps<D>::table;
+            }
+            else
+            {
+                *reinterpret_cast<D **>(storage) = new D(std::forward<F>(func));
+                ops = &HeapOps<D>::table;
+            }
+        }
+
+        InlineTask(InlineTask &&other) noexcept
+        {
+            if (other.ops)
+            {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+
+        InlineTask &operator=(InlineTask &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+
+                if (other.ops)
+                {
+                    other.ops->move(storage, other.storage);
+                    ops = other.ops;
+                    other.ops = nullptr;
+                }
+            }
+
+            return *this;
+        }
+
+        InlineTask(const InlineTask &) = delete;
+        InlineTask &operator=(const InlineTask &) = delete;
+
+        ~InlineTask() { Reset(); }
+
+        explicit operator bool() const { return ops != nullptr; }
+
+        /**
+         * CN: 可调用对象是否存放在内部（未使用堆）
+         * EN: Whether the callable is stored inline (no heap)
+         */
+        bool IsInline() const { return !ops || ops->is_inline; }
+
+        void operator()() { ops->invoke(storage); }
+    };
+
+} // namespace hgl::task
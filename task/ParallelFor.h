@@ -0,0 +1,286 @@
+#pragma once
+
+#include"TaskExecutor.h"
+#include<atomic>
+#include<thread>
+#include<vector>
+
+namespace hgl::task
+{
+    /**
+     * CN: 半开区间[begin,end)
+     * EN: Half-open index range [begin,end)
+     */
+    struct IndexRange
+    {
+        size_t begin = 0;
+        size_t end = 0;
+
+        IndexRange() = default;
+        IndexRange(size_t b, size_t e) : begin(b), end(e) {}
+
+        size_t size() const { return end > begin ? end - begin : 0; }
+        bool empty() const { return end <= begin; }
+    };
+
+    /**
+     * CN: 并行划分模式
+     * EN: Parallel partition mode
+     */
+    enum class ParallelMode
+    {
+        Adaptive,               ///< CN: 按需二分，被窃取的区间继续细分 / EN: Lazy binary splitting, stolen ranges split further
+        Deterministic           ///< CN: 按grain固定分块，归约顺序与线程数无关 / EN: Fixed grain-sized chunks, reduction order does not depend on thread count
+    };
+
+    namespace parallel_detail
+    {
+        constexpr const size_t DETERMINISTIC_CHUNKS = 256;     ///< CN: 确定性模式下grain为0时的默认分块数 / EN: Default chunk count in deterministic mode when grain is 0
+
+        inline uint32 Log2Ceil(uint32 n)
+        {
+            uint32 r = 0;
+
+            while ((1u << r) < n)
+                ++r;
+
+            return r;
+        }
+
+        /**
+         * CN: 参与计算的线程数，计算线程之外再加上调用者线程
+         * EN: Threads taking part, compute workers plus the calling thread
+         */
+        inline uint32 GetConcurrency(const TaskExecutor &te)
+        {
+            return te.GetComputeWorkerCount() + (TaskExecutor::GetCurrentWorkerID() < 0 ? 1 : 0);
+        }
+
+        /**
+         * CN: 等待计数归零，工作线程在等待期间帮助执行其它任务
+         * EN: Wait for a counter to reach zero, workers help running other tasks meanwhile
+         */
+        inline void WaitForZero(TaskExecutor &te, const std::atomic<uint32> &pending)
+        {
+            while (pending.load(std::memory_order_acquire) != 0)
+            {
+                if (!te.RunPendingTask())
+                    std::this_thread::yield();
+            }
+        }
+
+        /**
+         * CN: 自适应划分的共享状态
+         * EN: Shared state of an adaptive partition
+         */
+        template<typename F>
+        struct AdaptiveContext
+        {
+            TaskExecutor *executor;
+            const F *func;
+            size_t grain;
+            uint32 steal_depth;                             ///< CN: 被窃取后重新获得的拆分次数 / EN: Split budget granted to a stolen range
+
+            std::atomic<uint32> pending{1};
+
+            void Run(IndexRange range, uint32 depth, int32 owner)
+            {
+                const int32 self = TaskExecutor::GetCurrentWorkerID();
+
+                // 被其它线程窃取，说明有空闲线程，允许继续细分。
+                // 调用者不是工作线程时(owner<0)，第一层子任务总会在工作线程上执行，不算窃取，与工作线程调用时拆分次数一致
+                if (owner >= 0 && self != owner && depth < steal_depth)
+                    depth = steal_depth;
+
+                while (depth > 0 && range.size() > grain)
+                {
+                    const size_t mid = range.begin + range.size() / 2;
+                    const IndexRange right(mid, range.end);
+
+                    range.end = mid;
+                    --depth;
+
+                    pending.fetch_add(1, std::memory_order_relaxed);
+                    executor->AddComputeTask([this, right, depth, self]() { Run(right, depth, self); });
+                }
+
+                (*func)(range);
+
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        template<typename F>
+        void RunAdaptive(TaskExecutor &te, const IndexRange &range, size_t grain, const F &func)
+        {
+            const uint32 threads = GetConcurrency(te);
+
+            AdaptiveContext<F> ctx;
+
+            ctx.executor = &te;
+            ctx.func = &func;
+            ctx.grain = grain > 0 ? grain : 1;
+            ctx.steal_depth = Log2Ceil(threads);
+
+            // 初始约拆成4倍线程数的块，其余由窃取驱动
+            ctx.Run(range, ctx.steal_depth + 2, TaskExecutor::GetCurrentWorkerID());
+
+            WaitForZero(te, ctx.pending);
+        }
+
+        /**
+         * CN: 固定分块，chunk_func(chunk_index,range)；块由各线程按序领取
+         * EN: Fixed chunks, chunk_func(chunk_index,range); chunks are claimed in order by each thread
+         */
+        template<typename F>
+        void RunChunks(TaskExecutor &te, const IndexRange &range, size_t grain, size_t chunk_count, const F &chunk_func)
+        {
+            std::atomic<size_t> next{0};
+            std::atomic<uint32> pending{0};
+
+            auto claim = [&]()
+            {
+                size_t index;
+
+                while ((index = next.fetch_add(1, std::memory_order_relaxed)) < chunk_count)
+                {
+                    const size_t b = range.begin + index * grain;
+                    const size_t e = (b + grain < range.end) ? b + grain : range.end;
+
+                    chunk_func(index, IndexRange(b, e));
+                }
+            };
+
+            const uint32 threads = GetConcurrency(te);
+            const size_t helpers = (chunk_count < threads ? chunk_count : threads) - 1;
+
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                pending.fetch_add(1, std::memory_order_relaxed);
+                te.AddComputeTask([&]()
+                {
+                    claim();
+                    pending.fetch_sub(1, std::memory_order_acq_rel);
+                });
+            }
+
+            claim();
+
+            WaitForZero(te, pending);
+        }
+
+        inline size_t DeterministicGrain(const IndexRange &range, size_t grain)
+        {
+            if (grain > 0)
+                return grain;
+
+            const size_t g = range.size() / DETERMINISTIC_CHUNKS;
+            return g > 0 ? g : 1;
+        }
+
+        /**
+         * CN: 自适应归约的块大小：约每个线程4块，不小于grain
+         * EN: Chunk size of an adaptive reduction: about 4 chunks per thread, never below grain
+         */
+        inline size_t AdaptiveReduceGrain(const TaskExecutor &te, const IndexRange &range, size_t grain)
+        {
+            const size_t chunks = size_t(GetConcurrency(te)) * 4;
+            const size_t g = (range.size() + chunks - 1) / chunks;
+
+            if (g > grain)
+                return g;
+
+            return grain > 0 ? grain : 1;
+        }
+    }//namespace parallel_detail
+
+    /**
+     * CN: 并行执行func(sub_range)，覆盖整个range
+     * EN: Run func(sub_range) in parallel over the whole range
+     *
+     * CN: 自适应模式下先按计算线程数拆出少量块，被其它线程窃取的块继续二分，直到不大于grain；
+     *     确定性模式下固定按grain分块。调用线程参与计算，返回时所有块均已完成。
+     * EN: Adaptive mode first splits into a few chunks per compute worker, chunks stolen by other
+     *     workers keep halving down to grain; deterministic mode uses fixed grain-sized chunks.
+     *     The calling thread takes part, all chunks are done on return.
+     *
+     * @param grain CN: 最小块大小，0为自动 / EN: Minimum chunk size, 0 chooses automatically
+     */
+    template<typename F>
+    void ParallelFor(TaskExecutor &te, const IndexRange &range, size_t grain, const F &func, ParallelMode mode = ParallelMode::Adaptive)
+    {
+        if (range.empty())
+            return;
+
+        if (!te.IsRunning() || range.size() <= grain)
+        {
+            func(range);
+            return;
+        }
+
+        if (mode == ParallelMode::Adaptive)
+        {
+            parallel_detail::RunAdaptive(te, range, grain, func);
+            return;
+        }
+
+        const size_t g = parallel_detail::DeterministicGrain(range, grain);
+
+        parallel_detail::RunChunks(te, range, g, (range.size() + g - 1) / g,
+                                   [&func](size_t, const IndexRange &r) { func(r); });
+    }
+
+    /**
+     * CN: 并行归约
+     * EN: Parallel reduction
+     *
+     * CN: body(sub_range,init)返回在init基础上累加sub_range后的结果，join(a,b)合并两个部分结果。
+     *     每个块一个部分结果，按块序号存放，与执行线程无关，所以可以嵌套调用，也可以在其它执行器的线程中调用；
+     *     最后按块序合并，join需满足结合律。
+     *     自适应模式下约每个线程4块，由各线程动态领取，块数随线程数变化；
+     *     确定性模式下固定按grain分块，浮点结果在不同线程数下保持一致。
+     * EN: body(sub_range,init) returns init accumulated with sub_range, join(a,b) combines two partial results.
+     *     Every chunk keeps its own partial result indexed by chunk, independent of the thread running it, so the
+     *     call may nest or come from another executor's thread; partials are combined in chunk order, join must be associative.
+     *     Adaptive mode uses about 4 chunks per thread claimed dynamically, so the chunk count follows the thread count;
+     *     deterministic mode uses fixed grain-sized chunks, so floating point results match for any thread count.
+     */
+    template<typename T, typename Body, typename Join>
+    T ParallelReduce(TaskExecutor &te, const IndexRange &range, size_t grain, const T &identity,
+                     const Body &body, const Join &join, ParallelMode mode = ParallelMode::Adaptive)
+    {
+        if (range.empty())
+            return identity;
+
+        if (mode == ParallelMode::Adaptive && (!te.IsRunning() || range.size() <= grain))
+            return body(range, identity);
+
+        const size_t g = (mode == ParallelMode::Deterministic) ? parallel_detail::DeterministicGrain(range, grain)
+                                                               : parallel_detail::AdaptiveReduceGrain(te, range, grain);
+        const size_t chunk_count = (range.size() + g - 1) / g;
+
+        std::vector<T> partial(chunk_count, identity);
+
+        if (te.IsRunning() && chunk_count > 1)
+        {
+            parallel_detail::RunChunks(te, range, g, chunk_count,
+                                       [&](size_t index, const IndexRange &r) { partial[index] = body(r, identity); });
+        }
+        else
+        {
+            for (size_t i = 0; i < chunk_count; ++i)
+            {
+                const size_t b = range.begin + i * g;
+                partial[i] = body(IndexRange(b, (b + g < range.end) ? b + g : range.end), identity);
+            }
+        }
+
+        T result = identity;
+
+        for (const T &p : partial)
+            result = join(result, p);
+
+        return result;
+    }
+
+} // namespace hgl::task
@@ -0,0 +1,202 @@
+#include "TaskExecutor.h"
+#include <hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+using namespace hgl;
+using namespace std;
+
+constexpr const uint32 FRAME_COUNT      = 60;       // 模拟的帧数
+constexpr const uint32 FRAME_TASKS      = 16;       // 每帧的关键任务数
+constexpr const double FRAME_TASK_TIME  = 0.0002;   // 每个帧任务耗时(秒)
+constexpr const double FRAME_BUDGET     = 0.008;    // 帧任务截止时间(秒)
+constexpr const double FRAME_INTERVAL   = 0.016;    // 帧间隔(秒)
+
+constexpr const uint32 BULK_TASKS       = 4000;     // 批量后台任务数
+constexpr const double BULK_TASK_TIME   = 0.0005;   // 每个后台任务耗时(秒)
+
+constexpr const uint32 AGED_TASKS_PER_WORKER = 400; // 老化测试中每个工作线程的低优先级积压任务数(约0.2秒)
+constexpr const double AGED_WAIT        = 0.1;      // 老化测试中投递后等待的时间，超过默认老化时间0.05秒
+constexpr const uint32 URGENT_TASKS     = 16;       // 老化测试中积压老化后投递的高优先级与普通任务数(各)
+
+void Spin(double seconds)
+{
+    const double end = GetPreciseTime() + seconds;
+
+    while (GetPreciseTime() < end);
+}
+
+struct LaneResult
+{
+    vector<double> frame_latency;                   // 每帧从投递到全部完成的时间
+    uint32 late_frames = 0;
+    uint32 bulk_during_frames = 0;                  // 帧循环期间完成的后台任务数
+    double bulk_total_time = 0;                     // 所有后台任务完成的时间
+    uint64 deadline_misses = 0;                     // 执行器统计的超时任务数
+    double max_lateness_ms = 0;
+};
+
+/**
+ * @param priorities true时帧任务走EDF通道、后台任务走低优先级通道，false时全部作为普通任务
+ */
+LaneResult RunFrames(bool priorities)
+{
+    task::TaskExecutor executor;
+    LaneResult result;
+
+    executor.Start();
+
+    atomic<uint32> bulk_done{0};
+
+    const double st = GetPreciseTime();
+
+    for (uint32 i = 0; i < BULK_TASKS; ++i) {
+        auto job = [&bulk_done]() {
+            Spin(BULK_TASK_TIME);
+            bulk_done.fetch_add(1, memory_order_relaxed);
+        };
+
+        if (priorities)
+            executor.AddComputeTask(job, task::TaskPriority::Low);
+        else
+            executor.AddComputeTask(job);
+    }
+
+    for (uint32 f = 0; f < FRAME_COUNT; ++f) {
+        const double frame_start = GetPreciseTime();
+        const double deadline = frame_start + FRAME_BUDGET;
+
+        atomic<uint32> remaining{FRAME_TASKS};
+
+        for (uint32 i = 0; i < FRAME_TASKS; ++i) {
+            auto job = [&remaining]() {
+                Spin(FRAME_TASK_TIME);
+                remaining.fetch_sub(1, memory_order_release);
+            };
+
+            if (priorities)
+                executor.AddDeadlineTask(job, deadline);
+            else
+                executor.AddComputeTask(job);
+        }
+
+        while (remaining.load(memory_order_acquire) > 0)
+            this_thread::yield();
+
+        const double done = GetPreciseTime();
+
+        result.frame_latency.push_back(done - frame_start);
+
+        if (done > deadline)
+            ++result.late_frames;
+
+        while (GetPreciseTime() < frame_start + FRAME_INTERVAL)
+            this_thread::yield();
+    }
+
+    result.bulk_during_frames = bulk_done.load(memory_order_relaxed);
+
+    while (bulk_done.load(memory_order_relaxed) < BULK_TASKS)
+        this_thread::yield();
+
+    result.bulk_total_time = GetPreciseTime() - st;
+    result.deadline_misses = executor.GetDeadlineMissCount();
+
+    for (const task::WorkerStats &ws : executor.GetWorkerStats())
+        result.max_lateness_ms = max(result.max_lateness_ms, ws.max_lateness_ms);
+
+    executor.Stop();
+    return result;
+}
+
+/**
+ * 一批同时投递的低优先级任务会同时老化，检查之后投递的高优先级与普通任务不必等整批积压执行完
+ */
+bool AgingTest()
+{
+    task::TaskExecutor executor;
+
+    executor.Start();
+
+    const uint32 bulk_tasks = AGED_TASKS_PER_WORKER * executor.GetComputeWorkerCount();
+
+    atomic<uint32> bulk_done{0};
+
+    for (uint32 i = 0; i < bulk_tasks; ++i)
+        executor.AddComputeTask([&bulk_done]() {
+            Spin(BULK_TASK_TIME);
+            bulk_done.fetch_add(1, memory_order_relaxed);
+        }, task::TaskPriority::Low);
+
+    const double st = GetPreciseTime();
+
+    while (GetPreciseTime() < st + AGED_WAIT)
+        this_thread::yield();
+
+    atomic<uint32> remaining{URGENT_TASKS * 2};
+
+    for (uint32 i = 0; i < URGENT_TASKS; ++i) {
+        auto job = [&remaining]() {
+            Spin(FRAME_TASK_TIME);
+            remaining.fetch_sub(1, memory_order_release);
+        };
+
+        executor.AddComputeTask(job, task::TaskPriority::High);
+        executor.AddComputeTask(job);
+    }
+
+    while (remaining.load(memory_order_acquire) > 0)
+        this_thread::yield();
+
+    const uint32 bulk_at_urgent = bulk_done.load(memory_order_relaxed);
+
+    while (bulk_done.load(memory_order_relaxed) < bulk_tasks)
+        this_thread::yield();
+
+    executor.Stop();
+
+    const bool ok = bulk_at_urgent < bulk_tasks;
+
+    cout << "Aged low backlog: " << bulk_at_urgent << " / " << bulk_tasks
+         << " done when high/normal tasks finished: " << (ok ? "OK" : "FAILED") << endl;
+
+    return ok;
+}
+
+void PrintResult(const char *name, LaneResult &r)
+{
+    sort(r.frame_latency.begin(), r.frame_latency.end());
+
+    const size_t n = r.frame_latency.size();
+
+    cout << setw(12) << left << name << right << fixed << setprecision(2)
+         << setw(10) << r.frame_latency[n / 2] * 1000
+         << setw(10) << r.frame_latency[n * 99 / 100] * 1000
+         << setw(10) << r.frame_latency[n - 1] * 1000
+         << setw(8) << r.late_frames << "/" << FRAME_COUNT
+         << setw(10) << r.deadline_misses
+         << setw(12) << r.max_lateness_ms
+         << setw(10) << r.bulk_during_frames
+         << setw(10) << r.bulk_total_time << endl;
+}
+
+int main(int, char **)
+{
+    cout << "=== Priority lanes vs single FIFO ===" << endl;
+    cout << FRAME_COUNT << " frames of " << FRAME_TASKS << " tasks (deadline " << FRAME_BUDGET * 1000 << " ms), "
+         << BULK_TASKS << " bulk tasks queued up front" << endl << endl;
+
+    LaneResult fifo = RunFrames(false);
+    LaneResult lanes = RunFrames(true);
+
+    cout << "Mode          p50 ms    p99 ms    max ms   late     misses  lateness ms  bulk@end  bulk sec" << endl;
+
+    PrintResult("FIFO", fifo);
+    PrintResult("EDF + Low", lanes);
+
+    cout << endl;
+
+    return AgingTest() ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#include "TaskExecutor.h"
+#include <hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace hgl;
+using namespace std;
+
+/**
+ * 统计全局operator new的调用次数
+ */
+static atomic<uint64> alloc_count{0};
+
+void *operator new(size_t size)
+{
+    alloc_count.fetch_add(1, memory_order_relaxed);
+
+    if (void *p = malloc(size ? size : 1))
+        return p;
+
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// 数组形式也必须一并替换，否则new[]/delete[]会与上面的malloc/free配对不一致
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+constexpr const uint32 FRAME_COUNT     = 8;        // 模拟帧数
+constexpr const uint32 TASKS_PER_FRAME = 50000;    // 每帧任务数
+
+/**
+ * 48字节捕获，超过std::function的内部缓冲，但在InlineTask的内联容量以内
+ */
+struct Payload
+{
+    atomic<uint32> *done;
+    uint64 a, b, c, d, e;
+};
+
+void PrintFrame(const char *name, uint32 frame, uint64 allocs, double seconds)
+{
+    cout << "  " << setw(24) << left << name << right
+         << " frame " << frame
+         << "  allocs " << setw(8) << allocs
+         << "  allocs/task " << setw(6) << fixed << setprecision(2) << double(allocs) / TASKS_PER_FRAME
+         << "  " << setw(8) << setprecision(1) << seconds * 1e9 / TASKS_PER_FRAME << " ns/task" << endl;
+}
+
+/**
+ * 原TaskScheduler的方式：std::function放入vector，取出后执行
+ */
+void RunLegacy()
+{
+    atomic<uint32> done{0};
+
+    for (uint32 f = 0; f < FRAME_COUNT; ++f) {
+        const uint64 before = alloc_count.load();
+        const double st = GetPreciseTime();
+
+        vector<function<void()>> tasks;
+
+        for (uint32 i = 0; i < TASKS_PER_FRAME; ++i) {
+            Payload p{&done, i, i, i, i, i};
+
+            tasks.push_back([p]() { p.done->fetch_add(uint32(p.a & 1), memory_order_relaxed); });
+        }
+
+        while (!tasks.empty()) {
+            function<void()> task = move(tasks.back());
+            tasks.pop_back();
+            task();
+        }
+
+        PrintFrame("std::function + vector", f, alloc_count.load() - before, GetPreciseTime() - st);
+    }
+}
+
+/**
+ * 执行器上一版的方式：每个任务new一个std::function
+ */
+void RunHeapFunction()
+{
+    atomic<uint32> done{0};
+
+    task::WorkStealingDeque<function<void()> *> queue;
+
+    for (uint32 f = 0; f < FRAME_COUNT; ++f) {
+        const uint64 before = alloc_count.load();
+        const double st = GetPreciseTime();
+
+        for (uint32 i = 0; i < TASKS_PER_FRAME; ++i) {
+            Payload p{&done, i, i, i, i, i};
+
+            queue.Push(new function<void()>([p]() { p.done->fetch_add(uint32(p.a & 1), memory_order_relaxed); }));
+        }
+
+        function<void()> *task;
+
+        while (queue.Pop(task)) {
+            (*task)();
+            delete task;
+        }
+
+        PrintFrame("new std::function", f, alloc_count.load() - before, GetPreciseTime() - st);
+    }
+}
+
+/**
+ * 当前执行器：InlineTask + TaskArena
+ * @param from_worker 为true时由工作线程投递(使用该线程的分配区)，否则由主线程投递(共用分配区)
+ */
+void RunExecutor(task::TaskExecutor &executor, bool from_worker)
+{
+    atomic<uint32> done{0};
+
+    auto spawn = [&executor, &done]() {
+        for (uint32 i = 0; i < TASKS_PER_FRAME; ++i) {
+            Payload p{&done, 1, i, i, i, i};
+
+            executor.AddComputeTask([p]() { p.done->fetch_add(uint32(p.a), memory_order_relaxed); });
+        }
+    };
+
+    for (uint32 f = 0; f < FRAME_COUNT; ++f) {
+        done = 0;
+
+        const uint64 before = alloc_count.load();
+        const double st = GetPreciseTime();
+
+        if (from_worker) {
+            done.fetch_sub(1, memory_order_relaxed);            // 投递任务本身也计数一次
+
+            executor.AddComputeTask([&spawn, &done]() {
+                spawn();
+                done.fetch_add(1, memory_order_relaxed);
+            });
+        }
+        else {
+            spawn();
+        }
+
+        while (done.load(memory_order_acquire) != TASKS_PER_FRAME)
+            this_thread::yield();
+
+        PrintFrame(from_worker ? "InlineTask (worker)" : "InlineTask (external)", f, alloc_count.load() - before, GetPreciseTime() - st);
+    }
+}
+
+int main(int, char **)
+{
+    cout << "=== Task allocation benchmark ===" << endl;
+    cout << FRAME_COUNT << " frames, " << TASKS_PER_FRAME << " tasks per frame, "
+         << sizeof(Payload) << " bytes captured per task" << endl;
+    cout << "InlineTask inline capacity: " << task::InlineTask::INLINE_SIZE << " bytes" << endl;
+
+    cout << "\n--- previous paths (single thread) ---" << endl;
+
+    RunLegacy();
+    RunHeapFunction();
+
+    cout << "\n--- TaskExecutor ---" << endl;
+
+    {
+        task::TaskExecutor executor;
+        executor.Start();
+
+        cout << "Workers: " << executor.GetComputeWorkerCount() << " compute, "
+             << executor.GetBackgroundWorkerCount() << " background" << endl;
+
+        RunExecutor(executor, false);
+        RunExecutor(executor, true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include<hgl/platform/CpuInfo.h>
+#include<atomic>
+#include<new>
+#include<utility>
+#include<vector>
+
+namespace hgl::task
+{
+    /**
+     * CN: 任务对象分配区
+     * EN: Task object arena
+     *
+     * CN: 内存按块分配，每块BLOCK_SLOTS个固定大小的槽位，块内顺序分配。只允许拥有者线程调用New，任意线程都可以Delete。
+     *     每块有自己的存活计数，Delete只析构对象并减少所在块的计数，不归还内存。
+     *     当前块用完后，拥有者优先复用存活数为0的旧块，都不可用时才申请新块；当前块存活数归0时直接回绕到块首。
+     *     所以内存占用只取决于同时存活的任务所跨的块数，个别长期存活的任务只占住它所在的一块，不会让分配区无限增长。
+     * EN: Memory is allocated in blocks of BLOCK_SLOTS fixed-size slots, allocated sequentially within a block.
+     *     Only the owner thread may call New, any thread may Delete.
+     *     Every block keeps its own live count; Delete only destroys the object and decrements its block's count
+     *     without returning memory.
+     *     Once the current block is used up, the owner reuses an old block whose live count is zero and only
+     *     requests a new block when none is free; the current block rewinds to its start when its count drops to zero.
+     *     Memory use therefore depends on how many blocks the simultaneously live tasks span: a long-lived task
+     *     pins only its own block instead of making the arena grow without bound.
+     */
+    template<typename T>
+    class TaskArena
+    {
+    public:
+
+        static constexpr const uint32 BLOCK_SLOTS = 1024;
+
+    private:
+
+        struct Block;
+
+        struct Slot
+        {
+            alignas(T) unsigned char data[sizeof(T)];   ///< CN: 必须是第一个成员，对象指针即槽位指针 / EN: Must come first, the object pointer is the slot pointer
+            Block *block;
+        };
+
+        struct Block
+        {
+            Slot slots[BLOCK_SLOTS];
+            std::atomic<uint32> live{0};                ///< CN: 本块尚未Delete的对象数 / EN: Objects in this block not yet deleted
+        };
+
+        std::vector<Block *> blocks;
+        Block *current = nullptr;                       ///< CN: 当前分配块 / EN: Current block
+        uint32 slot_index = 0;                          ///< CN: 当前块内下一个槽位 / EN: Next slot in current block
+        uint32 scan_index = 0;                          ///< CN: 下次查找空闲块的起点 / EN: Where the next search for a free block starts
+
+        uint64 rewind_count = 0;
+
+        /**
+         * CN: 从scan_index开始轮流查找存活数为0的块，没有则申请新块
+         * EN: Search round-robin from scan_index for a block with no live objects, allocate a new one if none
+         */
+        Block *AcquireBlock()
+        {
+            const uint32 count = static_cast<uint32>(blocks.size());
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Block *b = blocks[(scan_index + i) % count];
+
+                if (b != current && b->live.load(std::memory_order_acquire) == 0)
+                {
+                    scan_index = (scan_index + i + 1) % count;
+                    ++rewind_count;
+                    return b;
+                }
+            }
+
+            Block *b = new Block;
+
+            for (Slot &slot : b->slots)
+                slot.block = b;
+
+            blocks.push_back(b);
+            return b;
+        }
+
+    public:
+
+        TaskArena() = default;
+
+        ~TaskArena()
+        {
+            for (Block *b : blocks)
+                delete b;
+        }
+
+        TaskArena(const TaskArena &) = delete;
+        TaskArena &operator=(const TaskArena &) = delete;
+
+        uint32 GetLiveCount() const
+        {
+            uint32 count = 0;
+
+            for (const Block *b : blocks)
+                count += b->live.load(std::memory_order_relaxed);
+
+            return count;
+        }
+
+        uint32 GetBlockCount() const { return static_cast<uint32>(blocks.size()); }
+        uint64 GetRewindCount() const { return rewind_count; }
+
+        /**
+         * CN: 分配并构造一个对象，只能由拥有者线程调用
+         * EN: Allocate and construct an object, owner thread only
+         */
+        template<typename... ARGS>
+        T *New(ARGS &&...args)
+        {
+            if (current && slot_index > 0 && current->live.load(std::memory_order_acquire) == 0)
+            {
+                slot_index = 0;                         // 本块对象都已释放，回绕到块首
+                ++rewind_count;
+            }
+
+            if (!current || slot_index >= BLOCK_SLOTS)
+            {
+                current = AcquireBlock();
+                slot_index = 0;
+            }
+
+            void *p = current->slots[slot_index++].data;
+
+            current->live.fetch_add(1, std::memory_order_relaxed);
+            return new (p) T(std::forward<ARGS>(args)...);
+        }
+
+        /**
+         * CN: 析构对象，任意线程都可以调用
+         * EN: Destroy an object, callable from any thread
+         */
+        void Delete(T *obj)
+        {
+            Block *b = reinterpret_cast<Slot *>(obj)->block;
+
+            obj->~T();
+            b->live.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+} // namespace hgl::task
@@ -0,0 +1,198 @@
+#pragma once
+
+#include<hgl/platform/CpuInfo.h>
+#include<atomic>
+#include<mutex>
+#include<string>
+
+namespace hgl::task
+{
+    using TaskTypeID = uint32;
+    constexpr const TaskTypeID TASK_TYPE_INVALID = 0xFFFFFFFF;
+
+    /**
+     * CN: 任务放置目标
+     * EN: Task placement target
+     */
+    enum class CoreClass
+    {
+        Big,
+        Little
+    };
+
+    /**
+     * CN: 任务开销模型
+     * EN: Task cost model
+     *
+     * CN: 按任务类型记录在大核、小核上的实际耗时（指数滑动平均），
+     *     结合BigLittleDetector给出的performance_ratio预测任务在两类核心上的耗时。
+     *     没有历史数据时使用提交时给出的开销提示（以大核耗时计）。
+     *     在小核上运行超过帧预算的任务类型会被标记为迁移到大核。
+     * EN: Records measured runtime per task type on big and little cores (exponential moving average),
+     *     and predicts runtime on either core class using performance_ratio from BigLittleDetector.
+     *     Falls back to the cost hint given at submission (in big core seconds) without history.
+     *     Task types that overrun the frame budget on little cores are marked for migration to big cores.
+     */
+    class TaskCostModel
+    {
+    public:
+
+        static constexpr const uint32 MAX_TASK_TYPES = 256;
+        static constexpr const uint32 MIGRATE_STALL_COUNT = 2;     ///< CN: 连续超出帧预算多少次后迁移 / EN: Overruns in a row before migrating
+
+        struct TypeStats
+        {
+            std::string name;
+            double cost_hint = 0;                           ///< CN: 默认开销提示(秒,大核) / EN: Default cost hint (seconds, big core)
+
+            std::atomic<double> avg[2] = {0.0, 0.0};        ///< CN: 各类核心上的平均耗时(秒) / EN: Average runtime per core class (seconds)
+            std::atomic<uint32> samples[2] = {0u, 0u};      ///< CN: 各类核心上的采样数 / EN: Sample count per core class
+
+            std::atomic<uint32> stall_count{0};             ///< CN: 连续超出帧预算次数 / EN: Consecutive frame budget overruns
+            std::atomic<bool> migrated{false};              ///< CN: 已迁移到大核 / EN: Migrated to big cores
+        };
+
+    private:
+
+        TypeStats types[MAX_TASK_TYPES];
+        std::atomic<uint32> type_count{0};
+        std::mutex register_lock;
+
+        std::atomic<double> performance_ratio{1.0};         ///< CN: 大核相对小核的性能倍数，运行中可被频率监控更新 / EN: How many times faster a big core is, may be updated by the frequency monitor while running
+        double frame_budget = 0;                            ///< CN: 帧预算(秒)，0为不检查 / EN: Frame budget in seconds, 0 disables stall detection
+        double smoothing = 0.2;                             ///< CN: 滑动平均系数 / EN: Moving average factor
+
+        static int Index(CoreClass cc) { return cc == CoreClass::Big ? 0 : 1; }
+
+    public:
+
+        void SetPerformanceRatio(double ratio) { performance_ratio.store(ratio > 0 ? ratio : 1.0, std::memory_order_relaxed); }
+        double GetPerformanceRatio() const { return performance_ratio.load(std::memory_order_relaxed); }
+
+        void SetFrameBudget(double seconds) { frame_budget = seconds; }
+        double GetFrameBudget() const { return frame_budget; }
+
+        uint32 GetTypeCount() const { return type_count.load(std::memory_order_acquire); }
+
+        const TypeStats *GetType(TaskTypeID id) const
+        {
+            return id < GetTypeCount() ? &types[id] : nullptr;
+        }
+
+        /**
+         * CN: 注册任务类型，同名类型返回已有ID
+         * EN: Register a task type, returns the existing ID for a known name
+         * @param cost_hint CN: 默认开销提示(秒,大核) / EN: Default cost hint (seconds, big core)
+         */
+        TaskTypeID Register(const std::string &name, double cost_hint = 0)
+        {
+            std::lock_guard<std::mutex> lock(register_lock);
+
+            const uint32 count = type_count.load(std::memory_order_relaxed);
+
+            for (uint32 i = 0; i < count; ++i)
+                if (types[i].name == name)
+                    return i;
+
+            if (count >= MAX_TASK_TYPES)
+                return TASK_TYPE_INVALID;
+
+            types[count].name = name;
+            types[count].cost_hint = cost_hint;
+
+            type_count.store(count + 1, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * CN: 预测任务在指定核心类型上的耗时
+         * EN: Predict runtime on the given core class
+         * @param hint CN: 本次提交的开销提示，0表示使用类型默认值 / EN: Cost hint for this submission, 0 uses the type default
+         */
+        double Predict(TaskTypeID id, CoreClass cc, double hint = 0) const
+        {
+            const TypeStats *ts = GetType(id);
+
+            if (ts)
+            {
+                const int self = Index(cc);
+                const int other = 1 - self;
+
+                if (ts->samples[self].load(std::memory_order_relaxed) > 0)
+                    return ts->avg[self].load(std::memory_order_relaxed);
+
+                if (ts->samples[other].load(std::memory_order_relaxed) > 0)
+                {
+                    const double t = ts->avg[other].load(std::memory_order_relaxed);
+                    const double ratio = GetPerformanceRatio();
+                    return cc == CoreClass::Big ? t / ratio : t * ratio;
+                }
+
+                if (hint <= 0)
+                    hint = ts->cost_hint;
+            }
+
+            return cc == CoreClass::Big ? hint : hint * GetPerformanceRatio();
+        }
+
+        bool IsMigrated(TaskTypeID id) const
+        {
+            const TypeStats *ts = GetType(id);
+            return ts && ts->migrated.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * CN: 记录一次实际运行耗时
+         * EN: Record one measured runtime
+         */
+        void Record(TaskTypeID id, CoreClass cc, double seconds)
+        {
+            if (id >= GetTypeCount())
+                return;
+
+            TypeStats &ts = types[id];
+            const int i = Index(cc);
+
+            // 统计量允许并发更新时偶尔丢失一次采样
+            const uint32 n = ts.samples[i].fetch_add(1, std::memory_order_relaxed);
+            const double old_avg = ts.avg[i].load(std::memory_order_relaxed);
+
+            ts.avg[i].store(n == 0 ? seconds : old_avg + (seconds - old_avg) * smoothing, std::memory_order_relaxed);
+
+            if (cc != CoreClass::Little || frame_budget <= 0)
+                return;
+
+            if (seconds > frame_budget)
+            {
+                if (ts.stall_count.fetch_add(1, std::memory_order_relaxed) + 1 >= MIGRATE_STALL_COUNT)
+                    ts.migrated.store(true, std::memory_order_relaxed);
+            }
+            else
+            {
+                ts.stall_count.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * CN: 清除所有历史数据与迁移标记（保留已注册的类型）
+         * EN: Clear history and migration marks (registered types are kept)
+         */
+        void ClearHistory()
+        {
+            const uint32 count = GetTypeCount();
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                for (int c = 0; c < 2; ++c)
+                {
+                    types[i].avg[c] = 0;
+                    types[i].samples[c] = 0;
+                }
+
+                types[i].stall_count = 0;
+                types[i].migrated = false;
+            }
+        }
+    };
+
+} // namespace hgl::task
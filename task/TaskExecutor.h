@@ -0,0 +1,1481 @@
+#pragma once
+
+#include"WorkStealingDeque.h"
+#include"CpuTopology.h"
+#include"TaskCostModel.h"
+#include"InlineTask.h"
+#include"TaskArena.h"
+#include"TaskTrace.h"
+#include"CpuLoadMonitor.h"
+#include<hgl/time/Time.h>
+#include<hgl/platform/CpuInfo.h>
+#include<hgl/platform/BigLittleDetector.h>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<vector>
+#include<algorithm>
+#include<chrono>
+#include<stdexcept>
+
+namespace hgl::task
+{
+    using TaskFunc = InlineTask;
+
+    /**
+     * CN: 任务优先级通道
+     * EN: Task priority lane
+     */
+    enum class TaskPriority : uint8
+    {
+        High,               ///< CN: 帧关键任务，先于普通任务执行 / EN: Frame-critical work, runs before normal tasks
+        Normal,             ///< CN: 默认，走本地队列与调度域运行队列 / EN: Default, goes through local deques and domain run queues
+        Low                 ///< CN: 批量后台任务，空闲或等待超过老化时间后执行 / EN: Bulk background work, runs when idle or after waiting longer than the aging time
+    };
+
+    /**
+     * CN: 工作窃取任务执行器
+     * EN: Work-stealing task executor
+     *
+     * CN: 按BigLittleDetector的检测结果划分计算组（大核）与后台组（小核），
+     *     统一架构下只有一个组，后台任务作为低优先级任务由同组线程处理。
+     *     每个工作线程绑定到一个逻辑CPU并拥有一个Chase-Lev双端队列，
+     *     外部投递的任务进入工作线程所在调度域（簇或L3域）的运行队列。
+     *     空闲线程先取本域运行队列、再窃取本域其它线程，最后才跨域，
+     *     仍然没有任务时挂起等待唤醒，不再轮询休眠。
+     *     通过AddTask提交的带类型任务由TaskCostModel预测完成时间，自动选择大核或小核。
+     *     任务对象从投递线程的TaskArena中分配，可调用对象内联存储，稳定运行后投递与执行不再有堆分配。
+     * EN: Splits workers into a compute group (big cores) and a background group (little cores)
+     *     according to BigLittleDetector. On unified architectures there is only one group and
+     *     background tasks are served by the same workers at low priority.
+     *     Each worker is pinned to one logical CPU and owns a Chase-Lev deque,
+     *     tasks posted from outside go to the run queue of a scheduling domain (cluster or L3 domain).
+     *     Idle workers take from their own domain queue, then steal within the domain,
+     *     only then cross domains, and park until woken instead of sleep-polling.
+     *     Typed tasks submitted through AddTask are placed on big or little cores by the
+     *     predicted completion time from TaskCostModel.
+     *     Task objects come from the TaskArena of the posting thread and store their callable inline,
+     *     so posting and running tasks does not touch the heap after warm-up.
+     *
+     * CN: 可选的CpuLoadMonitor按频率与/proc/stat负载标记被降频或被其它进程占用的核心，
+     *     外部任务不再投向这些核心，大小核组的放置也按实际可用算力而不是线程数计算。
+     * EN: The optional CpuLoadMonitor marks cores that are throttled or busy with other processes;
+     *     external tasks are no longer routed to them, and big/little placement uses the effective
+     *     capacity of each group instead of its thread count.
+     *
+     * CN: 除普通任务外，每组还有高/低优先级FIFO通道和一个按截止时间排序的EDF通道。
+     *     取任务顺序为：EDF -> 已老化的低优先级 -> 高优先级 -> 普通 -> 低优先级。
+     *     连续执行HIGH_BURST个高优先级任务后让出一次给普通任务，低优先级任务等待超过老化时间后提升到最前，
+     *     但每个线程每AGED_INTERVAL次取任务最多提升一个，一批同时老化的低优先级任务不会挡住高优先级与普通任务，
+     *     因此任何通道都不会被饿死。超过截止时间才完成的任务计入统计并写入跟踪。
+     * EN: Besides normal tasks every group has high/low priority FIFO lanes and an earliest-deadline-first lane.
+     *     Pick order is: EDF -> aged low -> high -> normal -> low.
+     *     After HIGH_BURST high priority tasks in a row a worker yields once to normal work, and low priority tasks
+     *     that waited longer than the aging time are promoted to the front, at most one per AGED_INTERVAL picks of
+     *     a worker, so a backlog that ages all at once cannot hold back high and normal work; no lane starves.
+     *     Tasks finishing after their deadline are counted and recorded in the trace.
+     */
+    class TaskExecutor
+    {
+        struct WorkerGroup;
+        struct RunQueue;
+
+        struct Task
+        {
+            TaskFunc func;
+            TaskArena<Task> *arena = nullptr;               ///< CN: 分配该任务的分配区 / EN: Arena the task was allocated from
+
+            TaskTypeID type = TASK_TYPE_INVALID;            ///< CN: AddTask提交时的任务类型 / EN: Task type when submitted through AddTask
+            CoreClass core_class = CoreClass::Big;
+            uint64 predicted_ns = 0;
+
+            uint64 trace_id = 0;                            ///< CN: 开启跟踪时的任务序号 / EN: Task sequence number when tracing
+
+            double enqueue_time = 0;                        ///< CN: 进入优先级通道的时间，用于老化 / EN: Time it entered a priority lane, used for aging
+            double deadline = 0;                            ///< CN: 截止时间(GetPreciseTime)，0为无 / EN: Deadline (GetPreciseTime), 0 if none
+
+            Task(TaskFunc &&f) : func(std::move(f)) {}
+        };
+
+        /**
+         * CN: FIFO环形队列，只在容量不足时扩容，稳定后不再分配内存
+         * EN: FIFO ring, only grows when full, no allocation after warm-up
+         */
+        struct TaskRing
+        {
+            std::vector<Task *> items;
+            uint32 head = 0;
+            uint32 count = 0;
+
+            bool IsEmpty() const { return count == 0; }
+            uint32 GetCount() const { return count; }
+
+            Task *Front() const { return items[head]; }
+
+            void Push(Task *task)
+            {
+                if (count == items.size())
+                {
+                    std::vector<Task *> grown(items.empty() ? 64 : items.size() * 2);
+
+                    for (uint32 i = 0; i < count; ++i)
+                        grown[i] = items[(head + i) & (items.size() - 1)];
+
+                    items.swap(grown);
+                    head = 0;
+                }
+
+                items[(head + count) & (items.size() - 1)] = task;
+                ++count;
+            }
+
+            Task *Pop()
+            {
+                Task *task = items[head];
+
+                head = (head + 1) & (static_cast<uint32>(items.size()) - 1);
+                --count;
+                return task;
+            }
+        };
+
+        struct Worker
+        {
+            WorkerGroup *group = nullptr;
+            RunQueue *run_queue = nullptr;                  ///< CN: 所在调度域的运行队列 / EN: Run queue of own domain
+            uint32 index = 0;                               ///< CN: 组内序号 / EN: Index inside group
+            uint32 id = 0;                                  ///< CN: 全局序号，计算组在前 / EN: Global index, compute workers first
+            uint32 cpu_id = CPU_ID_INVALID;                 ///< CN: 分配的逻辑CPU / EN: Assigned logical CPU
+            std::atomic<bool> pinned{false};                ///< CN: 已成功绑定到cpu_id，绑定失败（如超出cpuset）时为false / EN: Successfully pinned to cpu_id, false if pinning failed (e.g. outside the cpuset)
+
+            WorkStealingDeque<Task *> local_queue;          ///< CN: 本线程产生的任务 / EN: Tasks spawned by this worker
+            TaskArena<Task> arena;                          ///< CN: 本线程投递的任务从这里分配 / EN: Tasks posted by this worker are allocated here
+
+            TraceRing trace;                                ///< CN: 本线程的调度事件 / EN: Scheduler events of this worker
+            WorkerCounters counters;
+
+            std::atomic<bool> avoid{false};                 ///< CN: 所在核心被降频或被其它进程占用 / EN: Core is throttled or busy with other processes
+            std::atomic<double> freq_ratio{1.0};
+            std::atomic<double> foreign_load{0};
+            uint64 monitor_park_ns = 0;                     ///< CN: 上次ApplyCpuLoad时的挂起时长 / EN: Parked time at the last ApplyCpuLoad
+
+            uint32 steal_seed = 0;
+            uint32 high_burst = 0;                          ///< CN: 连续执行的高优先级任务数 / EN: High priority tasks run in a row
+            uint32 aged_wait = 0;                           ///< CN: 距下一次允许提升老化低优先级任务还需的查找次数 / EN: Picks left before an aged low priority task may be promoted again
+            uint32 avoid_backoff = 0;                       ///< CN: 被回避时跳过共享队列的查找次数 / EN: Searches that skipped shared queues while avoided
+            std::thread thread;
+        };
+
+        /**
+         * CN: 调度域运行队列，同一簇/L3域内的工作线程共享
+         * EN: Domain run queue, shared by workers of one cluster/L3 domain
+         */
+        struct RunQueue
+        {
+            uint32 domain = 0;                              ///< CN: 调度域序号 / EN: Domain index in CpuTopology
+            uint32 queue_index = 0;                         ///< CN: 在组内run_queues中的序号 / EN: Index in group run_queues
+            std::vector<Worker *> workers;
+
+            std::mutex lock;
+            TaskRing tasks;
+            std::atomic<uint32> count{0};
+        };
+
+        /**
+         * CN: 组内共享的优先级通道
+         * EN: Priority lanes shared by a group
+         */
+        struct PriorityLanes
+        {
+            std::mutex lock;
+            std::vector<Task *> edf;                        ///< CN: 按截止时间的最小堆 / EN: Min-heap by deadline
+            TaskRing high;
+            TaskRing low;                                   ///< CN: 也承载统一架构下的后台任务 / EN: Also holds background tasks on unified architectures
+
+            std::atomic<uint32> edf_count{0};
+            std::atomic<uint32> high_count{0};
+            std::atomic<uint32> low_count{0};
+
+            static bool LaterDeadline(const Task *a, const Task *b) { return a->deadline > b->deadline; }
+        };
+
+        struct WorkerGroup
+        {
+            std::vector<Worker *> workers;
+            std::vector<RunQueue *> run_queues;
+            std::atomic<uint32> next_worker{0};
+
+            std::mutex park_lock;
+            std::condition_variable park_cv;
+            std::atomic<uint64> wake_epoch{0};
+            std::atomic<int32> sleeping{0};
+
+            PriorityLanes lanes;
+
+            std::atomic<uint64> pending_ns{0};              ///< CN: 已投递未完成的AddTask任务预测耗时 / EN: Predicted runtime of queued AddTask tasks
+            std::atomic<double> capacity{0};                ///< CN: 按频率与外部负载折算的可用线程数，0为按线程数 / EN: Effective worker count scaled by frequency and foreign load, 0 uses the thread count
+            std::atomic<uint32> avoid_count{0};             ///< CN: 被回避的线程数 / EN: Avoided workers
+        };
+
+        CpuInfo cpu_info;
+        CpuTopology topology;
+        TaskCostModel cost_model;
+
+        WorkerGroup compute_group;
+        WorkerGroup background_group;
+
+        std::mutex external_lock;
+        TaskArena<Task> external_arena;                     ///< CN: 非工作线程投递的任务从这里分配 / EN: Tasks posted by non-worker threads are allocated here
+
+        uint32 trace_capacity = 0;                          ///< CN: 每个线程的事件环容量，0为不跟踪 / EN: Event ring capacity per thread, 0 disables tracing
+        std::atomic<uint64> next_trace_id{1};
+        std::atomic<uint64> live_tasks{0};                  ///< CN: 已分配尚未执行完（或丢弃）的任务数 / EN: Tasks allocated and not yet finished (or dropped)
+        std::mutex external_trace_lock;
+        TraceRing external_trace;                           ///< CN: 非工作线程的入队事件 / EN: Enqueue events from non-worker threads
+        double stats_start_time = 0;
+
+        bool unified = true;
+        bool pin_threads = true;
+        std::atomic<bool> running{false};
+
+        double aging_time = 0.05;                           ///< CN: 低优先级任务的老化时间(秒) / EN: Aging time of low priority tasks (seconds)
+
+        double base_performance_ratio = 1.0;                ///< CN: 满频时的大核性能倍数 / EN: Big core speedup at full frequency
+        double monitor_time = 0;                            ///< CN: 上次ApplyCpuLoad的时间 / EN: Time of the last ApplyCpuLoad
+
+        std::thread monitor_thread;
+        std::mutex monitor_lock;
+        std::condition_variable monitor_cv;
+        bool monitor_running = false;
+
+        static Worker *&CurrentWorker()
+        {
+            static thread_local Worker *current = nullptr;
+            return current;
+        }
+
+    public:
+
+        /**
+         * @param sysfs_root CN: 读取拓扑的sysfs目录，测试时可指向假目录 / EN: sysfs directory the topology is read from, may point to a fake tree in tests
+         */
+        TaskExecutor(const std::string &sysfs_root = "/sys/devices/system/cpu")
+        {
+            if (!hgl::GetCpuInfo(&cpu_info))
+                throw std::runtime_error("Failed to get CPU information");
+
+            topology.Load(cpu_info, sysfs_root);
+        }
+
+        ~TaskExecutor()
+        {
+            Stop();
+        }
+
+        TaskExecutor(const TaskExecutor &) = delete;
+        TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+        const CpuInfo &GetCpuInfo() const { return cpu_info; }
+        const CpuTopology &GetTopology() const { return topology; }
+
+        bool IsRunning() const { return running.load(std::memory_order_relaxed); }
+        bool IsUnified() const { return unified; }
+
+        uint32 GetComputeWorkerCount() const { return static_cast<uint32>(compute_group.workers.size()); }
+        uint32 GetBackgroundWorkerCount() const { return static_cast<uint32>(background_group.workers.size()); }
+
+        TaskCostModel &GetCostModel() { return cost_model; }
+        const TaskCostModel &GetCostModel() const { return cost_model; }
+
+        /**
+         * CN: 组的可用算力（按频率与外部负载折算的线程数），未启用监控时等于线程数
+         * EN: Effective capacity of a group (thread count scaled by frequency and foreign load), equals the thread count without monitoring
+         */
+        double GetComputeCapacity() const { return GetCapacity(compute_group); }
+        double GetBackgroundCapacity() const { return GetCapacity(background_group); }
+
+        uint32 GetComputeDomainCount() const { return static_cast<uint32>(compute_group.run_queues.size()); }
+        uint32 GetBackgroundDomainCount() const { return static_cast<uint32>(background_group.run_queues.size()); }
+
+        /**
+         * CN: 设置是否将工作线程绑定到CPU，需在Start前调用
+         * EN: Set whether workers are pinned to CPUs, call before Start
+         */
+        void SetPinThreads(bool pin) { pin_threads = pin; }
+
+        /**
+         * CN: 设置每个线程的跟踪事件环容量，需在Start前调用，0为关闭跟踪
+         * EN: Set the trace event ring capacity per thread, call before Start, 0 disables tracing
+         */
+        void SetTraceCapacity(uint32 events) { trace_capacity = events; }
+
+        bool IsTracing() const { return trace_capacity > 0; }
+
+        /**
+         * CN: 设置低优先级任务的老化时间，等待超过该时间的任务会先于高优先级与普通任务执行
+         * EN: Set the aging time of low priority tasks, tasks waiting longer run ahead of high priority and normal tasks
+         */
+        void SetAgingTime(double seconds) { aging_time = seconds; }
+        double GetAgingTime() const { return aging_time; }
+
+        /**
+         * CN: 按大小核检测结果启动工作线程，每个逻辑CPU一个
+         * EN: Start one worker per logical CPU according to big.LITTLE detection
+         */
+        void Start()
+        {
+            const uint32 big = topology.GetBigCount();
+            const uint32 little = topology.GetLittleCount();
+
+            if (big > 0 && little > 0)
+                Start(big, little);
+            else
+                Start(topology.GetCpuCount(), 0);
+        }
+
+        /**
+         * CN: 以指定线程数启动
+         * EN: Start with explicit worker counts
+         * @param compute_count CN: 计算线程数，依次分配到大核 / EN: Compute worker count, assigned to big cores in domain order
+         * @param background_count CN: 后台线程数，依次分配到小核；为0时使用统一架构模式 / EN: Background worker count, assigned to little cores; 0 selects unified mode
+         */
+        void Start(uint32 compute_count, uint32 background_count)
+        {
+            if (running.load())
+                return;
+
+            if (compute_count == 0)
+                compute_count = 1;
+
+            unified = (background_count == 0);
+            running = true;
+
+            external_trace.Init(trace_capacity);
+            stats_start_time = GetPreciseTime();
+
+            base_performance_ratio = BigLittleDetector::Detect(cpu_info).performance_ratio;
+            cost_model.SetPerformanceRatio(base_performance_ratio);
+            monitor_time = stats_start_time;
+
+            std::vector<uint32> compute_cpus = unified ? topology.GetCpuList() : topology.GetCpuList(true);
+            std::vector<uint32> background_cpus = topology.GetCpuList(false);
+
+            if (compute_cpus.empty())
+                compute_cpus = topology.GetCpuList();
+
+            if (background_cpus.empty())
+                background_cpus = compute_cpus;
+
+            CreateWorkers(compute_group, compute_count, compute_cpus, 0);
+            CreateWorkers(background_group, background_count, background_cpus, compute_count);
+
+            LaunchWorkers(compute_group);
+            LaunchWorkers(background_group);
+        }
+
+        /**
+         * CN: 停止所有工作线程
+         * EN: Stop every worker
+         *
+         * CN: 先等已投递的任务（包括它们继续投递的任务）全部执行完再停止，在TaskGraph::WaitFor、SyncWait、
+         *     ParallelFor/ParallelReduce中等待的线程因此都能等到计数归零。不断重新投递自身的任务会让Stop一直等待，
+         *     需先让它们结束。不能在工作线程中调用；与Stop并发投递的任务可能被丢弃而不执行。
+         * EN: Waits until every posted task (including tasks they post in turn) has finished before stopping, so threads
+         *     waiting in TaskGraph::WaitFor, SyncWait or ParallelFor/ParallelReduce always see their counter reach zero.
+         *     A task that keeps reposting itself keeps Stop waiting and must be ended first.
+         *     Must not be called from a worker; tasks posted concurrently with Stop may be dropped without running.
+         */
+        void Stop()
+        {
+            StopCpuMonitor();
+
+            if (!running.load())
+                return;
+
+            while (live_tasks.load(std::memory_order_acquire) > 0)
+                std::this_thread::yield();
+
+            if (!running.exchange(false))
+                return;
+
+            WakeAll(compute_group);
+            WakeAll(background_group);
+
+            // 工作线程会跨组投递和窃取任务，所有线程都退出后才能释放任何一组的队列
+            JoinWorkers(compute_group);
+            JoinWorkers(background_group);
+
+            ClearQueues(compute_group);
+            ClearQueues(background_group);
+
+            // 任务可能跨组投递，两组的残留任务都清掉后才能释放各线程的分配区
+            DeleteWorkers(compute_group);
+            DeleteWorkers(background_group);
+        }
+
+        /**
+         * CN: 添加计算任务（统一架构下与后台任务共用线程，但优先执行）
+         * EN: Add a compute task (served before background tasks on unified architectures)
+         */
+        void AddComputeTask(TaskFunc func, TaskPriority priority = TaskPriority::Normal)
+        {
+            Task *task = NewTask(std::move(func));
+
+            if (priority == TaskPriority::Normal)
+                Submit(compute_group, task);
+            else
+                SubmitLane(compute_group, task, priority);
+        }
+
+        /**
+         * CN: 添加后台任务，统一架构下普通后台任务进入低优先级通道
+         * EN: Add a background task, on unified architectures normal background tasks go to the low priority lane
+         */
+        void AddBackgroundTask(TaskFunc func, TaskPriority priority = TaskPriority::Normal)
+        {
+            Task *task = NewTask(std::move(func));
+
+            if (unified)
+                SubmitLane(compute_group, task, priority == TaskPriority::High ? TaskPriority::High : TaskPriority::Low);
+            else if (priority == TaskPriority::Normal)
+                Submit(background_group, task);
+            else
+                SubmitLane(background_group, task, priority);
+        }
+
+        /**
+         * CN: 添加带截止时间的任务，按最早截止时间优先执行，超时完成的任务计入统计
+         * EN: Add a task with a deadline, run earliest deadline first; tasks finishing late are counted
+         * @param deadline CN: 截止时间(GetPreciseTime，秒) / EN: Deadline (GetPreciseTime, seconds)
+         * @param background CN: 是否在后台组执行 / EN: Run on the background group
+         */
+        void AddDeadlineTask(TaskFunc func, double deadline, bool background = false)
+        {
+            Task *task = NewTask(std::move(func));
+            WorkerGroup &group = (background && !unified) ? background_group : compute_group;
+            PriorityLanes &lanes = group.lanes;
+            uint32 depth;
+
+            task->deadline = deadline;
+
+            {
+                std::lock_guard<std::mutex> lock(lanes.lock);
+                lanes.edf.push_back(task);
+                std::push_heap(lanes.edf.begin(), lanes.edf.end(), PriorityLanes::LaterDeadline);
+                depth = lanes.edf_count.fetch_add(1, std::memory_order_release) + 1;
+            }
+
+            TraceEnqueue(CurrentWorker(), task, depth);
+
+            Wake(group);
+        }
+
+        /**
+         * CN: 所有线程超过截止时间完成的任务总数
+         * EN: Total tasks that finished after their deadline on all workers
+         */
+        uint64 GetDeadlineMissCount() const
+        {
+            uint64 total = 0;
+
+            for (const WorkerGroup *group : {&compute_group, &background_group})
+                for (const Worker *w : group->workers)
+                    total += w->counters.deadline_misses.load(std::memory_order_relaxed);
+
+            return total;
+        }
+
+        /**
+         * CN: 获取当前线程的工作线程序号，非工作线程返回-1
+         * EN: Get the worker ID of the calling thread, -1 if it is not a worker
+         */
+        static int32 GetCurrentWorkerID()
+        {
+            const Worker *w = CurrentWorker();
+            return w ? static_cast<int32>(w->id) : -1;
+        }
+
+        /**
+         * CN: 当前线程是否为本执行器计算组的工作线程
+         * EN: Whether the calling thread is a compute worker of this executor
+         */
+        bool IsComputeWorker() const
+        {
+            const Worker *w = CurrentWorker();
+            return w && w->group == &compute_group;
+        }
+
+        /**
+         * CN: 当前线程是否为本执行器后台组的工作线程
+         * EN: Whether the calling thread is a background worker of this executor
+         */
+        bool IsBackgroundWorker() const
+        {
+            const Worker *w = CurrentWorker();
+            return w && w->group == &background_group;
+        }
+
+        /**
+         * CN: 获取各工作线程的统计（计算组在前）
+         * EN: Get statistics of every worker (compute workers first)
+         */
+        std::vector<WorkerStats> GetWorkerStats() const
+        {
+            std::vector<WorkerStats> result;
+            const double elapsed = GetPreciseTime() - stats_start_time;
+
+            for (const WorkerGroup *group : {&compute_group, &background_group})
+            {
+                for (const Worker *w : group->workers)
+                {
+                    WorkerStats ws;
+                    const WorkerCounters &c = w->counters;
+
+                    ws.id = w->id;
+                    ws.background = (group == &background_group);
+                    ws.cpu_id = w->cpu_id;
+                    ws.pinned = w->pinned.load(std::memory_order_relaxed);
+                    ws.executed = c.executed.load(std::memory_order_relaxed);
+                    ws.stolen = c.stolen.load(std::memory_order_relaxed);
+                    ws.parks = c.parks.load(std::memory_order_relaxed);
+                    ws.steal_rate = ws.executed ? double(ws.stolen) / double(ws.executed) : 0;
+                    ws.idle_percent = elapsed > 0 ? double(c.park_ns.load(std::memory_order_relaxed)) * 1e-9 / elapsed * 100.0 : 0;
+                    ws.avg_queue_depth = ws.executed ? double(c.depth_sum.load(std::memory_order_relaxed)) / double(ws.executed) : 0;
+                    ws.max_queue_depth = c.depth_max.load(std::memory_order_relaxed);
+                    ws.avoided = w->avoid.load(std::memory_order_relaxed);
+                    ws.freq_ratio = w->freq_ratio.load(std::memory_order_relaxed);
+                    ws.foreign_load = w->foreign_load.load(std::memory_order_relaxed);
+                    ws.deadline_tasks = c.deadline_tasks.load(std::memory_order_relaxed);
+                    ws.deadline_misses = c.deadline_misses.load(std::memory_order_relaxed);
+                    ws.max_lateness_ms = double(c.max_lateness_ns.load(std::memory_order_relaxed)) * 1e-6;
+
+                    result.push_back(ws);
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * CN: 清零统计计数并重新开始计时
+         * EN: Clear the counters and restart the sampling period
+         */
+        void ResetStats()
+        {
+            for (WorkerGroup *group : {&compute_group, &background_group})
+                for (Worker *w : group->workers)
+                    w->counters.Reset();
+
+            stats_start_time = GetPreciseTime();
+        }
+
+        /**
+         * CN: 把各线程事件环中的事件导出为Chrome trace JSON，运行中也可以调用
+         * EN: Export the events in every ring as Chrome trace JSON, may be called while running
+         */
+        bool ExportChromeTrace(const std::string &filename)
+        {
+            if (!IsTracing())
+                return false;
+
+            std::vector<TraceTimeline> timelines;
+
+            for (WorkerGroup *group : {&compute_group, &background_group})
+            {
+                for (Worker *w : group->workers)
+                {
+                    TraceTimeline tl;
+
+                    tl.tid = w->id;
+                    tl.name = std::string(group == &compute_group ? "Compute " : "Background ") + std::to_string(w->id)
+                            + " (CPU " + std::to_string(w->cpu_id)
+                            + (w->pinned.load(std::memory_order_relaxed) ? ")" : ", unpinned)");
+
+                    w->trace.Snapshot(tl.events);
+                    timelines.push_back(std::move(tl));
+                }
+            }
+
+            {
+                TraceTimeline tl;
+
+                tl.tid = 10000;
+                tl.name = "External";
+
+                {
+                    std::lock_guard<std::mutex> lock(external_trace_lock);
+                    external_trace.Snapshot(tl.events);
+                }
+
+                timelines.push_back(std::move(tl));
+            }
+
+            return WriteChromeTrace(filename, timelines, stats_start_time);
+        }
+
+        /**
+         * CN: 在工作线程中执行一个待处理任务，用于等待期间帮助执行，避免阻塞工作线程
+         * EN: Run one pending task on the calling worker, used to help while waiting instead of blocking the worker
+         * @return CN: 执行了任务返回true，无任务或非工作线程返回false / EN: Returns true if a task ran, false if none or not a worker
+         */
+        bool RunPendingTask()
+        {
+            Worker *w = CurrentWorker();
+
+            if (!w || (w->group != &compute_group && w->group != &background_group))
+                return false;
+
+            Task *task = FindTask(w, false);
+
+            if (!task)
+                return false;
+
+            RunTask(w, task);
+            return true;
+        }
+
+        /**
+         * CN: 注册任务类型
+         * EN: Register a task type
+         * @param cost_hint CN: 默认开销提示(秒,大核) / EN: Default cost hint (seconds, big core)
+         */
+        TaskTypeID RegisterTaskType(const std::string &name, double cost_hint = 0)
+        {
+            return cost_model.Register(name, cost_hint);
+        }
+
+        /**
+         * CN: 添加带类型的任务，由开销模型选择在大核或小核上执行
+         * EN: Add a typed task, the cost model chooses big or little cores
+         * @param cost_hint CN: 本次的开销提示(秒,大核)，0表示使用历史或类型默认值 / EN: Cost hint for this task (seconds, big core), 0 uses history or type default
+         * @return CN: 选择的核心类型 / EN: Chosen core class
+         */
+        CoreClass AddTask(TaskTypeID type, TaskFunc func, double cost_hint = 0)
+        {
+            double predicted;
+            const CoreClass cc = Place(type, cost_hint, predicted);
+            WorkerGroup &group = (cc == CoreClass::Big) ? compute_group : background_group;
+            const uint64 ns = static_cast<uint64>(predicted * 1e9);
+
+            group.pending_ns.fetch_add(ns, std::memory_order_relaxed);
+
+            Task *task = NewTask(std::move(func));
+
+            task->type = type;
+            task->core_class = cc;
+            task->predicted_ns = ns;
+
+            Submit(group, task);
+            return cc;
+        }
+
+        /**
+         * CN: 按一次采样结果更新各工作线程的回避标记、各组可用算力与实时大小核性能倍数
+         * EN: Update the avoid flag of every worker, the capacity of each group and the live big/little ratio from one sample
+         *
+         * CN: 核心负载减去本线程自己的繁忙比例（由挂起时长推算）即为其它进程的负载。
+         *     外部负载过高，或有负载时频率明显低于最大频率（温控降频）的核心会被回避。
+         *     不能与自身并发调用，StartCpuMonitor的线程会定时调用它。
+         * EN: Foreign load is the core load minus this worker's own busy fraction (derived from its parked time).
+         *     Cores with high foreign load, or running well below max frequency while loaded (thermal throttling), are avoided.
+         *     Must not be called concurrently with itself; the StartCpuMonitor thread calls it periodically.
+         */
+        void ApplyCpuLoad(const CpuLoadMonitor &monitor)
+        {
+            constexpr double AVOID_FOREIGN_LOAD = 0.5;      // 其它进程占用超过一半
+            constexpr double THROTTLE_RATIO     = 0.75;     // 有负载时低于最大频率的75%视为降频
+            constexpr double THROTTLE_LOAD      = 0.5;
+            constexpr double AVOID_WEIGHT       = 0.25;     // 被回避的线程退避后仍会取任务，按1/4算力计
+
+            const double now = GetPreciseTime();
+            const double dt = now - monitor_time;
+
+            monitor_time = now;
+
+            double class_freq[2] = {0, 0};                  // 0为大核，1为小核
+            uint32 class_count[2] = {0, 0};
+
+            for (WorkerGroup *group : {&compute_group, &background_group})
+            {
+                double capacity = 0;
+                uint32 avoid_count = 0;
+
+                for (Worker *w : group->workers)
+                {
+                    const uint64 park_ns = w->counters.park_ns.load(std::memory_order_relaxed);
+                    const double parked = double(park_ns - w->monitor_park_ns) * 1e-9;
+
+                    w->monitor_park_ns = park_ns;
+
+                    const CpuLoadSample *s = monitor.Get(w->cpu_id);
+
+                    double ratio = 1.0;
+                    double foreign = 0;
+                    bool avoid = false;
+
+                    if (s)
+                    {
+                        ratio = s->freq_ratio;
+
+                        if (s->has_load)
+                        {
+                            // 未绑定（或绑定失败）时线程不固定在该核心上，无法扣除自身负载
+                            const double own_busy = (w->pinned.load(std::memory_order_relaxed) && dt > 0) ? std::clamp(1.0 - parked / dt, 0.0, 1.0) : 0.0;
+
+                            foreign = std::max(0.0, s->load - own_busy);
+
+                            avoid = foreign > AVOID_FOREIGN_LOAD
+                                 || (ratio < THROTTLE_RATIO && s->load > THROTTLE_LOAD);
+                        }
+
+                        if (s->max_freq > 0)
+                        {
+                            const LogicalCpu *lc = topology.GetCpu(w->cpu_id);
+                            const int cls = (lc && !lc->is_big) ? 1 : 0;
+
+                            class_freq[cls] += ratio;
+                            ++class_count[cls];
+                        }
+                    }
+
+                    w->freq_ratio.store(ratio, std::memory_order_relaxed);
+                    w->foreign_load.store(foreign, std::memory_order_relaxed);
+                    w->avoid.store(avoid, std::memory_order_relaxed);
+
+                    capacity += ratio * (avoid ? AVOID_WEIGHT : 1.0);
+
+                    if (avoid)
+                        ++avoid_count;
+                }
+
+                group->avoid_count.store(avoid_count, std::memory_order_relaxed);
+
+                group->capacity.store(group->workers.empty() ? 0 : std::max(capacity, 0.1), std::memory_order_relaxed);
+            }
+
+            // 基准倍数按满频测得，两类核心降频程度不同时按当前频率比例修正
+            if (!unified && class_count[0] > 0 && class_count[1] > 0)
+            {
+                const double big = class_freq[0] / class_count[0];
+                const double little = class_freq[1] / class_count[1];
+
+                if (big > 0 && little > 0)
+                    cost_model.SetPerformanceRatio(base_performance_ratio * big / little);
+            }
+        }
+
+        /**
+         * CN: 启动监控线程，按固定间隔采样并调用ApplyCpuLoad，需在Start之后调用
+         * EN: Start a monitor thread that samples at a fixed interval and calls ApplyCpuLoad, call after Start
+         * @param interval CN: 采样间隔(秒) / EN: Sampling interval (seconds)
+         */
+        void StartCpuMonitor(double interval = 0.1,
+                             const std::string &sysfs_root = "/sys/devices/system/cpu",
+                             const std::string &proc_stat = "/proc/stat")
+        {
+            if (!running.load() || monitor_thread.joinable())
+                return;
+
+            monitor_running = true;
+
+            monitor_thread = std::thread([this, interval, sysfs_root, proc_stat]()
+            {
+                CpuLoadMonitor monitor(sysfs_root, proc_stat);
+
+                monitor.Init(topology);
+                monitor.Sample();
+
+                std::unique_lock<std::mutex> lock(monitor_lock);
+
+                while (!monitor_cv.wait_for(lock, std::chrono::duration<double>(interval), [this]() { return !monitor_running; }))
+                {
+                    lock.unlock();
+
+                    if (monitor.Sample())
+                        ApplyCpuLoad(monitor);
+
+                    lock.lock();
+                }
+            });
+        }
+
+        void StopCpuMonitor()
+        {
+            if (!monitor_thread.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(monitor_lock);
+                monitor_running = false;
+            }
+
+            monitor_cv.notify_all();
+            monitor_thread.join();
+        }
+
+    private:
+
+        /**
+         * CN: 组的可用算力，未采样时为线程数
+         * EN: Effective capacity of a group, the thread count until sampled
+         */
+        static double GetCapacity(const WorkerGroup &group)
+        {
+            const double capacity = group.capacity.load(std::memory_order_relaxed);
+
+            return capacity > 0 ? capacity : double(group.workers.size());
+        }
+
+        bool IsOwnWorker(const Worker *w) const
+        {
+            return w && (w->group == &compute_group || w->group == &background_group);
+        }
+
+        /**
+         * CN: 工作线程从自己的分配区无锁分配，其它线程共用一个加锁的分配区
+         * EN: Workers allocate lock-free from their own arena, other threads share one locked arena
+         */
+        Task *NewTask(TaskFunc &&func)
+        {
+            Worker *self = CurrentWorker();
+            Task *task;
+
+            if (IsOwnWorker(self))
+            {
+                task = self->arena.New(std::move(func));
+                task->arena = &self->arena;
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(external_lock);
+
+                task = external_arena.New(std::move(func));
+                task->arena = &external_arena;
+            }
+
+            if (trace_capacity > 0)
+                task->trace_id = next_trace_id.fetch_add(1, std::memory_order_relaxed);
+
+            live_tasks.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+
+        void DeleteTask(Task *task)
+        {
+            task->arena->Delete(task);
+            live_tasks.fetch_sub(1, std::memory_order_release);
+        }
+
+        /**
+         * CN: 记录入队事件，depth为入队后的队列长度
+         * EN: Record an enqueue event, depth is the queue length after the push
+         */
+        void TraceEnqueue(Worker *self, const Task *task, uint32 depth)
+        {
+            if (trace_capacity == 0)
+                return;
+
+            if (self && self->trace.IsEnabled())
+            {
+                self->trace.Record(GetPreciseTime(), TraceEventType::Enqueue, task->trace_id, depth);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(external_trace_lock);
+                external_trace.Record(GetPreciseTime(), TraceEventType::Enqueue, task->trace_id, depth);
+            }
+        }
+
+        void RunTask(Worker *w, Task *task)
+        {
+            WorkerCounters::Add(w->counters.executed, 1);
+            w->counters.SampleDepth(static_cast<uint32>(w->local_queue.GetCount()) + w->run_queue->count.load(std::memory_order_relaxed));
+
+            const bool tracing = w->trace.IsEnabled();
+
+            if (tracing)
+                w->trace.Record(GetPreciseTime(), TraceEventType::Start, task->trace_id, task->type);
+
+            if (task->type == TASK_TYPE_INVALID)
+            {
+                task->func();
+            }
+            else
+            {
+                const double st = GetPreciseTime();
+                task->func();
+                cost_model.Record(task->type, task->core_class, GetPreciseTime() - st);
+
+                w->group->pending_ns.fetch_sub(task->predicted_ns, std::memory_order_relaxed);
+            }
+
+            if (task->deadline > 0)
+            {
+                const double finish = GetPreciseTime();
+
+                WorkerCounters::Add(w->counters.deadline_tasks, 1);
+
+                if (finish > task->deadline)
+                {
+                    const uint64 late_ns = static_cast<uint64>((finish - task->deadline) * 1e9);
+
+                    WorkerCounters::Add(w->counters.deadline_misses, 1);
+
+                    if (late_ns > w->counters.max_lateness_ns.load(std::memory_order_relaxed))
+                        w->counters.max_lateness_ns.store(late_ns, std::memory_order_relaxed);
+
+                    if (tracing)
+                        w->trace.Record(finish, TraceEventType::DeadlineMiss, task->trace_id, static_cast<uint32>(late_ns / 1000));
+                }
+            }
+
+            if (tracing)
+                w->trace.Record(GetPreciseTime(), TraceEventType::End, task->trace_id);
+
+            DeleteTask(task);
+        }
+
+        /**
+         * CN: 比较在大核组与小核组上的预测完成时间（排队中的预测工作量/可用算力 + 本任务预测耗时）
+         * EN: Compare predicted completion time on both groups (queued predicted work / effective capacity + predicted runtime)
+         */
+        CoreClass Place(TaskTypeID type, double cost_hint, double &predicted) const
+        {
+            const double big_time = cost_model.Predict(type, CoreClass::Big, cost_hint);
+
+            predicted = big_time;
+
+            if (unified || background_group.workers.empty() || cost_model.IsMigrated(type))
+                return CoreClass::Big;
+
+            const double little_time = cost_model.Predict(type, CoreClass::Little, cost_hint);
+
+            const double big_done = double(compute_group.pending_ns.load(std::memory_order_relaxed)) * 1e-9
+                                  / GetCapacity(compute_group) + big_time;
+            const double little_done = double(background_group.pending_ns.load(std::memory_order_relaxed)) * 1e-9
+                                     / GetCapacity(background_group) + little_time;
+
+            if (little_done <= big_done)
+            {
+                predicted = little_time;
+                return CoreClass::Little;
+            }
+
+            return CoreClass::Big;
+        }
+
+        void CreateWorkers(WorkerGroup &group, uint32 count, const std::vector<uint32> &cpu_list, uint32 first_id)
+        {
+            group.workers.reserve(count);
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Worker *w = new Worker;
+
+                w->group = &group;
+                w->index = i;
+                w->id = first_id + i;
+                w->cpu_id = cpu_list.empty() ? CPU_ID_INVALID : cpu_list[i % cpu_list.size()];
+                w->steal_seed = 0x9E3779B9u * (i + 1);
+                w->trace.Init(trace_capacity);
+
+                const LogicalCpu *lc = topology.GetCpu(w->cpu_id);
+                const uint32 domain = lc ? lc->domain : 0;
+
+                RunQueue *rq = nullptr;
+
+                for (RunQueue *q : group.run_queues)
+                    if (q->domain == domain)
+                        rq = q;
+
+                if (!rq)
+                {
+                    rq = new RunQueue;
+                    rq->domain = domain;
+                    rq->queue_index = static_cast<uint32>(group.run_queues.size());
+                    group.run_queues.push_back(rq);
+                }
+
+                rq->workers.push_back(w);
+                w->run_queue = rq;
+
+                group.workers.push_back(w);
+            }
+        }
+
+        void LaunchWorkers(WorkerGroup &group)
+        {
+            for (Worker *w : group.workers)
+                w->thread = std::thread([this, w]() { WorkerLoop(w); });
+        }
+
+        void JoinWorkers(WorkerGroup &group)
+        {
+            for (Worker *w : group.workers)
+            {
+                if (w->thread.joinable())
+                    w->thread.join();
+            }
+        }
+
+        void ClearQueues(WorkerGroup &group)
+        {
+            Task *task;
+
+            for (Worker *w : group.workers)
+                while (w->local_queue.Pop(task))
+                    DeleteTask(task);
+
+            for (RunQueue *rq : group.run_queues)
+            {
+                while (!rq->tasks.IsEmpty())
+                    DeleteTask(rq->tasks.Pop());
+
+                delete rq;
+            }
+
+            PriorityLanes &lanes = group.lanes;
+
+            for (Task *t : lanes.edf)
+                DeleteTask(t);
+
+            while (!lanes.high.IsEmpty())
+                DeleteTask(lanes.high.Pop());
+
+            while (!lanes.low.IsEmpty())
+                DeleteTask(lanes.low.Pop());
+
+            lanes.edf.clear();
+            lanes.edf_count = 0;
+            lanes.high_count = 0;
+            lanes.low_count = 0;
+
+            group.run_queues.clear();
+            group.next_worker = 0;
+            group.pending_ns = 0;
+            group.capacity = 0;
+            group.avoid_count = 0;
+        }
+
+        void DeleteWorkers(WorkerGroup &group)
+        {
+            for (Worker *w : group.workers)
+                delete w;
+
+            group.workers.clear();
+        }
+
+        void Submit(WorkerGroup &group, Task *task)
+        {
+            Worker *self = CurrentWorker();
+
+            if (self && self->group == &group)
+            {
+                self->local_queue.Push(task);           // 本组线程产生的任务直接进入自己的队列，无锁
+
+                TraceEnqueue(self, task, static_cast<uint32>(self->local_queue.GetCount()));
+            }
+            else
+            {
+                const uint32 n = static_cast<uint32>(group.workers.size());
+
+                if (n == 0)
+                {
+                    DeleteTask(task);
+                    return;
+                }
+
+                // 按工作线程轮转选择调度域，线程多的域分到的任务也多；跳过被回避的线程，全部被回避时仍按轮转
+                const uint32 start = group.next_worker.fetch_add(1, std::memory_order_relaxed);
+                RunQueue *rq = group.workers[start % n]->run_queue;
+
+                for (uint32 i = 0; i < n; ++i)
+                {
+                    const Worker *target = group.workers[(start + i) % n];
+
+                    if (!target->avoid.load(std::memory_order_relaxed))
+                    {
+                        rq = target->run_queue;
+                        break;
+                    }
+                }
+                uint32 depth;
+
+                {
+                    std::lock_guard<std::mutex> lock(rq->lock);
+                    rq->tasks.Push(task);
+                    depth = rq->count.fetch_add(1, std::memory_order_release) + 1;
+                }
+
+                TraceEnqueue(self, task, depth);
+            }
+
+            Wake(group);
+        }
+
+        void SubmitLane(WorkerGroup &group, Task *task, TaskPriority priority)
+        {
+            PriorityLanes &lanes = group.lanes;
+            const bool high = (priority == TaskPriority::High);
+            uint32 depth;
+
+            task->enqueue_time = GetPreciseTime();
+
+            {
+                std::lock_guard<std::mutex> lock(lanes.lock);
+
+                if (high)
+                {
+                    lanes.high.Push(task);
+                    depth = lanes.high_count.fetch_add(1, std::memory_order_release) + 1;
+                }
+                else
+                {
+                    lanes.low.Push(task);
+                    depth = lanes.low_count.fetch_add(1, std::memory_order_release) + 1;
+                }
+            }
+
+            TraceEnqueue(CurrentWorker(), task, depth);
+
+            Wake(group);
+        }
+
+        /**
+         * CN: 仅在有线程挂起时才进入锁并通知，繁忙时只有一次fence和一次load
+         * EN: Only locks and notifies when a worker is parked; while busy this costs one fence and one load
+         */
+        void Wake(WorkerGroup &group)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (group.sleeping.load(std::memory_order_relaxed) <= 0)
+                return;
+
+            group.wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+            std::lock_guard<std::mutex> lock(group.park_lock);
+            group.park_cv.notify_one();
+        }
+
+        void WakeAll(WorkerGroup &group)
+        {
+            group.wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+            std::lock_guard<std::mutex> lock(group.park_lock);
+            group.park_cv.notify_all();
+        }
+
+        /**
+         * CN: 从运行队列批量取任务，第一个直接返回，其余按FIFO顺序放入本线程队列
+         * EN: Take a batch from a run queue, return the first and move the rest into the local deque in FIFO order
+         */
+        Task *TakeFromRunQueue(Worker *w, RunQueue *rq, uint32 max_batch)
+        {
+            if (rq->count.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            Task *batch[32];
+            uint32 taken = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(rq->lock);
+
+                const uint32 size = rq->tasks.GetCount();
+                const uint32 share = size / static_cast<uint32>(rq->workers.size()) + 1;
+
+                uint32 n = share < max_batch ? share : max_batch;
+                if (n > size) n = size;
+                if (n > 32) n = 32;
+
+                for (; taken < n; ++taken)
+                    batch[taken] = rq->tasks.Pop();
+
+                rq->count.store(rq->tasks.GetCount(), std::memory_order_relaxed);
+            }
+
+            if (taken == 0)
+                return nullptr;
+
+            for (uint32 i = taken - 1; i > 0; --i)
+                w->local_queue.Push(batch[i]);
+
+            return batch[0];
+        }
+
+        Task *StealFromWorkers(Worker *w, const std::vector<Worker *> &victims)
+        {
+            const uint32 n = static_cast<uint32>(victims.size());
+
+            if (n == 0)
+                return nullptr;
+
+            w->steal_seed ^= w->steal_seed << 13;
+            w->steal_seed ^= w->steal_seed >> 17;
+            w->steal_seed ^= w->steal_seed << 5;
+
+            const uint32 start = w->steal_seed % n;
+            Task *task;
+
+            for (uint32 i = 0; i < n; ++i)
+            {
+                Worker *victim = victims[(start + i) % n];
+
+                if (victim != w && victim->local_queue.Steal(task))
+                {
+                    WorkerCounters::Add(w->counters.stolen, 1);
+
+                    if (w->trace.IsEnabled())
+                        w->trace.Record(GetPreciseTime(), TraceEventType::Steal, task->trace_id, victim->id);
+
+                    return task;
+                }
+            }
+
+            return nullptr;
+        }
+
+        Task *TakeDeadline(WorkerGroup *group)
+        {
+            PriorityLanes &lanes = group->lanes;
+
+            if (lanes.edf_count.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            std::lock_guard<std::mutex> lock(lanes.lock);
+
+            if (lanes.edf.empty())
+                return nullptr;
+
+            std::pop_heap(lanes.edf.begin(), lanes.edf.end(), PriorityLanes::LaterDeadline);
+
+            Task *task = lanes.edf.back();
+
+            lanes.edf.pop_back();
+            lanes.edf_count.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+
+        Task *TakeHigh(WorkerGroup *group)
+        {
+            PriorityLanes &lanes = group->lanes;
+
+            if (lanes.high_count.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            std::lock_guard<std::mutex> lock(lanes.lock);
+
+            if (lanes.high.IsEmpty())
+                return nullptr;
+
+            lanes.high_count.fetch_sub(1, std::memory_order_relaxed);
+            return lanes.high.Pop();
+        }
+
+        /**
+         * @param aged_only CN: 只取等待超过老化时间的任务 / EN: Only take a task that waited longer than the aging time
+         */
+        Task *TakeLow(WorkerGroup *group, bool aged_only)
+        {
+            PriorityLanes &lanes = group->lanes;
+
+            if (lanes.low_count.load(std::memory_order_acquire) == 0)
+                return nullptr;
+
+            const double now = aged_only ? GetPreciseTime() : 0;
+
+            std::lock_guard<std::mutex> lock(lanes.lock);
+
+            if (lanes.low.IsEmpty())
+                return nullptr;
+
+            if (aged_only && now - lanes.low.Front()->enqueue_time < aging_time)
+                return nullptr;
+
+            lanes.low_count.fetch_sub(1, std::memory_order_relaxed);
+            return lanes.low.Pop();
+        }
+
+        /**
+         * CN: 查找顺序：EDF通道 -> 已老化的低优先级 -> 高优先级 -> 普通任务 -> 低优先级
+         * EN: Search order: EDF lane -> aged low priority -> high priority -> normal tasks -> low priority
+         *
+         * CN: 被回避的线程只取本线程队列，每AVOID_BACKOFF次查找才访问一次共享队列与其它线程，把任务让给健康线程；
+         *     组内全部线程都被回避时不退避。挂起前的最后一次检查传入full，总是完整查找，避免丢失唤醒。
+         * EN: An avoided worker only takes from its own deque and touches the shared queues and other workers once
+         *     every AVOID_BACKOFF searches, leaving the tasks to healthy workers; there is no backoff when every
+         *     worker of the group is avoided. The last check before parking passes full and always searches
+         *     everything, so no wakeup is lost.
+         */
+        Task *FindTask(Worker *w, bool full)
+        {
+            constexpr uint32 HIGH_BURST = 8;                // 连续执行的高优先级任务上限，之后让普通任务执行一次
+            constexpr uint32 AVOID_BACKOFF = 8;
+            constexpr uint32 AGED_INTERVAL = 4;             // 每个线程每4次取任务最多提升一个老化的低优先级任务
+
+            WorkerGroup *group = w->group;
+            Task *task;
+
+            if (!full && w->avoid.load(std::memory_order_relaxed)
+             && group->avoid_count.load(std::memory_order_relaxed) < group->workers.size())
+            {
+                if (w->local_queue.Pop(task))
+                    return task;
+
+                if (++w->avoid_backoff < AVOID_BACKOFF)
+                    return nullptr;
+            }
+
+            w->avoid_backoff = 0;
+
+            if ((task = TakeDeadline(group)))
+                return task;
+
+            if (w->aged_wait > 0)
+                --w->aged_wait;
+            else if ((task = TakeLow(group, true)))
+            {
+                w->aged_wait = AGED_INTERVAL - 1;
+                return task;
+            }
+
+            const bool high_first = w->high_burst < HIGH_BURST;
+
+            if (high_first && (task = TakeHigh(group)))
+            {
+                ++w->high_burst;
+                return task;
+            }
+
+            w->high_burst = 0;
+
+            if ((task = FindNormalTask(w)))
+                return task;
+
+            if (!high_first && (task = TakeHigh(group)))
+            {
+                w->high_burst = 1;
+                return task;
+            }
+
+            return TakeLow(group, false);
+        }
+
+        /**
+         * CN: 普通任务查找顺序：本线程队列 -> 本域运行队列 -> 本域其它线程 -> 其它域运行队列 -> 其它域线程
+         * EN: Normal task search order: own deque -> own domain queue -> domain peers -> other domain queues -> other domain workers
+         */
+        Task *FindNormalTask(Worker *w)
+        {
+            Task *task;
+
+            if (w->local_queue.Pop(task))
+                return task;
+
+            // 被回避的线程每次只取一个，把批量留给同域的健康线程
+            if ((task = TakeFromRunQueue(w, w->run_queue, w->avoid.load(std::memory_order_relaxed) ? 1 : 32)))
+                return task;
+
+            if ((task = StealFromWorkers(w, w->run_queue->workers)))
+                return task;
+
+            const std::vector<RunQueue *> &queues = w->group->run_queues;
+            const uint32 qc = static_cast<uint32>(queues.size());
+
+            for (uint32 i = 1; i < qc; ++i)
+            {
+                RunQueue *rq = queues[(w->run_queue->queue_index + i) % qc];
+
+                if ((task = TakeFromRunQueue(w, rq, 1)))        // 跨域只取一个，避免把整批任务拉离原簇
+                    return task;
+
+                if ((task = StealFromWorkers(w, rq->workers)))
+                    return task;
+            }
+
+            return nullptr;
+        }
+
+        /**
+         * CN: 挂起直到有新任务投递或执行器停止
+         * EN: Park until a task is posted or the executor stops
+         */
+        Task *Park(Worker *w)
+        {
+            WorkerGroup *group = w->group;
+
+            const uint64 epoch = group->wake_epoch.load(std::memory_order_seq_cst);
+            group->sleeping.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            Task *task = FindTask(w, true);      // 再检查一次，避免与Wake之间丢失唤醒
+
+            if (!task)
+            {
+                const double park_time = GetPreciseTime();
+
+                if (w->trace.IsEnabled())
+                    w->trace.Record(park_time, TraceEventType::Park);
+
+                {
+                    std::unique_lock<std::mutex> lock(group->park_lock);
+
+                    group->park_cv.wait(lock, [&]()
+                    {
+                        return group->wake_epoch.load(std::memory_order_seq_cst) != epoch
+                            || !running.load(std::memory_order_relaxed);
+                    });
+                }
+
+                const double unpark_time = GetPreciseTime();
+
+                WorkerCounters::Add(w->counters.parks, 1);
+                WorkerCounters::Add(w->counters.park_ns, static_cast<uint64>((unpark_time - park_time) * 1e9));
+
+                if (w->trace.IsEnabled())
+                    w->trace.Record(unpark_time, TraceEventType::Unpark);
+            }
+
+            group->sleeping.fetch_sub(1, std::memory_order_seq_cst);
+            return task;
+        }
+
+        void WorkerLoop(Worker *w)
+        {
+            constexpr int SPIN_ROUNDS = 32;
+
+            CurrentWorker() = w;
+
+            if (pin_threads && w->cpu_id != CPU_ID_INVALID)
+                w->pinned.store(BindCurrentThreadToCpu(w->cpu_id), std::memory_order_relaxed);
+
+            int idle = 0;
+
+            while (running.load(std::memory_order_relaxed))
+            {
+                Task *task = FindTask(w, false);
+
+                if (!task)
+                {
+                    if (++idle < SPIN_ROUNDS)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    task = Park(w);
+                    idle = 0;
+
+                    if (!task)
+                        continue;
+                }
+
+                idle = 0;
+                RunTask(w, task);
+            }
+
+            CurrentWorker() = nullptr;
+        }
+    };
+
+} // namespace hgl::task
@@ -0,0 +1,193 @@
+#include "TaskExecutor.h"
+#include <hgl/time/Time.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+using namespace hgl;
+using namespace std;
+
+/**
+ * 原BigLittleTaskScheduler中的单锁调度器（统一架构部分），作为对比基准。
+ * 去掉了每个任务的cout输出，只保留加锁、LIFO队列与休眠轮询。
+ */
+class MutexTaskScheduler
+{
+    vector<thread> threads;
+    atomic<bool> running{true};
+
+    vector<function<void()>> compute_tasks;
+    mutex task_mutex;
+
+public:
+
+    ~MutexTaskScheduler()
+    {
+        Stop();
+    }
+
+    void Start(uint32 worker_count)
+    {
+        running = true;
+
+        for (uint32 i = 0; i < worker_count; ++i)
+            threads.emplace_back([this]() { UnifiedWorker(); });
+    }
+
+    void Stop()
+    {
+        running = false;
+
+        for (auto &t : threads)
+            if (t.joinable())
+                t.join();
+
+        threads.clear();
+        compute_tasks.clear();
+    }
+
+    void AddComputeTask(function<void()> task)
+    {
+        lock_guard<mutex> lock(task_mutex);
+        compute_tasks.push_back(move(task));
+    }
+
+private:
+
+    void UnifiedWorker()
+    {
+        while (running) {
+            function<void()> task;
+
+            {
+                lock_guard<mutex> lock(task_mutex);
+                if (!compute_tasks.empty()) {
+                    task = move(compute_tasks.back());
+                    compute_tasks.pop_back();
+                }
+            }
+
+            if (task)
+                task();
+            else
+                this_thread::sleep_for(chrono::milliseconds(20));
+        }
+    }
+};
+
+constexpr const uint32 BURST_TASK_COUNT   = 200000;    // 一次性投递的小任务数量
+constexpr const uint32 TRICKLE_TASK_COUNT = 2000;      // 间隔投递的任务数量
+constexpr const double TRICKLE_INTERVAL   = 0.0005;    // 间隔投递的间隔(秒)
+constexpr const uint32 TASK_WORK          = 200;       // 每个任务的计算量
+
+struct BenchResult
+{
+    double seconds;
+    double p50;
+    double p99;
+};
+
+void SimulateWork()
+{
+    volatile uint32 sum = 0;
+
+    for (uint32 i = 0; i < TASK_WORK; ++i)
+        sum += i * i;
+}
+
+double Percentile(vector<double> &data, double p)
+{
+    const size_t index = min(data.size() - 1, size_t(double(data.size()) * p));
+
+    nth_element(data.begin(), data.begin() + index, data.end());
+    return data[index];
+}
+
+/**
+ * 投递count个任务，记录每个任务从投递到开始执行的延迟
+ * @param interval 两次投递之间的间隔，0表示一次性全部投递
+ */
+template<typename S>
+BenchResult RunBench(S &scheduler, uint32 count, double interval)
+{
+    vector<double> latency(count);
+    atomic<uint32> done{0};
+
+    const double st = GetPreciseTime();
+    double next = st;
+
+    for (uint32 i = 0; i < count; ++i) {
+        if (interval > 0) {
+            while (GetPreciseTime() < next)
+                this_thread::yield();
+
+            next += interval;
+        }
+
+        const double enqueue_time = GetPreciseTime();
+
+        scheduler.AddComputeTask([&latency, &done, i, enqueue_time]() {
+            latency[i] = GetPreciseTime() - enqueue_time;
+            SimulateWork();
+            done.fetch_add(1, memory_order_release);
+        });
+    }
+
+    while (done.load(memory_order_acquire) < count)
+        this_thread::yield();
+
+    BenchResult result;
+
+    result.seconds = GetPreciseTime() - st;
+    result.p50 = Percentile(latency, 0.50);
+    result.p99 = Percentile(latency, 0.99);
+
+    return result;
+}
+
+void PrintResult(const char *name, uint32 count, const BenchResult &r)
+{
+    cout << "  " << setw(16) << left << name << right
+         << setw(12) << fixed << setprecision(0) << double(count) / r.seconds << " tasks/s"
+         << "  p50 " << setw(10) << setprecision(1) << r.p50 * 1000000.0 << " us"
+         << "  p99 " << setw(10) << setprecision(1) << r.p99 * 1000000.0 << " us" << endl;
+}
+
+int main(int, char **)
+{
+    CpuInfo ci;
+
+    if (!GetCpuInfo(&ci)) {
+        cerr << "Failed to get CPU information" << endl;
+        return 1;
+    }
+
+    cout << "=== TaskExecutor vs MutexTaskScheduler ===" << endl;
+    cout << "Logical cores: " << ci.logical_core_count << endl;
+    cout << "Burst: " << BURST_TASK_COUNT << " tasks, Trickle: " << TRICKLE_TASK_COUNT
+         << " tasks every " << TRICKLE_INTERVAL * 1000000.0 << " us" << endl;
+
+    for (uint32 n = 1; n <= ci.logical_core_count; ++n) {
+        cout << "\n--- " << n << " worker(s) ---" << endl;
+
+        {
+            MutexTaskScheduler scheduler;
+            scheduler.Start(n);
+
+            PrintResult("mutex burst", BURST_TASK_COUNT, RunBench(scheduler, BURST_TASK_COUNT, 0));
+            PrintResult("mutex trickle", TRICKLE_TASK_COUNT, RunBench(scheduler, TRICKLE_TASK_COUNT, TRICKLE_INTERVAL));
+        }
+
+        {
+            task::TaskExecutor executor;
+            executor.Start(n, 0);
+
+            PrintResult("steal burst", BURST_TASK_COUNT, RunBench(executor, BURST_TASK_COUNT, 0));
+            PrintResult("steal trickle", TRICKLE_TASK_COUNT, RunBench(executor, TRICKLE_TASK_COUNT, TRICKLE_INTERVAL));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+#pragma once
+
+#include"TaskExecutor.h"
+#include<hgl/time/Time.h>
+#include<atomic>
+#include<condition_variable>
+#include<mutex>
+#include<string>
+#include<vector>
+
+namespace hgl::task
+{
+    using TaskHandle = uint32;
+    constexpr const TaskHandle TASK_HANDLE_INVALID = 0xFFFFFFFF;
+
+    /**
+     * CN: 任务图节点
+     * EN: Task graph node
+     */
+    struct TaskNode
+    {
+        TaskHandle handle = TASK_HANDLE_INVALID;
+        std::string name;
+        TaskFunc func;
+        bool background = false;                    ///< CN: 在后台组(小核)执行 / EN: Run on the background group (little cores)
+
+        std::vector<TaskNode *> successors;         ///< CN: 后继节点 / EN: Successor nodes
+        uint32 predecessor_count = 0;               ///< CN: 前驱数量 / EN: Number of predecessors
+
+        std::atomic<uint32> pending{0};             ///< CN: 本次运行中尚未完成的前驱数量(join计数器) / EN: Unfinished predecessors in current run (join counter)
+        std::atomic<bool> done{false};
+
+        double start_time = 0;                      ///< CN: 本次运行的开始时间 / EN: Start time of current run
+        double end_time = 0;                        ///< CN: 本次运行的结束时间 / EN: End time of current run
+        int32 worker_id = -1;                       ///< CN: 执行该节点的工作线程 / EN: Worker that ran this node
+    };
+
+    /**
+     * CN: 任务图（有向无环图）
+     * EN: Task graph (directed acyclic graph)
+     *
+     * CN: 每个节点带一个join计数器，所有前驱完成后才进入就绪状态。
+     *     节点完成时，同组的第一个就绪后继直接在当前工作线程上继续执行以保持缓存热度，
+     *     其余就绪后继投递到当前线程的本地队列，由其它线程窃取。
+     *     图可以在每帧重复运行，运行期间不可修改。
+     * EN: Every node carries a join counter and becomes ready once all predecessors finish.
+     *     When a node finishes, its first ready successor of the same group continues on the
+     *     same worker to keep caches hot, other ready successors go to the local deque for stealing.
+     *     The graph can be re-run every frame but must not be modified while running.
+     */
+    class TaskGraph
+    {
+        TaskExecutor *executor;
+        std::vector<TaskNode *> nodes;
+
+        std::atomic<uint32> remaining{0};           ///< CN: 本次运行尚未完成的节点数 / EN: Nodes not yet finished in current run
+        std::atomic<uint32> finishing{0};           ///< CN: 正在执行Finish的线程数，为0后才能安全销毁 / EN: Threads inside Finish, the graph may only be destroyed once this is 0
+        bool validated = false;                     ///< CN: 图结构已通过环检测 / EN: Graph structure passed the cycle check
+
+        std::mutex wait_lock;
+        std::condition_variable wait_cv;
+        std::atomic<int32> waiters{0};
+
+        double run_start_time = 0;
+
+    public:
+
+        TaskGraph(TaskExecutor *te) : executor(te) {}
+
+        ~TaskGraph()
+        {
+            Wait();
+
+            for (TaskNode *node : nodes)
+                delete node;
+        }
+
+        TaskGraph(const TaskGraph &) = delete;
+        TaskGraph &operator=(const TaskGraph &) = delete;
+
+        uint32 GetCount() const { return static_cast<uint32>(nodes.size()); }
+
+        const TaskNode *GetNode(TaskHandle handle) const
+        {
+            return handle < nodes.size() ? nodes[handle] : nullptr;
+        }
+
+        double GetRunStartTime() const { return run_start_time; }
+
+        /**
+         * CN: 添加一个节点
+         * EN: Add a node
+         * @param background CN: 是否在后台组(小核)执行 / EN: Whether to run on the background group (little cores)
+         */
+        TaskHandle Add(const std::string &name, TaskFunc func, bool background = false)
+        {
+            TaskNode *node = new TaskNode;
+
+            node->handle = static_cast<TaskHandle>(nodes.size());
+            node->name = name;
+            node->func = std::move(func);
+            node->background = background;
+
+            nodes.push_back(node);
+            validated = false;
+            return node->handle;
+        }
+
+        /**
+         * CN: 指定before完成后才能执行after
+         * EN: Make after wait for before
+         */
+        bool Precede(TaskHandle before, TaskHandle after)
+        {
+            if (before >= nodes.size() || after >= nodes.size() || before == after)
+                return false;
+
+            nodes[before]->successors.push_back(nodes[after]);
+            ++nodes[after]->predecessor_count;
+            validated = false;
+            return true;
+        }
+
+        /**
+         * CN: 添加一个在handle之后执行的延续节点
+         * EN: Add a continuation node that runs after handle
+         */
+        TaskHandle Then(TaskHandle handle, const std::string &name, TaskFunc func, bool background = false)
+        {
+            if (handle >= nodes.size())
+                return TASK_HANDLE_INVALID;
+
+            const TaskHandle next = Add(name, std::move(func), background);
+            Precede(handle, next);
+            return next;
+        }
+
+        /**
+         * CN: 检查图中是否存在环
+         * EN: Check whether the graph contains a cycle
+         */
+        bool HasCycle() const
+        {
+            std::vector<uint32> in_degree(nodes.size());
+            std::vector<const TaskNode *> ready;
+
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                in_degree[i] = nodes[i]->predecessor_count;
+
+                if (in_degree[i] == 0)
+                    ready.push_back(nodes[i]);
+            }
+
+            size_t visited = 0;
+
+            while (!ready.empty())
+            {
+                const TaskNode *node = ready.back();
+                ready.pop_back();
+                ++visited;
+
+                for (const TaskNode *succ : node->successors)
+                    if (--in_degree[succ->handle] == 0)
+                        ready.push_back(succ);
+            }
+
+            return visited != nodes.size();
+        }
+
+        /**
+         * CN: 开始运行整个图，立即返回
+         * EN: Start running the whole graph, returns immediately
+         * @return CN: 图为空、存在环或上一次运行尚未结束时返回false / EN: Returns false if empty, cyclic, or the previous run has not finished
+         */
+        bool Run()
+        {
+            if (nodes.empty() || !executor || !executor->IsRunning())
+                return false;
+
+            if (!IsFinished())
+                return false;
+
+            if (!validated)
+            {
+                if (HasCycle())
+                    return false;
+
+                validated = true;
+            }
+
+            for (TaskNode *node : nodes)
+            {
+                node->pending.store(node->predecessor_count, std::memory_order_relaxed);
+                node->done.store(false, std::memory_order_relaxed);
+                node->worker_id = -1;
+            }
+
+            run_start_time = GetPreciseTime();
+            remaining.store(static_cast<uint32>(nodes.size()), std::memory_order_release);
+
+            for (TaskNode *node : nodes)
+                if (node->predecessor_count == 0)
+                    Schedule(node);
+
+            return true;
+        }
+
+        /**
+         * CN: 检查整个图是否已运行完成（或从未运行）
+         * EN: Check whether the whole graph has finished (or never ran)
+         */
+        bool IsFinished() const
+        {
+            return remaining.load(std::memory_order_acquire) == 0
+                && finishing.load(std::memory_order_acquire) == 0;
+        }
+
+        /**
+         * CN: 检查节点是否已完成
+         * EN: Check whether a node has finished
+         */
+        bool IsDone(TaskHandle handle) const
+        {
+            return handle < nodes.size() && nodes[handle]->done.load(std::memory_order_acquire);
+        }
+
+        /**
+         * CN: 等待指定节点完成。在工作线程中调用时会帮助执行其它任务而不是阻塞
+         * EN: Wait for a node. When called on a worker it helps running other tasks instead of blocking
+         */
+        void WaitFor(TaskHandle handle)
+        {
+            if (handle >= nodes.size())
+                return;
+
+            const TaskNode *node = nodes[handle];
+
+            WaitUntil([node]() { return node->done.load(std::memory_order_acquire); });
+        }
+
+        /**
+         * CN: 等待整个图完成
+         * EN: Wait for the whole graph
+         */
+        void Wait()
+        {
+            WaitUntil([this]() { return remaining.load(std::memory_order_acquire) == 0; });
+
+            // 最后一个节点的Finish可能还在通知等待者，等它离开后图才可以被销毁
+            while (finishing.load(std::memory_order_acquire) != 0)
+                std::this_thread::yield();
+        }
+
+    private:
+
+        template<typename F>
+        void WaitUntil(F finished)
+        {
+            if (finished())
+                return;
+
+            if (TaskExecutor::GetCurrentWorkerID() >= 0)
+            {
+                while (!finished())
+                {
+                    if (!executor->RunPendingTask())
+                        std::this_thread::yield();
+                }
+
+                return;
+            }
+
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+
+            {
+                std::unique_lock<std::mutex> lock(wait_lock);
+                wait_cv.wait(lock, finished);
+            }
+
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void Schedule(TaskNode *node)
+        {
+            if (node->background)
+                executor->AddBackgroundTask([this, node]() { Execute(node); });
+            else
+                executor->AddComputeTask([this, node]() { Execute(node); });
+        }
+
+        void Execute(TaskNode *node)
+        {
+            while (node)
+            {
+                node->worker_id = TaskExecutor::GetCurrentWorkerID();
+                node->start_time = GetPreciseTime();
+
+                if (node->func)
+                    node->func();
+
+                node->end_time = GetPreciseTime();
+
+                TaskNode *next = nullptr;
+
+                for (TaskNode *succ : node->successors)
+                {
+                    if (succ->pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                        continue;
+
+                    if (!next && succ->background == node->background)
+                        next = succ;                    // 同组第一个就绪后继在本线程继续执行
+                    else
+                        Schedule(succ);
+                }
+
+                Finish(node);
+                node = next;
+            }
+        }
+
+        void Finish(TaskNode *node)
+        {
+            finishing.fetch_add(1, std::memory_order_seq_cst);
+
+            node->done.store(true, std::memory_order_release);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (waiters.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock(wait_lock);
+                wait_cv.notify_all();
+            }
+
+            finishing.fetch_sub(1, std::memory_order_release);     // 此后不能再访问this
+        }
+    };
+
+} // namespace hgl::task
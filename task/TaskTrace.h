@@ -0,0 +1,308 @@
+#pragma once
+
+#include<hgl/platform/CpuInfo.h>
+#include<atomic>
+#include<cstdio>
+#include<string>
+#include<vector>
+
+namespace hgl::task
+{
+    /**
+     * CN: 调度事件类型
+     * EN: Scheduler event type
+     */
+    enum class TraceEventType : uint8
+    {
+        Enqueue,            ///< CN: 任务入队，arg为入队后的队列长度 / EN: Task queued, arg is queue depth after push
+        Start,              ///< CN: 任务开始，arg为任务类型 / EN: Task started, arg is task type
+        End,                ///< CN: 任务结束 / EN: Task finished
+        Steal,              ///< CN: 窃取成功，arg为被窃取的工作线程 / EN: Successful steal, arg is the victim worker
+        Park,               ///< CN: 线程挂起 / EN: Worker parked
+        Unpark,             ///< CN: 线程被唤醒 / EN: Worker woke up
+        DeadlineMiss        ///< CN: 任务超过截止时间才完成，arg为超时微秒数 / EN: Task finished after its deadline, arg is lateness in microseconds
+    };
+
+    struct TraceEvent
+    {
+        double time;                                    ///< CN: GetPreciseTime时间戳(秒) / EN: GetPreciseTime timestamp (seconds)
+        uint64 task_id;
+        uint32 arg;
+        TraceEventType type;
+    };
+
+    /**
+     * CN: 单写者无锁事件环，写满后覆盖最旧的事件
+     * EN: Single-writer lock-free event ring, overwrites the oldest events when full
+     *
+     * CN: 只有拥有者线程写入；读取方复制后再次检查写位置，丢弃复制期间可能被覆盖的事件，
+     *     写位置所在的槽可能正在被写入，也视为已覆盖，所以可以在运行中随时导出，最多保留容量-1个事件。
+     * EN: Only the owner thread writes; the reader re-checks the write position after copying and drops events
+     *     that may have been overwritten meanwhile. The slot at the write position may be mid-write and counts as
+     *     overwritten too, so it can be exported while running and keeps at most capacity - 1 events.
+     */
+    class TraceRing
+    {
+        std::vector<TraceEvent> events;
+        uint64 mask = 0;
+        std::atomic<uint64> head{0};                    ///< CN: 已写入的事件总数 / EN: Total events written
+
+    public:
+
+        /**
+         * @param capacity CN: 容量，向上取整到2的幂，0为不记录 / EN: Capacity, rounded up to a power of two, 0 disables recording
+         */
+        void Init(uint32 capacity)
+        {
+            uint64 size = 0;
+
+            if (capacity > 0)
+                for (size = 1; size < capacity; size <<= 1);
+
+            events.assign(size, TraceEvent{});
+            mask = size ? size - 1 : 0;
+            head.store(0, std::memory_order_relaxed);
+        }
+
+        bool IsEnabled() const { return !events.empty(); }
+
+        uint64 GetTotalCount() const { return head.load(std::memory_order_relaxed); }
+
+        void Record(double time, TraceEventType type, uint64 task_id = 0, uint32 arg = 0)
+        {
+            if (events.empty())
+                return;
+
+            const uint64 h = head.load(std::memory_order_relaxed);
+
+            events[h & mask] = TraceEvent{time, task_id, arg, type};
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        /**
+         * CN: 复制当前保留的事件（从旧到新）
+         * EN: Copy the retained events (oldest first)
+         */
+        void Snapshot(std::vector<TraceEvent> &out) const
+        {
+            out.clear();
+
+            if (events.empty())
+                return;
+
+            const uint64 size = mask + 1;
+            const uint64 end = head.load(std::memory_order_acquire);
+            const uint64 begin = end >= size ? end - size + 1 : 0;     // 槽end&mask即begin-1的槽，可能正被写入
+
+            out.reserve(static_cast<size_t>(end - begin));
+
+            for (uint64 i = begin; i < end; ++i)
+                out.push_back(events[i & mask]);
+
+            // 复制期间写者可能已经绕回并覆盖了最前面的事件，槽new_end&mask可能正被写入
+            const uint64 new_end = head.load(std::memory_order_acquire);
+
+            if (new_end + 1 > begin + size)
+            {
+                const uint64 overwritten = new_end + 1 - size - begin;
+                out.erase(out.begin(), out.begin() + static_cast<size_t>(overwritten < out.size() ? overwritten : out.size()));
+            }
+        }
+    };
+
+    /**
+     * CN: 工作线程统计计数，只由拥有者线程写入，其它线程可随时读取
+     * EN: Worker counters, written by the owner thread only and readable from any thread
+     */
+    struct WorkerCounters
+    {
+        std::atomic<uint64> executed{0};                ///< CN: 执行的任务数 / EN: Tasks executed
+        std::atomic<uint64> stolen{0};                  ///< CN: 其中通过窃取得到的任务数 / EN: Of which obtained by stealing
+        std::atomic<uint64> parks{0};                   ///< CN: 挂起次数 / EN: Times parked
+        std::atomic<uint64> park_ns{0};                 ///< CN: 挂起总时长(纳秒) / EN: Total parked time (nanoseconds)
+
+        std::atomic<uint64> depth_sum{0};               ///< CN: 每次取任务时可见队列长度之和 / EN: Sum of visible queue depth at every task pick
+        std::atomic<uint32> depth_max{0};
+
+        std::atomic<uint64> deadline_tasks{0};          ///< CN: 执行的带截止时间任务数 / EN: Deadline tasks executed
+        std::atomic<uint64> deadline_misses{0};         ///< CN: 其中超时完成的任务数 / EN: Of which finished late
+        std::atomic<uint64> max_lateness_ns{0};
+
+        static void Add(std::atomic<uint64> &c, uint64 v)
+        {
+            c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+
+        void SampleDepth(uint32 depth)
+        {
+            Add(depth_sum, depth);
+
+            if (depth > depth_max.load(std::memory_order_relaxed))
+                depth_max.store(depth, std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            executed = 0;
+            stolen = 0;
+            parks = 0;
+            park_ns = 0;
+            depth_sum = 0;
+            depth_max = 0;
+            deadline_tasks = 0;
+            deadline_misses = 0;
+            max_lateness_ns = 0;
+        }
+    };
+
+    /**
+     * CN: 工作线程统计汇总
+     * EN: Worker statistics summary
+     */
+    struct WorkerStats
+    {
+        uint32 id = 0;
+        bool background = false;
+        uint32 cpu_id = 0;
+        bool pinned = false;                            ///< CN: 线程已成功绑定到cpu_id / EN: The thread was successfully pinned to cpu_id
+
+        uint64 executed = 0;
+        uint64 stolen = 0;
+        uint64 parks = 0;
+
+        double steal_rate = 0;                          ///< CN: 窃取任务占执行任务的比例 / EN: Stolen tasks / executed tasks
+        double idle_percent = 0;                        ///< CN: 挂起时间占统计时长的百分比 / EN: Parked time as percentage of the sampling period
+        double avg_queue_depth = 0;
+        uint32 max_queue_depth = 0;
+
+        bool avoided = false;                           ///< CN: 所在核心被降频或被其它进程占用 / EN: Core is throttled or busy with other processes
+        double freq_ratio = 1.0;                        ///< CN: 最近一次采样的当前频率/最大频率 / EN: Current / max frequency at the last sample
+        double foreign_load = 0;                        ///< CN: 其它进程在该核心上的负载 / EN: Load from other processes on this core
+
+        uint64 deadline_tasks = 0;
+        uint64 deadline_misses = 0;
+        double max_lateness_ms = 0;                     ///< CN: 最大超时(毫秒) / EN: Worst lateness (milliseconds)
+    };
+
+    /**
+     * CN: 参与导出的一条时间线
+     * EN: One timeline to export
+     */
+    struct TraceTimeline
+    {
+        uint32 tid;
+        std::string name;
+        std::vector<TraceEvent> events;
+    };
+
+    /**
+     * CN: 导出为Chrome trace-event JSON（chrome://tracing 或 Perfetto 可直接打开）
+     * EN: Export as Chrome trace-event JSON (opens in chrome://tracing or Perfetto)
+     *
+     * CN: 任务执行区间导出为B/E事件，挂起区间为名为park的B/E事件，窃取为即时事件，
+     *     入队到开始执行之间用flow事件连接。
+     *     等待中的线程会帮忙执行其它任务，任务区间可以嵌套，按深度计数为每个B输出一个E。
+     * EN: Task runs become B/E events, parked intervals B/E events named park, steals instant events,
+     *     and flow events connect an enqueue with the start of the same task.
+     *     A waiting worker helps run other tasks, so task intervals nest; a depth counter emits one E per B.
+     *
+     * @param start_time CN: 时间零点(GetPreciseTime) / EN: Time origin (GetPreciseTime)
+     */
+    inline bool WriteChromeTrace(const std::string &filename, const std::vector<TraceTimeline> &timelines, double start_time)
+    {
+        FILE *fp = fopen(filename.c_str(), "wb");
+
+        if (!fp)
+            return false;
+
+        fputs("{\"traceEvents\":[\n", fp);
+
+        bool first = true;
+
+        auto begin_event = [&]()
+        {
+            if (!first)
+                fputs(",\n", fp);
+
+            first = false;
+        };
+
+        for (const TraceTimeline &tl : timelines)
+        {
+            begin_event();
+            fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    tl.tid, tl.name.c_str());
+
+            uint32 task_depth = 0;                      // 未结束的任务区间数
+            bool in_park = false;
+
+            for (const TraceEvent &e : tl.events)
+            {
+                const double ts = (e.time - start_time) * 1e6;
+
+                switch (e.type)
+                {
+                    case TraceEventType::Enqueue:
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"enqueue\",\"cat\":\"task\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"task\":%llu,\"depth\":%u}}",
+                                tl.tid, ts, (unsigned long long)e.task_id, e.arg);
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"task\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%llu,\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                (unsigned long long)e.task_id, tl.tid, ts);
+                        break;
+
+                    case TraceEventType::Start:
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"task\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                (unsigned long long)e.task_id, tl.tid, ts);
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"task\",\"cat\":\"task\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"task\":%llu,\"type\":%d}}",
+                                tl.tid, ts, (unsigned long long)e.task_id, e.arg == 0xFFFFFFFF ? -1 : int(e.arg));
+                        ++task_depth;
+                        break;
+
+                    case TraceEventType::End:
+                        if (task_depth == 0)        // 开始事件已被环覆盖
+                            break;
+
+                        begin_event();
+                        fprintf(fp, "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tl.tid, ts);
+                        --task_depth;
+                        break;
+
+                    case TraceEventType::Steal:
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"steal\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"victim\":%u}}",
+                                tl.tid, ts, e.arg);
+                        break;
+
+                    case TraceEventType::DeadlineMiss:
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"deadline miss\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"task\":%llu,\"late_us\":%u}}",
+                                tl.tid, ts, (unsigned long long)e.task_id, e.arg);
+                        break;
+
+                    case TraceEventType::Park:
+                        begin_event();
+                        fprintf(fp, "{\"name\":\"park\",\"cat\":\"sched\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tl.tid, ts);
+                        in_park = true;
+                        break;
+
+                    case TraceEventType::Unpark:
+                        if (!in_park)
+                            break;
+
+                        begin_event();
+                        fprintf(fp, "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tl.tid, ts);
+                        in_park = false;
+                        break;
+                }
+            }
+        }
+
+        fputs("\n]}\n", fp);
+        fclose(fp);
+        return true;
+    }
+
+} // namespace hgl::task
@@ -0,0 +1,61 @@
+#pragma once
+
+#include<hgl/platform/CpuInfo.h>
+
+#if defined(__linux__) || defined(__ANDROID__)
+    #include<sched.h>
+#elif defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif//WIN32_LEAN_AND_MEAN
+    #include<windows.h>
+#endif
+
+namespace hgl::task
+{
+    constexpr const uint32 CPU_ID_INVALID = 0xFFFFFFFF;
+
+    /**
+     * CN: 将当前线程绑定到指定逻辑CPU
+     * EN: Pin the calling thread to one logical CPU
+     * @return CN: 平台不支持或失败返回false / EN: Returns false if unsupported or failed
+     */
+    inline bool BindCurrentThreadToCpu(const uint32 cpu_id)
+    {
+    #if defined(__linux__) || defined(__ANDROID__)
+        if (cpu_id >= CPU_SETSIZE)
+            return false;
+
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu_id, &set);
+
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    #elif defined(_WIN32)
+        if (cpu_id >= sizeof(DWORD_PTR) * 8)
+            return false;
+
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu_id) != 0;
+    #else
+        return false;
+    #endif
+    }
+
+    /**
+     * CN: 获取当前线程正在运行的逻辑CPU
+     * EN: Get the logical CPU the calling thread is running on
+     */
+    inline uint32 GetCurrentCpu()
+    {
+    #if defined(__linux__) || defined(__ANDROID__)
+        const int cpu = sched_getcpu();
+        return cpu < 0 ? CPU_ID_INVALID : static_cast<uint32>(cpu);
+    #elif defined(_WIN32)
+        return static_cast<uint32>(GetCurrentProcessorNumber());
+    #else
+        return CPU_ID_INVALID;
+    #endif
+    }
+
+} // namespace hgl::task
@@ -0,0 +1,164 @@
+#pragma once
+
+#include<atomic>
+#include<vector>
+#include<cstdint>
+
+namespace hgl::task
+{
+    /**
+     * CN: Chase-Lev 工作窃取双端队列
+     * EN: Chase-Lev work-stealing deque
+     *
+     * CN: 只有拥有者线程可以调用Push/Pop（在底部操作，LIFO），
+     *     其它线程只能调用Steal（从顶部取，FIFO）。
+     *     内存序参照 Lê, Pop, Cohen, Zappa Nardelli 《Correct and Efficient Work-Stealing for Weak Memory Models》。
+     * EN: Only the owner thread may call Push/Pop (bottom end, LIFO),
+     *     other threads may only call Steal (top end, FIFO).
+     *     Memory orderings follow Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models".
+     *
+     * @tparam T CN: 元素类型，必须可平凡复制（通常为指针） / EN: Element type, must be trivially copyable (usually a pointer)
+     */
+    template<typename T>
+    class WorkStealingDeque
+    {
+        struct RingBuffer
+        {
+            int64_t capacity;
+            int64_t mask;
+            std::atomic<T> *data;
+
+            explicit RingBuffer(int64_t cap) : capacity(cap), mask(cap - 1), data(new std::atomic<T>[cap]) {}
+            ~RingBuffer() { delete[] data; }
+
+            void Put(int64_t index, T value) { data[index & mask].store(value, std::memory_order_relaxed); }
+            T Get(int64_t index) const { return data[index & mask].load(std::memory_order_relaxed); }
+
+            RingBuffer *Grow(int64_t bottom, int64_t top) const
+            {
+                RingBuffer *rb = new RingBuffer(capacity * 2);
+
+                for (int64_t i = top; i != bottom; ++i)
+                    rb->Put(i, Get(i));
+
+                return rb;
+            }
+        };
+
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        alignas(64) std::atomic<RingBuffer *> buffer;
+
+        std::vector<RingBuffer *> retired;  ///< CN: 扩容后废弃的旧缓冲区，窃取者可能仍在读取，析构时统一释放 / EN: Buffers replaced by Grow, thieves may still read them, freed on destruction
+
+    public:
+
+        explicit WorkStealingDeque(int64_t capacity = 1024) : top(0), bottom(0)
+        {
+            int64_t cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+
+            buffer.store(new RingBuffer(cap), std::memory_order_relaxed);
+        }
+
+        ~WorkStealingDeque()
+        {
+            for (RingBuffer *rb : retired)
+                delete rb;
+
+            delete buffer.load(std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        /**
+         * CN: 估算当前元素数量（并发时不精确）
+         * EN: Estimated element count (inexact under concurrency)
+         */
+        int64_t GetCount() const
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_relaxed);
+            return b > t ? b - t : 0;
+        }
+
+        bool IsEmpty() const { return GetCount() <= 0; }
+
+        /**
+         * CN: 压入一个元素（仅拥有者线程）
+         * EN: Push an element (owner thread only)
+         */
+        void Push(T value)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_acquire);
+            RingBuffer *rb = buffer.load(std::memory_order_relaxed);
+
+            if (b - t > rb->capacity - 1)
+            {
+                retired.push_back(rb);
+                rb = rb->Grow(b, t);
+                buffer.store(rb, std::memory_order_release);
+            }
+
+            rb->Put(b, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /**
+         * CN: 从底部弹出一个元素（仅拥有者线程）
+         * EN: Pop an element from the bottom (owner thread only)
+         * @return CN: 成功返回true / EN: Returns true on success
+         */
+        bool Pop(T &result)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            RingBuffer *rb = buffer.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            result = rb->Get(b);
+
+            if (t == b)
+            {
+                // 只剩最后一个元素，与窃取者竞争
+                const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        /**
+         * CN: 从顶部窃取一个元素（任意线程）
+         * EN: Steal an element from the top (any thread)
+         * @return CN: 成功返回true，队列为空或竞争失败返回false / EN: Returns true on success, false if empty or lost the race
+         */
+        bool Steal(T &result)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return false;
+
+            RingBuffer *rb = buffer.load(std::memory_order_consume);
+            result = rb->Get(t);
+
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+    };
+
+} // namespace hgl::task